@@ -0,0 +1,185 @@
+// CsvParseBench.cpp
+//
+// CSV layer parse throughput: the old stringstream/getline/stoi parser
+// against ParseCsvGids, over every CSV <data> block of a map, plus the
+// whole LoadTmxMap call for context.
+//
+// Usage: mon_bench_csv [map.tmx] [iterations]
+
+#include "TileLayerData.h"
+#include "TmxLoader.h"
+
+#include "tinyxml2.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace
+{
+    using Clock = std::chrono::steady_clock;
+
+    // The loader's previous parser (stoll instead of stoi so flipped gids do not throw).
+    std::vector<uint32_t> ParseCsvReference(const char* csvText)
+    {
+        std::vector<uint32_t> tiles;
+        if (!csvText)
+            return tiles;
+
+        std::stringstream ss(csvText);
+        std::string cell;
+
+        while (std::getline(ss, cell, ','))
+        {
+            const auto begin = cell.find_first_not_of(" \t\r\n");
+            if (begin == std::string::npos)
+                continue;
+
+            const auto end = cell.find_last_not_of(" \t\r\n");
+            const std::string trimmed = cell.substr(begin, end - begin + 1);
+
+            tiles.push_back(static_cast<uint32_t>(std::stoll(trimmed)) & kTmxGidMask);
+        }
+
+        return tiles;
+    }
+
+    void CollectCsvLayers(tinyxml2::XMLElement* parent, std::vector<std::string>& outTexts)
+    {
+        for (tinyxml2::XMLElement* child = parent->FirstChildElement(); child; child = child->NextSiblingElement())
+        {
+            const std::string name = child->Name();
+            if (name == "group")
+            {
+                CollectCsvLayers(child, outTexts);
+                continue;
+            }
+
+            if (name != "layer")
+                continue;
+
+            tinyxml2::XMLElement* data = child->FirstChildElement("data");
+            const char* encoding = data ? data->Attribute("encoding") : nullptr;
+            if (encoding && std::string(encoding) == "csv" && data->GetText())
+                outTexts.emplace_back(data->GetText());
+        }
+    }
+
+    double ToMs(Clock::duration d)
+    {
+        return std::chrono::duration<double, std::milli>(d).count();
+    }
+
+    double ToMBps(size_t bytes, double ms)
+    {
+        return ms > 0.0 ? (static_cast<double>(bytes) / (1024.0 * 1024.0)) / (ms / 1000.0) : 0.0;
+    }
+}
+
+int main(int argc, char** argv)
+{
+    const std::string mapPath = argc > 1 ? argv[1] : "assets/maps/testmap.tmx";
+    const int iterations = argc > 2 ? std::max(1, std::atoi(argv[2])) : 20;
+
+    tinyxml2::XMLDocument doc;
+    if (doc.LoadFile(mapPath.c_str()) != tinyxml2::XML_SUCCESS || !doc.FirstChildElement("map"))
+    {
+        std::cerr << "Failed to load " << mapPath << "\n";
+        return 1;
+    }
+
+    std::vector<std::string> layers;
+    CollectCsvLayers(doc.FirstChildElement("map"), layers);
+    if (layers.empty())
+    {
+        std::cerr << mapPath << " has no CSV layers\n";
+        return 1;
+    }
+
+    size_t csvBytes = 0;
+    size_t maxCells = 0;
+    for (const std::string& text : layers)
+    {
+        csvBytes += text.size();
+        maxCells = std::max(maxCells, text.size() / 2 + 1); // at least one separator per cell
+    }
+
+    // --- Correctness: both parsers must agree on every layer
+    std::vector<uint32_t> gids(maxCells);
+    uint64_t checksum = 0;
+    for (const std::string& text : layers)
+    {
+        const std::vector<uint32_t> reference = ParseCsvReference(text.c_str());
+
+        size_t count = 0;
+        if (!ParseCsvGids(text.data(), text.size(), gids.data(), gids.size(), count)
+            || count != reference.size()
+            || std::memcmp(gids.data(), reference.data(), count * sizeof(uint32_t)) != 0)
+        {
+            std::cerr << "ParseCsvGids disagrees with the reference parser\n";
+            return 1;
+        }
+
+        for (size_t i = 0; i < count; ++i)
+            checksum += gids[i];
+    }
+
+    std::cout << mapPath << ": " << layers.size() << " CSV layers, "
+        << csvBytes / 1024 << " KiB, checksum " << checksum << "\n";
+
+    // --- Reference parser
+    uint64_t sink = 0;
+    Clock::time_point start = Clock::now();
+    for (int it = 0; it < iterations; ++it)
+    {
+        for (const std::string& text : layers)
+            sink += ParseCsvReference(text.c_str()).size();
+    }
+    const double referenceMs = ToMs(Clock::now() - start) / iterations;
+
+    // --- Single-pass parser
+    start = Clock::now();
+    for (int it = 0; it < iterations; ++it)
+    {
+        for (const std::string& text : layers)
+        {
+            size_t count = 0;
+            ParseCsvGids(text.data(), text.size(), gids.data(), gids.size(), count);
+            sink += count + gids[0];
+        }
+    }
+    const double fastMs = ToMs(Clock::now() - start) / iterations;
+
+    // --- Whole loader (XML parse + tilesets + layers + objects)
+    std::error_code ec;
+    const uintmax_t fileBytes = std::filesystem::file_size(mapPath, ec);
+    double loaderMs = -1.0;
+    {
+        LoadedMap loadedMap;
+        start = Clock::now();
+        bool ok = true;
+        for (int it = 0; it < iterations && ok; ++it)
+        {
+            loadedMap = LoadedMap{};
+            ok = LoadTmxMap(mapPath, loadedMap);
+        }
+        if (ok)
+            loaderMs = ToMs(Clock::now() - start) / iterations;
+    }
+
+    std::cout << "stringstream parser : " << referenceMs << " ms  (" << ToMBps(csvBytes, referenceMs) << " MB/s)\n";
+    std::cout << "ParseCsvGids        : " << fastMs << " ms  (" << ToMBps(csvBytes, fastMs) << " MB/s)  x"
+        << (fastMs > 0.0 ? referenceMs / fastMs : 0.0) << "\n";
+    if (loaderMs >= 0.0)
+        std::cout << "LoadTmxMap          : " << loaderMs << " ms  (" << ToMBps(static_cast<size_t>(fileBytes), loaderMs) << " MB/s of .tmx)\n";
+    else
+        std::cout << "LoadTmxMap          : failed (see log above)\n";
+
+    return sink == 0 ? 2 : 0;
+}
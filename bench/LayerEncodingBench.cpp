@@ -0,0 +1,329 @@
+// LayerEncodingBench.cpp
+//
+// TMX load time per layer encoding on a synthetic map: the same four layers
+// (ground / walls / overhead / collision) written as csv, base64,
+// base64+zlib, base64+gzip and base64+zstd, then loaded through LoadTmxMap.
+// Also reports the decode-only time (all layers, one thread) so the
+// parallel layer decode inside the loader can be compared against it.
+//
+// Usage: mon_bench_layer_encoding [size] [iterations]   (default 512 x 512)
+// The generated maps are written to the temp directory and removed again.
+
+#include "TileLayerData.h"
+#include "TmxLoader.h"
+
+#define STB_IMAGE_WRITE_IMPLEMENTATION
+#include "stb_image_write.h"
+#include "zstd.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace
+{
+    using Clock = std::chrono::steady_clock;
+
+    struct Encoding
+    {
+        const char* label;
+        const char* encoding;
+        const char* compression; // nullptr: attribute omitted
+    };
+
+    const Encoding kEncodings[] = {
+        { "csv", "csv", nullptr },
+        { "base64", "base64", nullptr },
+        { "base64+zlib", "base64", "zlib" },
+        { "base64+gzip", "base64", "gzip" },
+        { "base64+zstd", "base64", "zstd" },
+    };
+
+    struct SyntheticLayer
+    {
+        const char* name;
+        std::vector<uint32_t> gids;
+    };
+
+    // Deterministic, map-like content: patchy ground, sparse walls / props.
+    std::vector<SyntheticLayer> MakeLayers(int size)
+    {
+        uint32_t seed = 12345u;
+        auto Next = [&seed]() { seed = seed * 1664525u + 1013904223u; return seed >> 8; };
+
+        const size_t count = static_cast<size_t>(size) * static_cast<size_t>(size);
+        std::vector<SyntheticLayer> layers = {
+            { "Ground", std::vector<uint32_t>(count) },
+            { "Walls", std::vector<uint32_t>(count) },
+            { "Overhead", std::vector<uint32_t>(count) },
+            { "Collision", std::vector<uint32_t>(count) },
+        };
+
+        for (int y = 0; y < size; ++y)
+        {
+            for (int x = 0; x < size; ++x)
+            {
+                const size_t i = static_cast<size_t>(y) * size + x;
+                const uint32_t biome = static_cast<uint32_t>(((x / 32) + (y / 32) * 3) % 4);
+                layers[0].gids[i] = 1 + biome * 16 + (Next() % 4);
+
+                if (Next() % 10 == 0)
+                {
+                    layers[1].gids[i] = 65 + (Next() % 32);
+                    layers[3].gids[i] = 1;
+                }
+
+                if (Next() % 25 == 0)
+                    layers[2].gids[i] = (97 + (Next() % 16)) | (Next() % 2 ? kTmxFlippedHorizontallyFlag : 0u);
+            }
+        }
+
+        return layers;
+    }
+
+    std::string EncodeBase64(const uint8_t* data, size_t size)
+    {
+        static const char* alphabet = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+        std::string out;
+        out.reserve((size + 2) / 3 * 4);
+        for (size_t i = 0; i < size; i += 3)
+        {
+            const uint32_t b0 = data[i];
+            const uint32_t b1 = i + 1 < size ? data[i + 1] : 0;
+            const uint32_t b2 = i + 2 < size ? data[i + 2] : 0;
+            const uint32_t triple = (b0 << 16) | (b1 << 8) | b2;
+
+            out += alphabet[(triple >> 18) & 63];
+            out += alphabet[(triple >> 12) & 63];
+            out += i + 1 < size ? alphabet[(triple >> 6) & 63] : '=';
+            out += i + 2 < size ? alphabet[triple & 63] : '=';
+        }
+        return out;
+    }
+
+    uint32_t Crc32(const uint8_t* data, size_t size)
+    {
+        uint32_t crc = 0xFFFFFFFFu;
+        for (size_t i = 0; i < size; ++i)
+        {
+            crc ^= data[i];
+            for (int bit = 0; bit < 8; ++bit)
+                crc = (crc >> 1) ^ (0xEDB88320u & (0u - (crc & 1u)));
+        }
+        return ~crc;
+    }
+
+    void AppendLe32(std::vector<uint8_t>& out, uint32_t value)
+    {
+        for (int i = 0; i < 4; ++i)
+            out.push_back(static_cast<uint8_t>(value >> (i * 8)));
+    }
+
+    bool EncodeLayer(const Encoding& encoding, const std::vector<uint32_t>& gids, int size, std::string& outText)
+    {
+        if (std::strcmp(encoding.encoding, "csv") == 0)
+        {
+            std::ostringstream csv;
+            csv << "\n";
+            for (size_t i = 0; i < gids.size(); ++i)
+            {
+                csv << gids[i];
+                if (i + 1 < gids.size())
+                    csv << ",";
+                if ((i + 1) % static_cast<size_t>(size) == 0)
+                    csv << "\n";
+            }
+            outText = csv.str();
+            return true;
+        }
+
+        std::vector<uint8_t> raw;
+        raw.reserve(gids.size() * 4);
+        for (uint32_t gid : gids)
+            AppendLe32(raw, gid);
+
+        std::vector<uint8_t> payload;
+        const std::string compression = encoding.compression ? encoding.compression : "";
+        if (compression.empty())
+        {
+            payload = std::move(raw);
+        }
+        else if (compression == "zlib" || compression == "gzip")
+        {
+            int zlibSize = 0;
+            unsigned char* zlib = stbi_zlib_compress(raw.data(), static_cast<int>(raw.size()), &zlibSize, 8);
+            if (!zlib || zlibSize < 6)
+                return false;
+
+            if (compression == "zlib")
+            {
+                payload.assign(zlib, zlib + zlibSize);
+            }
+            else
+            {
+                // Same deflate stream without the zlib header / adler32, wrapped as gzip.
+                payload = { 0x1F, 0x8B, 8, 0, 0, 0, 0, 0, 0, 0xFF };
+                payload.insert(payload.end(), zlib + 2, zlib + zlibSize - 4);
+                AppendLe32(payload, Crc32(raw.data(), raw.size()));
+                AppendLe32(payload, static_cast<uint32_t>(raw.size()));
+            }
+            STBIW_FREE(zlib);
+        }
+        else if (compression == "zstd")
+        {
+            payload.resize(ZSTD_compressBound(raw.size()));
+            const size_t written = ZSTD_compress(payload.data(), payload.size(), raw.data(), raw.size(), 3);
+            if (ZSTD_isError(written))
+                return false;
+            payload.resize(written);
+        }
+        else
+        {
+            return false;
+        }
+
+        outText = "\n   " + EncodeBase64(payload.data(), payload.size()) + "\n";
+        return true;
+    }
+
+    bool WriteMap(const std::filesystem::path& path, const Encoding& encoding,
+        const std::vector<SyntheticLayer>& layers, int size, std::vector<std::string>& outLayerTexts)
+    {
+        std::ofstream out(path, std::ios::binary);
+        if (!out)
+            return false;
+
+        out << "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+            << "<map version=\"1.10\" orientation=\"isometric\" width=\"" << size << "\" height=\"" << size
+            << "\" tilewidth=\"64\" tileheight=\"32\">\n"
+            << " <tileset firstgid=\"1\" name=\"synthetic\" tilewidth=\"64\" tileheight=\"32\" tilecount=\"128\" columns=\"16\">\n"
+            << "  <image source=\"synthetic.png\" width=\"1024\" height=\"256\"/>\n"
+            << " </tileset>\n";
+
+        outLayerTexts.clear();
+        int layerId = 1;
+        for (const SyntheticLayer& layer : layers)
+        {
+            std::string text;
+            if (!EncodeLayer(encoding, layer.gids, size, text))
+                return false;
+
+            out << " <layer id=\"" << layerId++ << "\" name=\"" << layer.name << "\" width=\"" << size
+                << "\" height=\"" << size << "\">\n"
+                << "  <data encoding=\"" << encoding.encoding << "\"";
+            if (encoding.compression)
+                out << " compression=\"" << encoding.compression << "\"";
+            out << ">" << text << "</data>\n </layer>\n";
+
+            outLayerTexts.push_back(std::move(text));
+        }
+
+        out << "</map>\n";
+        return static_cast<bool>(out);
+    }
+
+    double ElapsedMs(Clock::time_point start)
+    {
+        return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    }
+}
+
+int main(int argc, char** argv)
+{
+    const int size = argc > 1 ? std::max(8, std::atoi(argv[1])) : 512;
+    const int iterations = argc > 2 ? std::max(1, std::atoi(argv[2])) : 10;
+
+    const std::vector<SyntheticLayer> layers = MakeLayers(size);
+    const size_t cellCount = static_cast<size_t>(size) * static_cast<size_t>(size);
+    const std::filesystem::path tempDir = std::filesystem::temp_directory_path();
+
+    std::cout << "Synthetic " << size << " x " << size << " map, " << layers.size() << " layers, "
+        << iterations << " iterations\n\n";
+    std::cout << "encoding        file KiB   decode ms (1 thread)   LoadTmxMap ms\n";
+
+    int failures = 0;
+    for (const Encoding& encoding : kEncodings)
+    {
+        const std::filesystem::path path = tempDir / (std::string("mon_bench_layers_") + encoding.label + ".tmx");
+
+        std::vector<std::string> layerTexts;
+        if (!WriteMap(path, encoding, layers, size, layerTexts))
+        {
+            std::cerr << encoding.label << ": failed to write " << path.string() << "\n";
+            ++failures;
+            continue;
+        }
+
+        // --- Decode only, layers one after another
+        TileLayerFormat format;
+        ParseTileLayerFormat(encoding.encoding, encoding.compression, format);
+
+        std::vector<uint32_t> gids(cellCount);
+        bool decodedOk = true;
+        Clock::time_point start = Clock::now();
+        for (int it = 0; it < iterations; ++it)
+        {
+            for (const std::string& text : layerTexts)
+            {
+                size_t count = 0;
+                decodedOk = DecodeTileLayerGids(format, text.data(), text.size(), gids.data(), gids.size(), count)
+                    && count == cellCount && decodedOk;
+            }
+        }
+        const double decodeMs = ElapsedMs(start) / iterations;
+
+        // --- Whole loader; it logs per map, so mute cout meanwhile
+        LoadedMap loadedMap;
+        bool loadedOk = true;
+        std::ostringstream sink;
+        std::streambuf* previous = std::cout.rdbuf(sink.rdbuf());
+        start = Clock::now();
+        for (int it = 0; it < iterations && loadedOk; ++it)
+        {
+            loadedMap = LoadedMap{};
+            loadedOk = LoadTmxMap(path.string(), loadedMap);
+        }
+        const double loadMs = ElapsedMs(start) / iterations;
+        std::cout.rdbuf(previous);
+
+        const MapData& mapData = loadedMap.mapData;
+        bool matches = loadedOk && mapData.layers.size() == layers.size();
+        for (size_t i = 0; matches && i < layers.size(); ++i)
+        {
+            const ArrayView<uint32_t> loaded = mapData.GetLayerGids(i);
+            matches = loaded.size() == cellCount
+                && std::equal(loaded.begin(), loaded.end(), layers[i].gids.begin(),
+                    [](uint32_t gid, uint32_t source) { return gid == (source & kTmxGidMask); });
+        }
+
+        std::error_code ec;
+        const uintmax_t fileBytes = std::filesystem::file_size(path, ec);
+        std::filesystem::remove(path, ec);
+
+        if (!decodedOk || !matches)
+        {
+            std::cerr << encoding.label << ": decoded layers do not match the source\n";
+            ++failures;
+            continue;
+        }
+
+        std::cout.width(14);
+        std::cout << std::left << encoding.label << std::right;
+        std::cout.width(10);
+        std::cout << fileBytes / 1024;
+        std::cout.width(23);
+        std::cout << decodeMs;
+        std::cout.width(16);
+        std::cout << loadMs << "\n";
+    }
+
+    return failures == 0 ? 0 : 1;
+}
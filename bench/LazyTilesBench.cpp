@@ -0,0 +1,98 @@
+// LazyTilesBench.cpp
+//
+// What reference-driven loading of image-collection tiles leaves out:
+// per map, the collection tiles its layers, tile objects and their
+// animation frames reference (CollectReferencedGids) against all the
+// tiles its tilesets define, in textures and in RGBA8 bytes of the
+// resolution variant TilesetRegistry would upload. Plus the cost of the
+// scan itself. No GL context needed.
+//
+// Usage: mon_bench_lazy_tiles [textureScale] [map.tmx ...]
+// Defaults to StarterZone.tmx and testmap.tmx at scale 1. Run from the
+// repo root, so the map's image paths resolve.
+
+#include "TextureVariants.h"
+#include "TileReferences.h"
+#include "TmxLoader.h"
+
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace
+{
+    struct Count
+    {
+        size_t textures = 0;
+        size_t bytes = 0;
+    };
+
+    void Report(const std::string& mapPath, float textureScale)
+    {
+        LoadedMap loadedMap;
+        if (!LoadTmxMap(mapPath, loadedMap))
+            return;
+        const MapData& mapData = loadedMap.mapData;
+
+        constexpr int kIterations = 100;
+        std::vector<uint8_t> referenced;
+        const auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < kIterations; ++i)
+            CollectReferencedGids(mapData, nullptr, referenced);
+        const double scanMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count()
+            / kIterations;
+
+        Count all, loaded;
+        for (const TilesetDef& def : mapData.tilesets)
+        {
+            for (const auto& [tileId, image] : def.tileImages)
+            {
+                int width = 0, height = 0;
+                SelectTextureVariant(image.path, image.w, image.h, textureScale, nullptr, width, height);
+                const size_t bytes = (size_t)width * (size_t)height * 4;
+
+                ++all.textures;
+                all.bytes += bytes;
+                if (IsGidReferenced(referenced, static_cast<uint32_t>(def.firstGid + tileId)))
+                {
+                    ++loaded.textures;
+                    loaded.bytes += bytes;
+                }
+            }
+        }
+
+        const size_t avoidedTextures = all.textures - loaded.textures;
+        const size_t avoidedBytes = all.bytes - loaded.bytes;
+        std::cout << std::fixed << std::setprecision(1)
+            << mapPath << " (scale " << textureScale << "):\n"
+            << "  collection tiles: " << all.textures << " (" << all.bytes / 1024 << " KiB)\n"
+            << "  referenced:       " << loaded.textures << " (" << loaded.bytes / 1024 << " KiB)\n"
+            << "  not loaded:       " << avoidedTextures << " (" << avoidedBytes / 1024 << " KiB, "
+            << (all.bytes > 0 ? 100.0 * avoidedBytes / all.bytes : 0.0) << " % of the bytes)\n"
+            << std::setprecision(3) << "  reference scan:   " << scanMs << " ms\n";
+    }
+}
+
+int main(int argc, char** argv)
+{
+    float textureScale = 1.0f;
+    std::vector<std::string> maps;
+    for (int i = 1; i < argc; ++i)
+    {
+        const std::string arg = argv[i];
+        if (i == 1 && arg.find(".tmx") == std::string::npos)
+            textureScale = (float)std::atof(arg.c_str());
+        else
+            maps.push_back(arg);
+    }
+
+    if (maps.empty())
+        maps = { "assets/maps/StarterZone.tmx", "assets/maps/testmap.tmx" };
+
+    for (const std::string& map : maps)
+        Report(map, textureScale);
+    return 0;
+}
@@ -0,0 +1,220 @@
+// MapLoadBench.cpp
+//
+// Map load time: TMX path (tinyxml2 + CSV + stbi_load of every image)
+// against the cooked bundle path (mmap + MapBundle::ToLoadedMap + reading
+// every pixel page, as the texture upload would).
+//
+// With an asset archive (mon_pack) present, the TMX path is timed a
+// second time with the archive mounted: same parse and decode, but every
+// TMX / TSX / PNG comes out of one mapping instead of an open + read each.
+//
+// Usage: mon_bench_map_load [map.tmx] [bundle.monb] [warm iterations] [assets.mona]
+// The bundle defaults to the .monb next to the map (run mon_cook first).
+// "Cold" runs evict the files from the page cache first where the OS
+// allows it (posix_fadvise); elsewhere cold equals first run.
+
+#include "AssetFiles.h"
+#include "MapBundle.h"
+#include "TmxLoader.h"
+
+#include "stb_image.h"
+
+#include <chrono>
+#include <cstdlib>
+#include <filesystem>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace
+{
+    using Clock = std::chrono::steady_clock;
+
+    void EvictFromPageCache(const std::string& path)
+    {
+#if defined(__unix__) && defined(POSIX_FADV_DONTNEED)
+        const int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0)
+            return;
+        ::fdatasync(fd);
+        ::posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+        ::close(fd);
+#else
+        (void)path;
+#endif
+    }
+
+    void EvictAssets(const std::string& bundlePath, const std::string& archivePath)
+    {
+        std::error_code ec;
+        for (auto it = std::filesystem::recursive_directory_iterator("assets", ec);
+            !ec && it != std::filesystem::recursive_directory_iterator(); it.increment(ec))
+        {
+            if (it->is_regular_file(ec))
+                EvictFromPageCache(it->path().string());
+        }
+        EvictFromPageCache(bundlePath);
+        EvictFromPageCache(archivePath);
+    }
+
+    std::vector<std::string> CollectImagePaths(const MapData& mapData)
+    {
+        std::vector<std::string> paths;
+        std::unordered_set<std::string> seen;
+        for (const TilesetDef& def : mapData.tilesets)
+        {
+            if (!def.isImageCollection && seen.insert(def.imagePath).second)
+                paths.push_back(def.imagePath);
+            for (const auto& entry : def.tileImages)
+            {
+                if (seen.insert(entry.second.path).second)
+                    paths.push_back(entry.second.path);
+            }
+        }
+        return paths;
+    }
+
+    // One byte per page: the same bytes on both paths, and every page of a
+    // mapped image gets touched like glTexImage2D would.
+    uint64_t PixelChecksum(const uint8_t* pixels, int w, int h)
+    {
+        uint64_t checksum = (uint64_t)w * h;
+        const size_t size = (size_t)w * h * 4;
+        for (size_t offset = 0; offset < size; offset += 4096)
+            checksum += pixels[offset];
+        return checksum;
+    }
+
+    // Returns a checksum so the work can't be optimized away; 0 on failure.
+    uint64_t LoadViaTmx(const std::string& tmxPath)
+    {
+        LoadedMap loadedMap;
+        if (!LoadTmxMap(tmxPath, loadedMap))
+            return 0;
+
+        uint64_t checksum = 1;
+        stbi_set_flip_vertically_on_load(false);
+        for (const std::string& path : CollectImagePaths(loadedMap.mapData))
+        {
+            int w = 0, h = 0;
+            unsigned char* pixels = LoadAssetImage(path, w, h);
+            if (!pixels)
+                return 0;
+            checksum += PixelChecksum(pixels, w, h);
+            stbi_image_free(pixels);
+        }
+        return checksum;
+    }
+
+    uint64_t LoadViaBundle(const std::string& bundlePath)
+    {
+        MapBundle bundle;
+        LoadedMap loadedMap;
+        if (!bundle.Open(bundlePath) || !bundle.ToLoadedMap(loadedMap))
+            return 0;
+
+        uint64_t checksum = 1;
+        for (const std::string& path : CollectImagePaths(loadedMap.mapData))
+        {
+            const uint8_t* pixels = nullptr;
+            int w = 0, h = 0;
+            if (!bundle.FindImage(path, pixels, w, h))
+                return 0;
+
+            checksum += PixelChecksum(pixels, w, h);
+        }
+        return checksum;
+    }
+
+    template <typename LoadFn>
+    double TimeMs(LoadFn load, uint64_t& outChecksum)
+    {
+        // The loaders log per map; keep the report readable.
+        std::ostringstream sink;
+        std::streambuf* previous = std::cout.rdbuf(sink.rdbuf());
+
+        const auto start = Clock::now();
+        outChecksum = load();
+        const double ms = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+
+        std::cout.rdbuf(previous);
+        return ms;
+    }
+}
+
+int main(int argc, char** argv)
+{
+    const std::string tmxPath = argc > 1 ? argv[1] : "assets/maps/StarterZone.tmx";
+    const std::string bundlePath = argc > 2 ? argv[2] : GetMapBundlePath(tmxPath);
+    const int iterations = argc > 3 ? std::max(1, std::atoi(argv[3])) : 10;
+    const std::string archivePath = argc > 4 ? argv[4] : "assets.mona";
+
+    if (!std::filesystem::exists(bundlePath))
+    {
+        std::cerr << "No bundle at " << bundlePath << " (run mon_cook " << tmxPath << ")\n";
+        return 1;
+    }
+
+    auto tmx = [&]() { return LoadViaTmx(tmxPath); };
+    auto cooked = [&]() { return LoadViaBundle(bundlePath); };
+
+    uint64_t tmxChecksum = 0;
+    uint64_t bundleChecksum = 0;
+
+    EvictAssets(bundlePath, archivePath);
+    const double tmxColdMs = TimeMs(tmx, tmxChecksum);
+    EvictAssets(bundlePath, archivePath);
+    const double bundleColdMs = TimeMs(cooked, bundleChecksum);
+
+    const size_t looseReads = GetAssetFileStats().looseReads;
+
+    double tmxWarmMs = 0.0;
+    double bundleWarmMs = 0.0;
+    for (int it = 0; it < iterations; ++it)
+    {
+        tmxWarmMs += TimeMs(tmx, tmxChecksum);
+        bundleWarmMs += TimeMs(cooked, bundleChecksum);
+    }
+    tmxWarmMs /= iterations;
+    bundleWarmMs /= iterations;
+
+    std::cout << "Map load benchmark: " << tmxPath << " vs " << bundlePath
+        << " (" << std::filesystem::file_size(bundlePath) / 1024 << " KB)\n";
+    std::cout << "  tmx   : cold " << tmxColdMs << " ms, warm " << tmxWarmMs << " ms\n";
+    std::cout << "  bundle: cold " << bundleColdMs << " ms, warm " << bundleWarmMs << " ms\n";
+
+    uint64_t archiveChecksum = tmxChecksum;
+    std::error_code ec;
+    if (std::filesystem::exists(archivePath, ec) && MountAssetArchive(archivePath))
+    {
+        const AssetFileStats before = GetAssetFileStats();
+        EvictAssets(bundlePath, archivePath);
+        const double archiveColdMs = TimeMs(tmx, archiveChecksum);
+        const AssetFileStats after = GetAssetFileStats();
+
+        double archiveWarmMs = 0.0;
+        for (int it = 0; it < iterations; ++it)
+            archiveWarmMs += TimeMs(tmx, archiveChecksum);
+        archiveWarmMs /= iterations;
+
+        std::cout << "  tmx + archive: cold " << archiveColdMs << " ms, warm " << archiveWarmMs << " ms ("
+            << looseReads << " loose files per load -> " << after.looseReads - before.looseReads << " loose + "
+            << after.archiveReads - before.archiveReads << " from the archive)\n";
+        UnmountAssetArchive();
+    }
+
+    if (tmxChecksum == 0 || bundleChecksum == 0 || tmxChecksum != bundleChecksum || archiveChecksum != tmxChecksum)
+    {
+        std::cerr << "  MISMATCH: TMX and bundle loads disagree (stale bundle?)\n";
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,147 @@
+// MapViewBench.cpp
+//
+// Resident memory of a large cooked map read through MapView (zero-copy
+// views into the mapping), then what the client holds once TileMap has
+// copied the drawn layers into its chunks, against the previous
+// copy-everything path (MapData vectors + TileMap layer copies + int
+// collision grid).
+//
+// Usage: mon_bench_map_view [size] [bundle path]
+// Writes a synthetic size x size bundle (default 2048) to the given path.
+// RSS comes from /proc/self/statm, so numbers are Linux only.
+
+#include "MapBundle.h"
+#include "MapView.h"
+#include "TileMap.h"
+
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#if defined(__linux__)
+#include <unistd.h>
+#endif
+
+namespace
+{
+    double ResidentMB()
+    {
+#if defined(__linux__)
+        std::ifstream statm("/proc/self/statm");
+        long pages = 0;
+        long resident = 0;
+        statm >> pages >> resident;
+        return (double)resident * (double)sysconf(_SC_PAGESIZE) / (1024.0 * 1024.0);
+#else
+        return 0.0;
+#endif
+    }
+
+    bool WriteSyntheticBundle(const std::string& path, int size)
+    {
+        MapData mapData;
+        mapData.width = size;
+        mapData.height = size;
+        mapData.tileW = 256;
+        mapData.tileH = 128;
+
+        TilesetDef tileset{};
+        tileset.firstGid = 1;
+        tileset.tileCount = 64;
+        tileset.tileW = 256;
+        tileset.tileH = 128;
+        tileset.imagePath = "synthetic.png";
+        mapData.tilesets.push_back(tileset);
+
+        mapData.layers = { { "ground", LayerPass::Ground, true }, { "walls", LayerPass::Occluder, true },
+            { "overhead", LayerPass::Overhead, true } };
+
+        const size_t cells = (size_t)size * size;
+        std::mt19937 rng(42);
+        mapData.layerGids.assign(cells * mapData.layers.size(), 0);
+        mapData.collision.assign(cells, 0);
+        uint32_t* ground = mapData.layerGids.data();
+        uint32_t* walls = ground + cells;
+        for (size_t i = 0; i < cells; ++i)
+        {
+            ground[i] = 1 + rng() % 64;
+            if (rng() % 8 == 0)
+            {
+                walls[i] = 1 + rng() % 64;
+                mapData.collision[i] = 1;
+            }
+        }
+
+        return WriteMapBundle(path, mapData, {});
+    }
+}
+
+int main(int argc, char** argv)
+{
+    const int size = argc > 1 ? std::max(64, std::atoi(argv[1])) : 2048;
+    const std::string bundlePath = argc > 2 ? argv[2] : "mapview_bench.monb";
+
+    if (!WriteSyntheticBundle(bundlePath, size))
+        return 1;
+
+    const double baseMB = ResidentMB();
+
+    MapBundle bundle;
+    if (!bundle.Open(bundlePath))
+        return 1;
+
+    const MapView view(bundle);
+    const double openMB = ResidentMB();
+
+    // A viewport's worth of cells: what a frame of TileMap / collision reads.
+    const int window = 64;
+    const int x0 = size / 2;
+    const int y0 = size / 2;
+    uint64_t checksum = 0;
+    for (int y = y0; y < y0 + window; ++y)
+    {
+        for (int x = x0; x < x0 + window; ++x)
+        {
+            const size_t index = (size_t)y * size + x;
+            for (size_t layer = 0; layer < view.GetLayerCount(); ++layer)
+                checksum += view.GetLayerGids(layer)[index];
+            checksum += view.IsBlocked(x, y) ? 1 : 0;
+        }
+    }
+    const double windowMB = ResidentMB();
+
+    // What the client does: TileMap copies every layer into its chunks,
+    // which also faults in every page of the mapped layers.
+    const LayerPass passes[] = { LayerPass::Ground, LayerPass::Occluder, LayerPass::Overhead };
+    TileMap tileMap(size, size, 256, 128);
+    for (size_t layer = 0; layer < view.GetLayerCount(); ++layer)
+        tileMap.AddLayer("layer" + std::to_string(layer), view.GetLayerGids(layer), passes[layer % 3], true);
+    const double clientMB = ResidentMB();
+
+    // Previous path (mapping already resident): MapData copies, TileMap layer copies, int collision grid.
+    std::vector<uint32_t> ground(view.GetLayerGids(0).begin(), view.GetLayerGids(0).end());
+    std::vector<uint32_t> walls(view.GetLayerGids(1).begin(), view.GetLayerGids(1).end());
+    std::vector<uint32_t> overhead(view.GetLayerGids(2).begin(), view.GetLayerGids(2).end());
+    std::vector<uint8_t> collision(view.GetCollision().begin(), view.GetCollision().end());
+    std::vector<uint32_t> groundLayer = ground;
+    std::vector<uint32_t> wallsLayer = walls;
+    std::vector<uint32_t> overheadLayer = overhead;
+    std::vector<int> collisionGrid(collision.begin(), collision.end());
+    checksum += groundLayer.back() + wallsLayer.back() + overheadLayer.back() + (uint64_t)collisionGrid.back();
+    const double copyMB = ResidentMB();
+
+    std::cout << "MapView benchmark: " << size << " x " << size << " cells, bundle "
+        << bundle.GetFileSize() / (1024 * 1024) << " MB\n";
+    std::cout << "  RSS after mmap                   : +" << (openMB - baseMB) << " MB\n";
+    std::cout << "  RSS after " << window << "x" << window << " window            : +" << (windowMB - baseMB) << " MB\n";
+    std::cout << "  RSS with TileMap chunks (client) : +" << (clientMB - baseMB) << " MB\n";
+    std::cout << "  old path's copies on top of that : +" << (copyMB - clientMB) << " MB\n";
+    std::cout << "  (checksum " << checksum << ")\n";
+
+    bundle.Close();
+    std::remove(bundlePath.c_str());
+    return 0;
+}
@@ -0,0 +1,260 @@
+// OverdrawBench.cpp
+//
+// Fill cost of a map's tile and object quads with and without the
+// cook-time trim (TileTrim.h). Every quad is counted at its drawn size;
+// a fragment that lands on a zero-alpha texel is blending work that
+// shows nothing. Counted on the CPU from the decoded images (nearest
+// sampling, like the renderer), so it needs no GL context.
+//
+// Usage: mon_bench_overdraw [map.tmx]
+// Run from the repo root, so the map's image paths resolve.
+
+#include "TileTrim.h"
+#include "TmxLoader.h"
+
+#include "stb_image.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace
+{
+    struct Fill
+    {
+        double fragments = 0.0;
+        double transparent = 0.0;
+    };
+
+    struct Image
+    {
+        int width = 0;
+        int height = 0;
+        std::vector<uint8_t> rgba;
+    };
+
+    // One drawable tile at its TSX size, untrimmed and trimmed.
+    struct TileFill
+    {
+        Fill full;
+        Fill trimmed;
+        int width = 0;
+        int height = 0;
+        bool collection = false; // image-collection tile: the ones mon_cook trims
+        bool valid = false;
+    };
+
+    const Image* LoadImage(const std::string& path, std::unordered_map<std::string, Image>& cache)
+    {
+        auto it = cache.find(path);
+        if (it != cache.end())
+            return it->second.rgba.empty() ? nullptr : &it->second;
+
+        Image& image = cache[path];
+        int channels = 0;
+        unsigned char* pixels = stbi_load(path.c_str(), &image.width, &image.height, &channels, 4);
+        if (!pixels)
+        {
+            std::cerr << "Failed to decode '" << path << "'\n";
+            return nullptr;
+        }
+        image.rgba.assign(pixels, pixels + (size_t)image.width * image.height * 4);
+        stbi_image_free(pixels);
+        return &image;
+    }
+
+    // Fragments of a drawWidth x drawHeight quad showing the source rect
+    // (srcX, srcY, srcW, srcH) of image, restricted to the quad's rect
+    // (x0, y0)-(x1, y1) in drawn pixels.
+    Fill CountFill(const Image& image, int srcX, int srcY, int srcW, int srcH,
+        int drawWidth, int drawHeight, int x0, int y0, int x1, int y1)
+    {
+        Fill fill;
+        for (int y = y0; y < y1; ++y)
+        {
+            const int ty = srcY + std::min(srcH - 1, (int)(((double)y + 0.5) * srcH / drawHeight));
+            for (int x = x0; x < x1; ++x)
+            {
+                const int tx = srcX + std::min(srcW - 1, (int)(((double)x + 0.5) * srcW / drawWidth));
+                fill.fragments += 1.0;
+                if (image.rgba[((size_t)ty * image.width + tx) * 4 + 3] == 0)
+                    fill.transparent += 1.0;
+            }
+        }
+        return fill;
+    }
+
+    TileFill MeasureTile(const TilesetDef& def, int localId, std::unordered_map<std::string, Image>& images)
+    {
+        TileFill tile;
+
+        if (def.isImageCollection)
+        {
+            const auto it = def.tileImages.find(localId);
+            if (it == def.tileImages.end())
+                return tile;
+
+            TileImageDef trim = it->second;
+            const Image* image = LoadImage(trim.path, images);
+            if (!image || trim.w <= 0 || trim.h <= 0)
+                return tile;
+
+            // What mon_cook stores for this tile.
+            AlphaBounds bounds;
+            if (ComputeAlphaBounds(image->rgba.data(), image->width, image->height, bounds))
+                SetTileTrim(trim, bounds, image->width, image->height);
+
+            tile.width = trim.w;
+            tile.height = trim.h;
+            tile.collection = true;
+            tile.full = CountFill(*image, 0, 0, image->width, image->height, trim.w, trim.h, 0, 0, trim.w, trim.h);
+            tile.trimmed = trim.trimW > 0
+                ? CountFill(*image, 0, 0, image->width, image->height, trim.w, trim.h,
+                    trim.trimX, trim.trimY, trim.trimX + trim.trimW, trim.trimY + trim.trimH)
+                : tile.full;
+            tile.valid = true;
+            return tile;
+        }
+
+        // Sheet tile: never trimmed (iso diamonds fill their cell's bounds).
+        const Image* image = LoadImage(def.imagePath, images);
+        if (!image || def.tileW <= 0 || def.tileH <= 0)
+            return tile;
+
+        const int columns = def.columns > 0 ? def.columns : std::max(1, image->width / def.tileW);
+        const int srcX = (localId % columns) * def.tileW;
+        const int srcY = (localId / columns) * def.tileH;
+        if (srcX + def.tileW > image->width || srcY + def.tileH > image->height)
+            return tile;
+
+        tile.width = def.tileW;
+        tile.height = def.tileH;
+        tile.full = CountFill(*image, srcX, srcY, def.tileW, def.tileH, def.tileW, def.tileH, 0, 0, def.tileW, def.tileH);
+        tile.trimmed = tile.full;
+        tile.valid = true;
+        return tile;
+    }
+
+    const TilesetDef* FindTileset(const MapData& mapData, uint32_t gid)
+    {
+        const TilesetDef* best = nullptr;
+        for (const TilesetDef& def : mapData.tilesets)
+        {
+            if ((uint32_t)def.firstGid <= gid && (!best || def.firstGid > best->firstGid))
+                best = &def;
+        }
+        return best;
+    }
+
+    void PrintRow(const char* label, const Fill& fill)
+    {
+        std::cout << "  " << std::left << std::setw(12) << label << std::right
+            << std::setw(12) << (long long)fill.fragments
+            << std::setw(14) << (long long)fill.transparent
+            << std::setw(9) << std::fixed << std::setprecision(1)
+            << (fill.fragments > 0.0 ? 100.0 * fill.transparent / fill.fragments : 0.0) << " %\n";
+    }
+}
+
+int main(int argc, char** argv)
+{
+    const std::string mapPath = argc > 1 ? argv[1] : "assets/maps/StarterZone.tmx";
+
+    LoadedMap loadedMap;
+    if (!LoadTmxMap(mapPath, loadedMap))
+        return 1;
+    const MapData& mapData = loadedMap.mapData;
+
+    stbi_set_flip_vertically_on_load(false);
+
+    std::unordered_map<std::string, Image> images;
+    std::map<uint32_t, TileFill> tiles;
+    auto GetTile = [&](uint32_t gid) -> const TileFill*
+        {
+            auto it = tiles.find(gid);
+            if (it == tiles.end())
+            {
+                const TilesetDef* def = FindTileset(mapData, gid);
+                TileFill tile;
+                if (def)
+                    tile = MeasureTile(*def, (int)gid - def->firstGid, images);
+                it = tiles.emplace(gid, tile).first;
+            }
+            return it->second.valid ? &it->second : nullptr;
+        };
+
+    Fill full, trimmed;
+    Fill collectionFull, collectionTrimmed;
+    size_t quads = 0;
+    size_t collectionQuads = 0;
+    size_t trimmedQuads = 0;
+
+    auto Add = [&](const TileFill& tile, double scale)
+        {
+            full.fragments += tile.full.fragments * scale;
+            full.transparent += tile.full.transparent * scale;
+            trimmed.fragments += tile.trimmed.fragments * scale;
+            trimmed.transparent += tile.trimmed.transparent * scale;
+            ++quads;
+            if (tile.trimmed.fragments < tile.full.fragments)
+                ++trimmedQuads;
+
+            if (!tile.collection)
+                return;
+            collectionFull.fragments += tile.full.fragments * scale;
+            collectionFull.transparent += tile.full.transparent * scale;
+            collectionTrimmed.fragments += tile.trimmed.fragments * scale;
+            collectionTrimmed.transparent += tile.trimmed.transparent * scale;
+            ++collectionQuads;
+        };
+
+    for (uint32_t gid : mapData.layerGids)
+    {
+        if (gid == 0)
+            continue;
+        if (const TileFill* tile = GetTile(gid))
+            Add(*tile, 1.0);
+    }
+
+    for (const MapObjectInstance& instance : mapData.objectInstances)
+    {
+        const TileFill* tile = GetTile(instance.tileIndex);
+        if (!tile)
+            continue;
+
+        // An object drawn at another size scales its fragments with it.
+        double scale = 1.0;
+        if (instance.size.x > 0.0f && instance.size.y > 0.0f)
+            scale = (double)instance.size.x * instance.size.y / ((double)tile->width * tile->height);
+        Add(*tile, scale);
+    }
+
+    // Iso map footprint: one diamond of tileW x tileH per cell.
+    const double footprint = (double)mapData.width * mapData.height * mapData.tileW * mapData.tileH * 0.5;
+
+    std::cout << mapPath << ": " << quads << " quads, " << trimmedQuads << " of them trimmed\n"
+        << "  " << std::left << std::setw(12) << "" << std::right
+        << std::setw(12) << "fragments" << std::setw(14) << "transparent" << std::setw(11) << "share\n";
+    PrintRow("untrimmed", full);
+    PrintRow("trimmed", trimmed);
+    std::cout << "  image-collection quads only (" << collectionQuads << "):\n";
+    PrintRow("untrimmed", collectionFull);
+    PrintRow("trimmed", collectionTrimmed);
+
+    if (footprint > 0.0)
+    {
+        std::cout << std::setprecision(2) << "  overdraw (fragments per map pixel): "
+            << full.fragments / footprint << " -> " << trimmed.fragments / footprint << "\n";
+    }
+    if (full.fragments > 0.0)
+    {
+        std::cout << std::setprecision(1) << "  fragments saved: " << (long long)(full.fragments - trimmed.fragments)
+            << " (" << 100.0 * (full.fragments - trimmed.fragments) / full.fragments << " %)\n";
+    }
+    return 0;
+}
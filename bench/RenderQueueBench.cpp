@@ -0,0 +1,159 @@
+// RenderQueueBench.cpp
+//
+// Compares the previous RenderQueue sort (std::stable_sort of whole RenderCmds
+// by depthKey) with the radix sort over packed sort keys behind
+// RenderQueue::SortByDepthStable, then the cost of merging a few dynamic
+// commands into a retained static partition.
+//
+// Usage: mon_bench_render_queue [iterations]
+// Depths are feet-y values on a pixel grid, so ties are common like in game.
+
+#include "RenderQueue.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <vector>
+
+namespace
+{
+    using Clock = std::chrono::steady_clock;
+
+    std::vector<RenderCmd> MakeCommands(size_t count, uint32_t seed)
+    {
+        std::mt19937 rng(seed);
+        std::uniform_int_distribution<int> depthPx(0, 4095);
+        std::uniform_int_distribution<int> texture(1, 64);
+
+        std::vector<RenderCmd> cmds(count);
+        for (size_t i = 0; i < count; ++i)
+        {
+            RenderCmd& cmd = cmds[i];
+            cmd.texture = static_cast<GLuint>(texture(rng));
+            cmd.posPx = { static_cast<float>(i % 512), static_cast<float>(i / 512) };
+            cmd.sizePx = { 64.0f, 64.0f };
+            cmd.depthKey = static_cast<float>(depthPx(rng)) * 0.5f;
+        }
+        return cmds;
+    }
+
+    double ElapsedMs(Clock::time_point start)
+    {
+        return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    }
+
+    // Radix order must equal a stable comparison sort on the same keys.
+    bool MatchesReference(const RenderQueue& queue)
+    {
+        const std::vector<RenderCmd>& items = queue.Items();
+
+        std::vector<const RenderCmd*> reference(items.size());
+        for (size_t i = 0; i < reference.size(); ++i)
+            reference[i] = &items[i];
+
+        std::stable_sort(reference.begin(), reference.end(),
+            [](const RenderCmd* a, const RenderCmd* b) { return a->sortKey < b->sortKey; });
+
+        return reference == queue.DrawList();
+    }
+}
+
+int main(int argc, char** argv)
+{
+    const int iterations = argc > 1 ? std::max(1, std::atoi(argv[1])) : 20;
+
+    std::cout << "RenderQueue sort benchmark (" << iterations << " iterations)\n";
+
+    bool ok = true;
+    for (size_t count : { size_t(10000), size_t(100000), size_t(1000000) })
+    {
+        const std::vector<RenderCmd> source = MakeCommands(count, 1234u);
+
+        // Previous path: stable_sort moves full commands every frame.
+        double stableMs = 0.0;
+        std::vector<RenderCmd> scratch;
+        for (int it = 0; it < iterations; ++it)
+        {
+            scratch = source;
+            const auto start = Clock::now();
+            std::stable_sort(scratch.begin(), scratch.end(),
+                [](const RenderCmd& a, const RenderCmd& b) { return a.depthKey < b.depthKey; });
+            stableMs += ElapsedMs(start);
+        }
+
+        // Radix path; Push is outside the timed region like the stable_sort copy.
+        double radixMs = 0.0;
+        RenderQueue queue;
+        queue.Reserve(count);
+        for (int it = 0; it < iterations; ++it)
+        {
+            queue.Clear();
+            for (const RenderCmd& cmd : source)
+                queue.Push(cmd);
+
+            const auto start = Clock::now();
+            queue.SortByDepthStable();
+            radixMs += ElapsedMs(start);
+        }
+
+        const bool matches = MatchesReference(queue);
+        ok = ok && matches;
+
+        stableMs /= iterations;
+        radixMs /= iterations;
+
+        std::cout << "  " << count << " cmds: stable_sort " << stableMs << " ms, radix "
+            << radixMs << " ms, speedup " << (radixMs > 0.0 ? stableMs / radixMs : 0.0) << "x"
+            << (matches ? "" : "  MISMATCH") << "\n";
+    }
+
+    // Retained static partition: map content sorted once, a handful of
+    // dynamic commands sorted + merged per frame.
+    for (size_t count : { size_t(10000), size_t(100000), size_t(1000000) })
+    {
+        const std::vector<RenderCmd> statics = MakeCommands(count, 99u);
+        const std::vector<RenderCmd> dynamics = MakeCommands(16, 7u);
+
+        RenderQueue queue;
+        for (const RenderCmd& cmd : statics)
+            queue.PushStatic(cmd);
+
+        auto start = Clock::now();
+        queue.SortStatic();
+        const double buildMs = ElapsedMs(start);
+
+        double mergeMs = 0.0;
+        for (int it = 0; it < iterations; ++it)
+        {
+            queue.Clear();
+            for (const RenderCmd& cmd : dynamics)
+                queue.Push(cmd);
+
+            start = Clock::now();
+            queue.SortByDepthStable();
+            mergeMs += ElapsedMs(start);
+        }
+        mergeMs /= iterations;
+
+        // Merged order must be sorted, with statics first on equal keys.
+        const std::vector<const RenderCmd*>& drawList = queue.DrawList();
+        bool sorted = drawList.size() == count + dynamics.size();
+        for (size_t i = 1; sorted && i < drawList.size(); ++i)
+            sorted = drawList[i - 1]->sortKey <= drawList[i]->sortKey;
+        ok = ok && sorted;
+
+        std::cout << "  static " << count << " + 16 dynamic: static sort " << buildMs
+            << " ms once, per-frame sort+merge " << mergeMs << " ms"
+            << (sorted ? "" : "  MISMATCH") << "\n";
+    }
+
+    if (!ok)
+    {
+        std::cerr << "  MISMATCH: radix / merged order is not sorted by key\n";
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,128 @@
+// TileResolverBench.cpp
+//
+// Compares TileResolver::ResolveByScan (linear tileset scan, hash lookups,
+// per-call UV math and animation resolution) with the gid table + per-frame
+// animation clock behind TileResolver::Resolve.
+//
+// Usage: mon_bench_resolver [map.tmx] [iterations]
+// No GL context is needed; texture ids are synthetic.
+
+#include "TileResolver.h"
+#include "TmxLoader.h"
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace
+{
+    std::vector<TilesetRuntime> MakeRuntimes(const MapData& mapData)
+    {
+        std::vector<TilesetRuntime> runtimes;
+        GLuint nextTexture = 1;
+
+        for (const TilesetDef& def : mapData.tilesets)
+        {
+            TileSet tileset(def.imageW, def.imageH, def.tileW, def.tileH);
+            tileset.SetAnimations(def.animations);
+
+            TilesetRuntime runtime{ def, tileset, 0, {}, {} };
+            if (def.isImageCollection)
+            {
+                for (const auto& entry : def.tileImages)
+                    runtime.tileTextures.emplace(entry.first, TileImageRegion{ nextTexture++ });
+            }
+            else
+            {
+                runtime.textureId = nextTexture++;
+            }
+
+            runtimes.push_back(std::move(runtime));
+        }
+
+        return runtimes;
+    }
+
+    std::vector<uint32_t> CollectGids(const MapData& mapData)
+    {
+        std::vector<uint32_t> gids = mapData.layerGids;
+
+        for (const MapObjectInstance& instance : mapData.objectInstances)
+            gids.push_back(instance.tileIndex);
+
+        return gids;
+    }
+
+    template <typename AdvanceFn, typename ResolveFn>
+    double TimeResolves(const std::vector<uint32_t>& gids, int iterations, AdvanceFn advance, ResolveFn resolve, uint64_t& outChecksum)
+    {
+        using Clock = std::chrono::steady_clock;
+
+        uint64_t checksum = 0;
+        const auto start = Clock::now();
+        for (int it = 0; it < iterations; ++it)
+        {
+            const float timeMs = it * 16.0f;
+            advance(timeMs);
+            for (uint32_t gid : gids)
+            {
+                ResolvedTile resolved{};
+                if (resolve(gid, timeMs, resolved))
+                    checksum += resolved.textureId + static_cast<uint64_t>(resolved.uvMin.x * 4096.0f);
+            }
+        }
+        const auto end = Clock::now();
+
+        outChecksum = checksum;
+        const double ns = std::chrono::duration<double, std::nano>(end - start).count();
+        return ns / (static_cast<double>(gids.size()) * iterations);
+    }
+}
+
+int main(int argc, char** argv)
+{
+    const std::string mapPath = argc > 1 ? argv[1] : "assets/maps/testmap.tmx";
+    const int iterations = argc > 2 ? std::atoi(argv[2]) : 200;
+
+    LoadedMap loadedMap;
+    if (!LoadTmxMap(mapPath, loadedMap))
+        return 1;
+
+    const std::vector<TilesetRuntime> runtimes = MakeRuntimes(loadedMap.mapData);
+    const std::vector<uint32_t> gids = CollectGids(loadedMap.mapData);
+    if (gids.empty())
+    {
+        std::cerr << "No gids to resolve in " << mapPath << "\n";
+        return 1;
+    }
+
+    TileResolver resolver(runtimes);
+
+    uint64_t scanChecksum = 0;
+    uint64_t tableChecksum = 0;
+
+    const double scanNs = TimeResolves(gids, iterations,
+        [](float) {},
+        [&](uint32_t gid, float t, ResolvedTile& out) { return resolver.ResolveByScan(gid, t, out); },
+        scanChecksum);
+    const double tableNs = TimeResolves(gids, iterations,
+        [&](float t) { resolver.AdvanceAnimations(t); },
+        [&](uint32_t gid, float, ResolvedTile& out) { return resolver.Resolve(gid, out); },
+        tableChecksum);
+
+    std::cout << "Resolver benchmark: " << mapPath << "\n";
+    std::cout << "  gids per pass: " << gids.size() << ", passes: " << iterations << "\n";
+    std::cout << "  scan : " << scanNs << " ns/resolve\n";
+    std::cout << "  table: " << tableNs << " ns/resolve\n";
+    std::cout << "  speedup: " << (tableNs > 0.0 ? scanNs / tableNs : 0.0) << "x\n";
+
+    if (scanChecksum != tableChecksum)
+    {
+        std::cerr << "  MISMATCH: scan and table resolvers disagree\n";
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,32 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+/*
+    ArrayView
+    ---------
+    Non-owning pointer + count (C++17 has no std::span).
+    Used to hand out arrays that live inside a memory-mapped file.
+*/
+template <typename T>
+class ArrayView
+{
+public:
+    ArrayView() = default;
+    ArrayView(const T* data, size_t count) : mData(data), mCount(count) {}
+    ArrayView(const std::vector<T>& values) : mData(values.data()), mCount(values.size()) {}
+
+    const T* data() const { return mData; }
+    size_t size() const { return mCount; }
+    bool empty() const { return mCount == 0; }
+
+    const T* begin() const { return mData; }
+    const T* end() const { return mData + mCount; }
+
+    const T& operator[](size_t index) const { return mData[index]; }
+
+private:
+    const T* mData = nullptr;
+    size_t mCount = 0;
+};
@@ -0,0 +1,234 @@
+#include "AssetArchive.h"
+
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <string_view>
+
+namespace
+{
+    uint64_t AlignUp(uint64_t value, uint64_t align)
+    {
+        return (value + align - 1) & ~(align - 1);
+    }
+
+    void WritePadding(std::ofstream& out, uint64_t from, uint64_t to)
+    {
+        static const char kZeros[kAssetArchiveAlign] = {};
+        while (from < to)
+        {
+            const uint64_t count = std::min<uint64_t>(to - from, sizeof(kZeros));
+            out.write(kZeros, (std::streamsize)count);
+            from += count;
+        }
+    }
+
+    bool EntryLess(const AssetArchiveEntry& entry, const char* strings, uint64_t hash, const std::string& path)
+    {
+        if (entry.pathHash != hash)
+            return entry.pathHash < hash;
+        return std::string_view(strings + entry.pathOffset, entry.pathLength) < std::string_view(path);
+    }
+}
+
+std::string NormalizeAssetPath(const std::string& path)
+{
+    std::string normalized = std::filesystem::path(path).lexically_normal().generic_string();
+    if (normalized.compare(0, 2, "./") == 0)
+        normalized.erase(0, 2);
+    return normalized;
+}
+
+uint64_t HashAssetPath(const std::string& normalizedPath)
+{
+    uint64_t hash = 14695981039346656037ull;
+    for (const char c : normalizedPath)
+    {
+        hash ^= (uint8_t)c;
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
+bool WriteAssetArchive(const std::string& archivePath, const std::vector<std::string>& files)
+{
+    struct Source
+    {
+        std::string path;     // normalized, as stored
+        std::string diskPath; // as given
+        uint64_t hash = 0;
+        uint64_t size = 0;
+    };
+
+    std::vector<Source> sources;
+    sources.reserve(files.size());
+    for (const std::string& file : files)
+    {
+        std::error_code ec;
+        const uint64_t size = std::filesystem::file_size(file, ec);
+        if (ec)
+        {
+            std::cerr << "Cannot read '" << file << "': " << ec.message() << "\n";
+            return false;
+        }
+
+        Source source;
+        source.path = NormalizeAssetPath(file);
+        source.diskPath = file;
+        source.hash = HashAssetPath(source.path);
+        source.size = size;
+        sources.push_back(std::move(source));
+    }
+
+    std::sort(sources.begin(), sources.end(), [](const Source& a, const Source& b)
+        {
+            if (a.hash != b.hash)
+                return a.hash < b.hash;
+            return a.path < b.path;
+        });
+    sources.erase(std::unique(sources.begin(), sources.end(), [](const Source& a, const Source& b)
+        {
+            return a.path == b.path;
+        }), sources.end());
+
+    // Layout first, so everything can be streamed out in one pass.
+    AssetArchiveHeader header{};
+    header.entryCount = (uint32_t)sources.size();
+    header.stringsOffset = sizeof(AssetArchiveHeader) + sources.size() * sizeof(AssetArchiveEntry);
+
+    std::vector<AssetArchiveEntry> entries(sources.size());
+    std::string strings;
+    for (size_t i = 0; i < sources.size(); ++i)
+    {
+        entries[i].pathHash = sources[i].hash;
+        entries[i].pathOffset = (uint32_t)strings.size();
+        entries[i].pathLength = (uint32_t)sources[i].path.size();
+        strings += sources[i].path;
+    }
+    header.stringsSize = strings.size();
+
+    uint64_t offset = header.stringsOffset + header.stringsSize;
+    for (size_t i = 0; i < sources.size(); ++i)
+    {
+        offset = AlignUp(offset, kAssetArchiveAlign);
+        entries[i].dataOffset = offset;
+        entries[i].dataSize = sources[i].size;
+        offset += sources[i].size;
+    }
+
+    std::ofstream out(archivePath, std::ios::binary | std::ios::trunc);
+    if (!out)
+    {
+        std::cerr << "Cannot write '" << archivePath << "'\n";
+        return false;
+    }
+
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    out.write(reinterpret_cast<const char*>(entries.data()), (std::streamsize)(entries.size() * sizeof(AssetArchiveEntry)));
+    out.write(strings.data(), (std::streamsize)strings.size());
+
+    std::vector<char> buffer(1 << 20);
+    uint64_t written = header.stringsOffset + header.stringsSize;
+    for (size_t i = 0; i < sources.size(); ++i)
+    {
+        WritePadding(out, written, entries[i].dataOffset);
+        written = entries[i].dataOffset;
+
+        std::ifstream in(sources[i].diskPath, std::ios::binary);
+        uint64_t left = sources[i].size;
+        while (in && left > 0)
+        {
+            const uint64_t chunk = std::min<uint64_t>(left, buffer.size());
+            in.read(buffer.data(), (std::streamsize)chunk);
+            out.write(buffer.data(), in.gcount());
+            left -= (uint64_t)in.gcount();
+            written += (uint64_t)in.gcount();
+            if (in.gcount() == 0)
+                break;
+        }
+
+        if (left > 0)
+        {
+            std::cerr << "Short read of '" << sources[i].diskPath << "'\n";
+            return false;
+        }
+    }
+
+    return (bool)out;
+}
+
+bool AssetArchive::Open(const std::string& archivePath)
+{
+    Close();
+
+    if (!mFile.Open(archivePath))
+        return false;
+
+    const size_t fileSize = mFile.Size();
+    const AssetArchiveHeader* header = reinterpret_cast<const AssetArchiveHeader*>(mFile.Data());
+    if (fileSize < sizeof(AssetArchiveHeader)
+        || header->magic != kAssetArchiveMagic || header->version != kAssetArchiveVersion)
+    {
+        std::cerr << "Archive '" << archivePath << "' has an unsupported header\n";
+        Close();
+        return false;
+    }
+
+    const uint64_t indexEnd = sizeof(AssetArchiveHeader) + (uint64_t)header->entryCount * sizeof(AssetArchiveEntry);
+    if (header->stringsOffset < indexEnd || header->stringsOffset > fileSize
+        || header->stringsSize > fileSize - header->stringsOffset)
+    {
+        std::cerr << "Archive '" << archivePath << "' index is out of bounds\n";
+        Close();
+        return false;
+    }
+
+    const AssetArchiveEntry* entries = reinterpret_cast<const AssetArchiveEntry*>(mFile.Data() + sizeof(AssetArchiveHeader));
+    for (uint32_t i = 0; i < header->entryCount; ++i)
+    {
+        const AssetArchiveEntry& entry = entries[i];
+        if ((uint64_t)entry.pathOffset + entry.pathLength > header->stringsSize
+            || entry.dataOffset > fileSize || entry.dataSize > fileSize - entry.dataOffset)
+        {
+            std::cerr << "Archive '" << archivePath << "' entry " << i << " is out of bounds\n";
+            Close();
+            return false;
+        }
+    }
+
+    mHeader = header;
+    mEntries = entries;
+    mStrings = reinterpret_cast<const char*>(mFile.Data() + header->stringsOffset);
+    return true;
+}
+
+void AssetArchive::Close()
+{
+    mFile.Close();
+    mHeader = nullptr;
+    mEntries = nullptr;
+    mStrings = nullptr;
+}
+
+bool AssetArchive::Find(const std::string& normalizedPath, const uint8_t*& outData, size_t& outSize) const
+{
+    if (!mHeader)
+        return false;
+
+    const uint64_t hash = HashAssetPath(normalizedPath);
+    const AssetArchiveEntry* end = mEntries + mHeader->entryCount;
+    const AssetArchiveEntry* it = std::lower_bound(mEntries, end, normalizedPath,
+        [this, hash](const AssetArchiveEntry& entry, const std::string& path)
+        {
+            return EntryLess(entry, mStrings, hash, path);
+        });
+
+    if (it == end || it->pathHash != hash
+        || std::string_view(mStrings + it->pathOffset, it->pathLength) != std::string_view(normalizedPath))
+        return false;
+
+    outData = mFile.Data() + it->dataOffset;
+    outSize = (size_t)it->dataSize;
+    return true;
+}
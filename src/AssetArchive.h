@@ -0,0 +1,90 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "MappedFile.h"
+
+/*
+    AssetArchive
+    ------------
+    Read-only pack of loose asset files (PNG, TSX, TMX, ...), written
+    offline by mon_pack (tools/AssetPacker.cpp). One open + one mmap
+    replaces a path lookup, open and read per file.
+
+    Layout (little-endian):
+        AssetArchiveHeader
+        AssetArchiveEntry[entryCount]  sorted by (pathHash, path)
+        path strings                   (not NUL-terminated)
+        file contents                  each kAssetArchiveAlign-aligned
+
+    Paths are stored normalized (HashAssetPath / NormalizeAssetPath), as
+    the client spells them relative to its working directory:
+    "assets/Tiles/Shadow/256x256/Tree01_0001.png". Find() is a binary
+    search on the hash plus a string compare; contents point into the
+    mapping, so only the pages actually read are faulted in.
+*/
+
+constexpr uint32_t kAssetArchiveMagic = 0x414E4F4Du; // "MONA"
+constexpr uint32_t kAssetArchiveVersion = 1;
+constexpr uint64_t kAssetArchiveAlign = 4096;        // file contents start on a page
+
+struct AssetArchiveHeader
+{
+    uint32_t magic = kAssetArchiveMagic;
+    uint32_t version = kAssetArchiveVersion;
+    uint32_t entryCount = 0;
+    uint32_t reserved = 0;
+    uint64_t stringsOffset = 0;
+    uint64_t stringsSize = 0;
+};
+
+struct AssetArchiveEntry
+{
+    uint64_t pathHash = 0;
+    uint32_t pathOffset = 0; // into the path strings
+    uint32_t pathLength = 0;
+    uint64_t dataOffset = 0; // from file start
+    uint64_t dataSize = 0;
+};
+
+// "./assets/maps/../Tiles/a.png" -> "assets/Tiles/a.png" (lexical only, '/' separators).
+std::string NormalizeAssetPath(const std::string& path);
+
+// FNV-1a 64 of a normalized path.
+uint64_t HashAssetPath(const std::string& normalizedPath);
+
+// Packs files (paths as the client will ask for them) into archivePath.
+// Streams each file through; nothing is held in memory but the index.
+bool WriteAssetArchive(const std::string& archivePath, const std::vector<std::string>& files);
+
+class AssetArchive
+{
+public:
+    AssetArchive() = default;
+
+    AssetArchive(const AssetArchive&) = delete;
+    AssetArchive& operator=(const AssetArchive&) = delete;
+
+    // Maps the file and validates the header, index and every entry's bounds.
+    bool Open(const std::string& archivePath);
+    void Close();
+
+    bool IsOpen() const { return mHeader != nullptr; }
+    size_t GetEntryCount() const { return mHeader ? mHeader->entryCount : 0; }
+    size_t GetFileSize() const { return mFile.Size(); }
+
+    // normalizedPath: NormalizeAssetPath() output. Contents point into the mapping.
+    bool Find(const std::string& normalizedPath, const uint8_t*& outData, size_t& outSize) const;
+
+    // Call before reading what Find() returned: pages it in with one request.
+    void Prefetch(const uint8_t* data, size_t size) const { mFile.Prefetch((size_t)(data - mFile.Data()), size); }
+
+private:
+    MappedFile mFile;
+    const AssetArchiveHeader* mHeader = nullptr;
+    const AssetArchiveEntry* mEntries = nullptr;
+    const char* mStrings = nullptr;
+};
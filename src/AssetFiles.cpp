@@ -0,0 +1,118 @@
+#include "AssetFiles.h"
+
+#include "AssetArchive.h"
+#include "stb_image.h"
+
+#include <algorithm>
+#include <atomic>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+
+namespace
+{
+    AssetArchive gArchive;
+    std::atomic<size_t> gArchiveReads{ 0 };
+    std::atomic<size_t> gLooseReads{ 0 };
+
+    bool FindInArchive(const std::string& path, const uint8_t*& outData, size_t& outSize)
+    {
+        return gArchive.IsOpen() && gArchive.Find(NormalizeAssetPath(path), outData, outSize);
+    }
+}
+
+bool MountAssetArchive(const std::string& archivePath)
+{
+    if (!gArchive.Open(archivePath))
+        return false;
+
+    std::cout << "Mounted asset archive '" << archivePath << "': " << gArchive.GetEntryCount() << " files, "
+        << gArchive.GetFileSize() / (1024 * 1024) << " MiB\n";
+    return true;
+}
+
+void UnmountAssetArchive()
+{
+    gArchive.Close();
+}
+
+AssetFileStats GetAssetFileStats()
+{
+    AssetFileStats stats{};
+    stats.archiveEntries = gArchive.GetEntryCount();
+    stats.archiveReads = gArchiveReads.load(std::memory_order_relaxed);
+    stats.looseReads = gLooseReads.load(std::memory_order_relaxed);
+    return stats;
+}
+
+bool AssetFile::Load(const std::string& path)
+{
+    mOwned.clear();
+    mData = nullptr;
+    mSize = 0;
+
+    if (FindInArchive(path, mData, mSize))
+    {
+        gArchive.Prefetch(mData, mSize);
+        ++gArchiveReads;
+        return true;
+    }
+
+    std::ifstream in(path, std::ios::binary | std::ios::ate);
+    if (!in)
+        return false;
+
+    const std::streamsize size = in.tellg();
+    in.seekg(0);
+    mOwned.resize((size_t)std::max<std::streamsize>(0, size));
+    if (!in.read(reinterpret_cast<char*>(mOwned.data()), size))
+    {
+        mOwned.clear();
+        return false;
+    }
+
+    mData = mOwned.data();
+    mSize = mOwned.size();
+    ++gLooseReads;
+    return true;
+}
+
+bool AssetFileExists(const std::string& path)
+{
+    const uint8_t* data = nullptr;
+    size_t size = 0;
+    if (FindInArchive(path, data, size))
+        return true;
+
+    std::error_code ec;
+    return std::filesystem::is_regular_file(path, ec);
+}
+
+unsigned char* LoadAssetImage(const std::string& path, int& outWidth, int& outHeight)
+{
+    int channels = 0;
+
+    const uint8_t* data = nullptr;
+    size_t size = 0;
+    if (FindInArchive(path, data, size))
+    {
+        gArchive.Prefetch(data, size);
+        ++gArchiveReads;
+        return stbi_load_from_memory(data, (int)size, &outWidth, &outHeight, &channels, 4);
+    }
+
+    ++gLooseReads;
+    return stbi_load(path.c_str(), &outWidth, &outHeight, &channels, 4);
+}
+
+bool ReadAssetImageSize(const std::string& path, int& outWidth, int& outHeight)
+{
+    int channels = 0;
+
+    const uint8_t* data = nullptr;
+    size_t size = 0;
+    if (FindInArchive(path, data, size))
+        return stbi_info_from_memory(data, (int)size, &outWidth, &outHeight, &channels) != 0;
+
+    return stbi_info(path.c_str(), &outWidth, &outHeight, &channels) != 0;
+}
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/*
+    Asset files
+    -----------
+    The one place the client reads asset files from (TmxLoader's TMX /
+    TSX, every tileset image decode, variant lookups). With an archive
+    mounted (AssetArchive.h) a path it holds is served from the mapping:
+    no open, no stat, no read syscall. Anything else, or everything when
+    no archive is mounted, falls back to the loose file as before.
+
+    Mount once at startup, before the texture decoders / preloader start,
+    and unmount after they stop; lookups themselves are read-only and safe
+    from any thread.
+*/
+bool MountAssetArchive(const std::string& archivePath);
+void UnmountAssetArchive();
+
+struct AssetFileStats
+{
+    size_t archiveEntries = 0; // 0 = no archive mounted
+    size_t archiveReads = 0;   // served from the archive
+    size_t looseReads = 0;     // fell back to a loose file
+};
+
+AssetFileStats GetAssetFileStats();
+
+// Contents of one asset: a view into the archive, or the loose file read
+// into owned storage.
+class AssetFile
+{
+public:
+    bool Load(const std::string& path);
+
+    const uint8_t* Data() const { return mData; }
+    size_t Size() const { return mSize; }
+    bool IsFromArchive() const { return mOwned.empty() && mData != nullptr; }
+
+private:
+    const uint8_t* mData = nullptr;
+    size_t mSize = 0;
+    std::vector<uint8_t> mOwned;
+};
+
+bool AssetFileExists(const std::string& path);
+
+// stbi_load() through the archive: RGBA8, honoring the thread's / global
+// stbi flip setting. Free with stbi_image_free(); nullptr on failure
+// (stbi_failure_reason() says why).
+unsigned char* LoadAssetImage(const std::string& path, int& outWidth, int& outHeight);
+
+// The image's size from its header alone (stbi_info), without a decode.
+bool ReadAssetImageSize(const std::string& path, int& outWidth, int& outHeight);
@@ -0,0 +1,354 @@
+#include "ChunkStreamer.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+
+namespace
+{
+    int ChunkX(uint64_t key) { return static_cast<int>(static_cast<uint32_t>(key >> 32)); }
+    int ChunkY(uint64_t key) { return static_cast<int>(static_cast<uint32_t>(key)); }
+
+    int ChunkDistance(uint64_t key, const glm::ivec2& centerChunk)
+    {
+        return std::max(std::abs(ChunkX(key) - centerChunk.x), std::abs(ChunkY(key) - centerChunk.y));
+    }
+
+    // outGids holds cellCount zeroed entries; left zeroed when the layer is absent or malformed.
+    bool DecodeChunkLayer(const MapChunkLayer& layer, size_t cellCount, uint32_t* outGids)
+    {
+        if (layer.data.empty())
+            return true;
+
+        size_t count = 0;
+        if (!DecodeTileLayerGids(layer.format, layer.data.data(), layer.data.size(), outGids, cellCount, count)
+            || count != cellCount)
+        {
+            std::fill(outGids, outGids + cellCount, 0u);
+            return false;
+        }
+        return true;
+    }
+}
+
+ChunkStreamer::~ChunkStreamer()
+{
+    Stop();
+}
+
+void ChunkStreamer::Start(const MapData& mapData, int loadRadius)
+{
+    Stop();
+
+    if (!mapData.infinite || mapData.chunkW <= 0 || mapData.chunkH <= 0)
+        return;
+
+    mMap = &mapData;
+    mLoadRadius = std::max(1, loadRadius);
+    BuildBlockingTable();
+
+    mStopping = false;
+    mWorker = std::thread(&ChunkStreamer::WorkerLoop, this);
+}
+
+void ChunkStreamer::Stop()
+{
+    if (mWorker.joinable())
+    {
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            mStopping = true;
+            mQueue.clear();
+        }
+        mWake.notify_all();
+        mWorker.join();
+    }
+
+    mMap = nullptr;
+    mBlockingGids.clear();
+    mResident.clear();
+    mRequested.clear();
+    mReady.clear();
+    mDecoded.clear();
+    mLoadedTotal = 0;
+    mEvictedTotal = 0;
+    mDecodeMsTotal = 0.0;
+}
+
+void ChunkStreamer::BuildBlockingTable()
+{
+    // Same ownership rule as FindTilesetForGid: a gid belongs to the tileset
+    // with the highest firstGid <= gid (tilesets are sorted by firstGid).
+    const std::vector<TilesetDef>& tilesets = mMap->tilesets;
+    mBlockingGids.clear();
+
+    for (size_t i = 0; i < tilesets.size(); ++i)
+    {
+        const TilesetDef& def = tilesets[i];
+        const int nextFirstGid = i + 1 < tilesets.size() ? tilesets[i + 1].firstGid : 0;
+
+        for (const auto& [localId, flags] : def.tileFlags)
+        {
+            const int gid = def.firstGid + localId;
+            if (!flags.blocking || gid <= 0 || (nextFirstGid > 0 && gid >= nextFirstGid))
+                continue;
+
+            if ((size_t)gid >= mBlockingGids.size())
+                mBlockingGids.resize((size_t)gid + 1, 0);
+            mBlockingGids[gid] = 1;
+        }
+    }
+}
+
+std::unique_ptr<MapChunkCells> ChunkStreamer::DecodeChunk(uint64_t key) const
+{
+    const auto it = mMap->chunks.find(key);
+    if (it == mMap->chunks.end())
+        return nullptr;
+
+    const MapChunkDef& def = it->second;
+    const size_t cellCount = (size_t)def.width * def.height;
+
+    auto cells = std::make_unique<MapChunkCells>();
+    cells->chunkX = ChunkX(key);
+    cells->chunkY = ChunkY(key);
+    cells->originX = def.x;
+    cells->originY = def.y;
+    cells->width = def.width;
+    cells->height = def.height;
+
+    cells->layerCount = mMap->layers.size();
+    cells->gids.assign(cells->layerCount * cellCount, 0);
+
+    bool ok = true;
+    for (size_t layer = 0; layer < def.layers.size() && layer < cells->layerCount; ++layer)
+        ok = DecodeChunkLayer(def.layers[layer], cellCount, cells->gids.data() + layer * cellCount) && ok;
+
+    std::vector<uint32_t> collisionGids;
+    if (!def.collision.data.empty())
+    {
+        collisionGids.assign(cellCount, 0);
+        ok = DecodeChunkLayer(def.collision, cellCount, collisionGids.data()) && ok;
+    }
+
+    if (!ok)
+        std::cerr << "Chunk (" << def.x << "," << def.y << ") has malformed layer data\n";
+
+    // Collision layer OR any tile flagged blocking (as LoadTmxMap does for dense maps).
+    cells->collision.assign(cellCount, 0);
+    auto IsBlockingGid = [this](uint32_t gid) { return gid < mBlockingGids.size() && mBlockingGids[gid] != 0; };
+
+    for (size_t i = 0; i < cellCount; ++i)
+    {
+        bool blocked = !collisionGids.empty() && collisionGids[i] != 0;
+        for (size_t layer = 0; layer < cells->layerCount && !blocked; ++layer)
+            blocked = IsBlockingGid(cells->gids[layer * cellCount + i]);
+        cells->collision[i] = blocked ? 1 : 0;
+    }
+
+    return cells;
+}
+
+void ChunkStreamer::WorkerLoop()
+{
+    for (;;)
+    {
+        uint64_t key = 0;
+        {
+            std::unique_lock<std::mutex> lock(mMutex);
+            mWake.wait(lock, [this]() { return mStopping || !mQueue.empty(); });
+            if (mStopping)
+                return;
+
+            key = mQueue.front();
+            mQueue.pop_front();
+        }
+
+        const auto start = std::chrono::steady_clock::now();
+        std::unique_ptr<MapChunkCells> cells = DecodeChunk(key);
+        const double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+        std::lock_guard<std::mutex> lock(mMutex);
+        mDecodeMsTotal += ms;
+        if (cells)
+            mDecoded.push_back(std::move(cells));
+    }
+}
+
+bool ChunkStreamer::IsWithin(uint64_t key, const glm::ivec2& centerChunk, int radius) const
+{
+    return ChunkDistance(key, centerChunk) <= radius;
+}
+
+void ChunkStreamer::Prime(const glm::ivec2& centerCell, int radius, std::vector<uint64_t>& outActivated)
+{
+    outActivated.clear();
+    if (!mMap)
+        return;
+
+    const glm::ivec2 centerChunk(FloorDiv(centerCell.x, mMap->chunkW), FloorDiv(centerCell.y, mMap->chunkH));
+
+    for (int cy = centerChunk.y - radius; cy <= centerChunk.y + radius; ++cy)
+    {
+        for (int cx = centerChunk.x - radius; cx <= centerChunk.x + radius; ++cx)
+        {
+            const uint64_t key = MakeChunkKey(cx, cy);
+            if (mResident.count(key) || mRequested.count(key))
+                continue;
+
+            std::unique_ptr<MapChunkCells> cells = DecodeChunk(key);
+            if (!cells)
+                continue;
+
+            mResident[key] = std::move(cells);
+            ++mLoadedTotal;
+            outActivated.push_back(key);
+        }
+    }
+}
+
+bool ChunkStreamer::Update(const glm::ivec2& centerCell, int maxActivations,
+    std::vector<uint64_t>& outActivated, std::vector<uint64_t>& outEvicted)
+{
+    outActivated.clear();
+    outEvicted.clear();
+    if (!mMap)
+        return false;
+
+    const glm::ivec2 centerChunk(FloorDiv(centerCell.x, mMap->chunkW), FloorDiv(centerCell.y, mMap->chunkH));
+    const int keepRadius = mLoadRadius + 1;
+
+    // --- Collect finished decodes; drop queued work that fell out of range
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        for (std::unique_ptr<MapChunkCells>& cells : mDecoded)
+            mReady.push_back(std::move(cells));
+        mDecoded.clear();
+
+        for (auto it = mQueue.begin(); it != mQueue.end();)
+        {
+            if (IsWithin(*it, centerChunk, keepRadius))
+            {
+                ++it;
+                continue;
+            }
+            mRequested.erase(*it);
+            it = mQueue.erase(it);
+        }
+    }
+
+    // --- Activate ready chunks, nearest first, within the per-frame budget
+    std::sort(mReady.begin(), mReady.end(),
+        [&](const std::unique_ptr<MapChunkCells>& a, const std::unique_ptr<MapChunkCells>& b)
+        {
+            return ChunkDistance(MakeChunkKey(a->chunkX, a->chunkY), centerChunk)
+                < ChunkDistance(MakeChunkKey(b->chunkX, b->chunkY), centerChunk);
+        });
+
+    size_t readyKept = 0;
+    for (size_t i = 0; i < mReady.size(); ++i)
+    {
+        const uint64_t key = MakeChunkKey(mReady[i]->chunkX, mReady[i]->chunkY);
+        if (!IsWithin(key, centerChunk, keepRadius))
+        {
+            mRequested.erase(key);
+            continue;
+        }
+
+        if ((int)outActivated.size() < maxActivations)
+        {
+            mRequested.erase(key);
+            mResident[key] = std::move(mReady[i]);
+            ++mLoadedTotal;
+            outActivated.push_back(key);
+            continue;
+        }
+
+        mReady[readyKept++] = std::move(mReady[i]);
+    }
+    mReady.resize(readyKept);
+
+    // --- Evict far chunks
+    for (auto it = mResident.begin(); it != mResident.end();)
+    {
+        if (IsWithin(it->first, centerChunk, keepRadius))
+        {
+            ++it;
+            continue;
+        }
+        outEvicted.push_back(it->first);
+        ++mEvictedTotal;
+        it = mResident.erase(it);
+    }
+
+    // --- Request missing chunks in the load ring, nearest first
+    std::vector<uint64_t> missing;
+    for (int cy = centerChunk.y - mLoadRadius; cy <= centerChunk.y + mLoadRadius; ++cy)
+    {
+        for (int cx = centerChunk.x - mLoadRadius; cx <= centerChunk.x + mLoadRadius; ++cx)
+        {
+            const uint64_t key = MakeChunkKey(cx, cy);
+            if (mResident.count(key) || mRequested.count(key) || !mMap->chunks.count(key))
+                continue;
+            missing.push_back(key);
+        }
+    }
+
+    if (!missing.empty())
+    {
+        std::sort(missing.begin(), missing.end(), [&](uint64_t a, uint64_t b)
+            {
+                return ChunkDistance(a, centerChunk) < ChunkDistance(b, centerChunk);
+            });
+
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            for (uint64_t key : missing)
+            {
+                mQueue.push_back(key);
+                mRequested.insert(key);
+            }
+        }
+        mWake.notify_one();
+    }
+
+    return !outActivated.empty() || !outEvicted.empty();
+}
+
+const MapChunkCells* ChunkStreamer::GetChunk(uint64_t key) const
+{
+    const auto it = mResident.find(key);
+    return it != mResident.end() ? it->second.get() : nullptr;
+}
+
+const MapChunkCells* ChunkStreamer::FindCellChunk(int x, int y) const
+{
+    if (!mMap)
+        return nullptr;
+
+    return GetChunk(MakeChunkKey(FloorDiv(x, mMap->chunkW), FloorDiv(y, mMap->chunkH)));
+}
+
+bool ChunkStreamer::IsBlocked(int x, int y) const
+{
+    const MapChunkCells* cells = FindCellChunk(x, y);
+    if (!cells)
+        return true;
+
+    const size_t index = (size_t)(y - cells->originY) * cells->width + (x - cells->originX);
+    return cells->collision[index] != 0;
+}
+
+ChunkStreamerStats ChunkStreamer::GetStats() const
+{
+    ChunkStreamerStats stats{};
+    stats.resident = mResident.size();
+    stats.pending = mRequested.size();
+    stats.loadedTotal = mLoadedTotal;
+    stats.evictedTotal = mEvictedTotal;
+
+    std::lock_guard<std::mutex> lock(mMutex);
+    stats.decodeMsTotal = mDecodeMsTotal;
+    return stats;
+}
@@ -0,0 +1,127 @@
+#pragma once
+
+#include <glm/glm.hpp>
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "TmxLoader.h"
+
+// Decoded cells of one chunk of an infinite map. Layers absent in the chunk are all 0.
+struct MapChunkCells
+{
+    int chunkX = 0;
+    int chunkY = 0;
+    int originX = 0; // first cell (Tiled tile coordinates)
+    int originY = 0;
+    int width = 0;
+    int height = 0;
+
+    size_t layerCount = 0;          // MapData::layers.size()
+    std::vector<uint32_t> gids;     // layer-major, layerCount * width * height
+    std::vector<uint8_t> collision; // collision layer | blocking tile flags, always width * height
+
+    ArrayView<uint32_t> GetLayerGids(size_t layer) const
+    {
+        const size_t cells = (size_t)width * (size_t)height;
+        return ArrayView<uint32_t>(gids.data() + layer * cells, cells);
+    }
+};
+
+struct ChunkStreamerStats
+{
+    size_t resident = 0;
+    size_t pending = 0;       // queued, decoding or waiting for activation
+    size_t loadedTotal = 0;
+    size_t evictedTotal = 0;
+    double decodeMsTotal = 0.0;
+};
+
+/*
+    ChunkStreamer
+    -------------
+    Residency for infinite (chunked) maps. MapData only holds encoded
+    chunks; the streamer keeps the ones within loadRadius chunks of the
+    player decoded:
+
+      - Update() queues missing chunks (nearest first) for a worker thread,
+        which decodes the layers and derives collision.
+      - Decoded chunks are activated on the main thread, at most
+        maxActivations per Update, and reported through outActivated so
+        the caller can build meshes without a burst of GL uploads.
+      - Chunks further than loadRadius + 1 are evicted (the extra ring is
+        hysteresis, so walking along a chunk border does not thrash) and
+        reported through outEvicted.
+
+    Cells of chunks that aren't resident count as blocked. The MapData
+    passed to Start() must stay alive and unchanged until Stop().
+*/
+class ChunkStreamer
+{
+public:
+    ChunkStreamer() = default;
+    ~ChunkStreamer();
+
+    ChunkStreamer(const ChunkStreamer&) = delete;
+    ChunkStreamer& operator=(const ChunkStreamer&) = delete;
+
+    void Start(const MapData& mapData, int loadRadius);
+    void Stop();
+
+    bool IsActive() const { return mMap != nullptr; }
+
+    // Decode and activate the chunks within `radius` of centerCell on the
+    // calling thread (map load / spawn, before the first frame).
+    void Prime(const glm::ivec2& centerCell, int radius, std::vector<uint64_t>& outActivated);
+
+    // Main thread, once per frame. Returns true when the resident set changed.
+    bool Update(const glm::ivec2& centerCell, int maxActivations,
+        std::vector<uint64_t>& outActivated, std::vector<uint64_t>& outEvicted);
+
+    const MapChunkCells* GetChunk(uint64_t key) const;
+
+    bool IsResident(int x, int y) const { return FindCellChunk(x, y) != nullptr; }
+    bool IsBlocked(int x, int y) const;
+
+    ChunkStreamerStats GetStats() const;
+
+private:
+    const MapChunkCells* FindCellChunk(int x, int y) const;
+
+    bool IsWithin(uint64_t key, const glm::ivec2& centerChunk, int radius) const;
+
+    std::unique_ptr<MapChunkCells> DecodeChunk(uint64_t key) const;
+
+    void BuildBlockingTable();
+    void WorkerLoop();
+
+private:
+    const MapData* mMap = nullptr;
+    int mLoadRadius = 2;
+
+    // Gid -> blocking tile flag, read-only while the worker runs.
+    std::vector<uint8_t> mBlockingGids;
+
+    // Main thread only
+    std::unordered_map<uint64_t, std::unique_ptr<MapChunkCells>> mResident;
+    std::unordered_set<uint64_t> mRequested; // queued, decoding, decoded or ready
+    std::vector<std::unique_ptr<MapChunkCells>> mReady; // decoded, waiting for activation
+    size_t mLoadedTotal = 0;
+    size_t mEvictedTotal = 0;
+
+    // Shared with the worker
+    std::thread mWorker;
+    mutable std::mutex mMutex;
+    std::condition_variable mWake;
+    std::deque<uint64_t> mQueue;
+    std::vector<std::unique_ptr<MapChunkCells>> mDecoded;
+    double mDecodeMsTotal = 0.0;
+    bool mStopping = false;
+};
@@ -0,0 +1,117 @@
+#include "FileWatcher.h"
+
+#include <algorithm>
+#include <filesystem>
+#include <iostream>
+
+#ifdef __linux__
+#include <sys/inotify.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstring>
+#endif
+
+FileWatcher::~FileWatcher()
+{
+    Stop();
+}
+
+bool FileWatcher::Start()
+{
+    Stop();
+
+#ifdef __linux__
+    mFd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (mFd < 0)
+    {
+        std::cerr << "inotify_init1 failed: " << std::strerror(errno) << "\n";
+        return false;
+    }
+    return true;
+#else
+    std::cerr << "File watching is not supported on this platform\n";
+    return false;
+#endif
+}
+
+void FileWatcher::Stop()
+{
+#ifdef __linux__
+    if (mFd >= 0)
+        close(mFd);
+#endif
+    mFd = -1;
+    mWatches.clear();
+    mDirectories.clear();
+}
+
+bool FileWatcher::WatchDirectoryOf(const std::string& path)
+{
+    if (mFd < 0 || path.empty())
+        return false;
+
+    std::error_code ec;
+    std::filesystem::path directory = std::filesystem::is_directory(path, ec)
+        ? std::filesystem::path(path) : std::filesystem::path(path).parent_path();
+    if (directory.empty())
+        directory = ".";
+
+    const std::string key = std::filesystem::weakly_canonical(directory, ec).generic_string();
+    if (ec || !mDirectories.insert(key).second)
+        return !ec;
+
+#ifdef __linux__
+    const int wd = inotify_add_watch(mFd, key.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO);
+    if (wd < 0)
+    {
+        std::cerr << "Cannot watch '" << key << "': " << std::strerror(errno) << "\n";
+        mDirectories.erase(key);
+        return false;
+    }
+
+    // The path the client spelled, so callers can compare against their own paths.
+    mWatches.push_back({ wd, directory.lexically_normal().generic_string() });
+    return true;
+#else
+    return false;
+#endif
+}
+
+bool FileWatcher::Poll(std::vector<std::string>& outChanged)
+{
+    outChanged.clear();
+
+#ifdef __linux__
+    if (mFd < 0)
+        return false;
+
+    alignas(inotify_event) char buffer[16 * 1024];
+    for (;;)
+    {
+        const ssize_t length = read(mFd, buffer, sizeof(buffer));
+        if (length <= 0)
+            break; // EAGAIN: drained
+
+        for (ssize_t offset = 0; offset < length;)
+        {
+            const inotify_event* event = reinterpret_cast<const inotify_event*>(buffer + offset);
+            offset += (ssize_t)sizeof(inotify_event) + event->len;
+
+            if (event->len == 0 || (event->mask & IN_ISDIR))
+                continue;
+
+            const auto watch = std::find_if(mWatches.begin(), mWatches.end(),
+                [&](const Watch& w) { return w.wd == event->wd; });
+            if (watch == mWatches.end())
+                continue;
+
+            std::string changed = watch->directory + "/" + event->name;
+            if (std::find(outChanged.begin(), outChanged.end(), changed) == outChanged.end())
+                outChanged.push_back(std::move(changed));
+        }
+    }
+#endif
+
+    return !outChanged.empty();
+}
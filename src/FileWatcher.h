@@ -0,0 +1,53 @@
+#pragma once
+
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+/*
+    FileWatcher
+    -----------
+    Non-blocking change notifications for the hot reload of debug builds
+    (see main.cpp): watch the directories a map's files live in, then
+    Poll() once per frame for the files written since the last call.
+
+    Directories, not files: Tiled and most image editors save through a
+    temporary file renamed over the original, which would silently end a
+    per-file watch. A completed write (close after write) and a rename
+    into the directory both count as a change.
+
+    inotify on Linux; elsewhere Start() fails and the watcher stays idle.
+*/
+class FileWatcher
+{
+public:
+    FileWatcher() = default;
+    ~FileWatcher();
+
+    FileWatcher(const FileWatcher&) = delete;
+    FileWatcher& operator=(const FileWatcher&) = delete;
+
+    bool Start();
+    void Stop();
+
+    bool IsActive() const { return mFd >= 0; }
+
+    // Adds a watch on path's directory (or path itself if it is one).
+    // Directories already watched are skipped.
+    bool WatchDirectoryOf(const std::string& path);
+
+    // Files changed since the last call, each once, as
+    // "<watched directory>/<name>". Returns false when there were none.
+    bool Poll(std::vector<std::string>& outChanged);
+
+private:
+    struct Watch
+    {
+        int wd = -1;
+        std::string directory;
+    };
+
+    int mFd = -1;
+    std::vector<Watch> mWatches;
+    std::unordered_set<std::string> mDirectories;
+};
@@ -57,11 +57,13 @@ struct MapTransitionDef {
 };
 
 struct RenderingConfig {
-    bool spriteBatching = true;
+    bool spriteBatching = true;     // false: one draw per sprite (SpriteRenderMode::Immediate)
     bool useTextureAtlas = true;
     bool yDepthSorting = true;
     bool shadowPass = true;
     bool lightingLayer = false;
+    int textureBudgetMiB = 512;     // VRAM for tileset textures before LRU eviction
+    float textureScale = 1.0f;      // screen px per world px; picks the tile texture resolution variant
 };
 
 // 2) Character system
@@ -0,0 +1,24 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+/*
+    ImageSource
+    -----------
+    Pre-decoded RGBA8 pixels by image path (as written in TilesetDef):
+    a cooked MapBundle, or a map staged by MapPreloader. Texture loading
+    asks the source first and only decodes the file when it has no entry.
+*/
+class ImageSource
+{
+public:
+    virtual ~ImageSource() = default;
+
+    virtual bool FindImage(const std::string& path, const uint8_t*& outRgba, int& outWidth, int& outHeight) const = 0;
+
+    // HashPixels() of the image FindImage() returns, when the source has
+    // it at hand (cooked or computed off the main thread). False = hash
+    // the pixels yourself.
+    virtual bool FindImageHash(const std::string& /*path*/, uint64_t& /*outHash*/) const { return false; }
+};
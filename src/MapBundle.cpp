@@ -0,0 +1,754 @@
+#include "MapBundle.h"
+
+#include "PixelHash.h"
+
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <unordered_map>
+
+namespace
+{
+    constexpr size_t kSectionAlign = 64;
+
+    size_t AlignUp(size_t value, size_t align)
+    {
+        return (value + align - 1) & ~(align - 1);
+    }
+
+    // Deduplicated NUL-terminated strings; offset 0 is always "".
+    class StringTable
+    {
+    public:
+        StringTable() { mBytes.push_back('\0'); }
+
+        uint32_t Add(const std::string& value)
+        {
+            if (value.empty())
+                return 0;
+
+            auto it = mOffsets.find(value);
+            if (it != mOffsets.end())
+                return it->second;
+
+            const uint32_t offset = (uint32_t)mBytes.size();
+            mBytes.insert(mBytes.end(), value.begin(), value.end());
+            mBytes.push_back('\0');
+            mOffsets.emplace(value, offset);
+            return offset;
+        }
+
+        const std::vector<char>& Bytes() const { return mBytes; }
+
+    private:
+        std::vector<char> mBytes;
+        std::unordered_map<std::string, uint32_t> mOffsets;
+    };
+
+    class BundleBuilder
+    {
+    public:
+        BundleBuilder() { mBytes.resize(sizeof(MapBundleHeader)); }
+
+        template <typename T>
+        void AddSection(BundleSection section, const std::vector<T>& records)
+        {
+            AddSection(section, records.data(), records.size() * sizeof(T));
+        }
+
+        void AddSection(BundleSection section, const void* data, size_t size)
+        {
+            mBytes.resize(AlignUp(mBytes.size(), kSectionAlign), 0);
+
+            BundleSectionEntry& entry = mHeader.sections[(size_t)section];
+            entry.offset = mBytes.size();
+            entry.size = size;
+
+            if (size > 0)
+            {
+                const uint8_t* bytes = static_cast<const uint8_t*>(data);
+                mBytes.insert(mBytes.end(), bytes, bytes + size);
+            }
+        }
+
+        // Pixels go last; each image starts on a section-aligned offset.
+        // An image identical to one already written (records' contentHash
+        // set, then compared byte for byte) points at the earlier copy.
+        void AddPixels(const std::vector<BundleImageSource>& images, std::vector<BundleImage>& records,
+            BundleWriteStats& stats)
+        {
+            mBytes.resize(AlignUp(mBytes.size(), kSectionAlign), 0);
+            const size_t sectionStart = mBytes.size();
+
+            std::unordered_multimap<uint64_t, size_t> written; // content hash -> image index
+            for (size_t i = 0; i < images.size(); ++i)
+            {
+                const auto range = written.equal_range(records[i].contentHash);
+                const auto same = std::find_if(range.first, range.second, [&](const auto& entry)
+                    {
+                        const BundleImageSource& other = images[entry.second];
+                        return other.width == images[i].width && other.height == images[i].height
+                            && other.rgba == images[i].rgba;
+                    });
+                if (same != range.second)
+                {
+                    records[i].pixelOffset = records[same->second].pixelOffset;
+                    records[i].pixelSize = records[same->second].pixelSize;
+                    ++stats.dedupedImages;
+                    stats.dedupedBytes += images[i].rgba.size();
+                    continue;
+                }
+                written.emplace(records[i].contentHash, i);
+
+                mBytes.resize(AlignUp(mBytes.size(), kSectionAlign), 0);
+                records[i].pixelOffset = mBytes.size();
+                records[i].pixelSize = images[i].rgba.size();
+                mBytes.insert(mBytes.end(), images[i].rgba.begin(), images[i].rgba.end());
+            }
+
+            BundleSectionEntry& entry = mHeader.sections[(size_t)BundleSection::Pixels];
+            entry.offset = sectionStart;
+            entry.size = mBytes.size() - sectionStart;
+        }
+
+        // Image records point into Pixels, so they are patched in after it.
+        void PatchSection(BundleSection section, const void* data, size_t size)
+        {
+            const BundleSectionEntry& entry = mHeader.sections[(size_t)section];
+            std::memcpy(mBytes.data() + entry.offset, data, size);
+        }
+
+        bool Write(const std::string& path)
+        {
+            std::memcpy(mBytes.data(), &mHeader, sizeof(mHeader));
+
+            std::ofstream out(path, std::ios::binary | std::ios::trunc);
+            if (!out)
+                return false;
+
+            out.write(reinterpret_cast<const char*>(mBytes.data()), (std::streamsize)mBytes.size());
+            return (bool)out;
+        }
+
+        size_t Size() const { return mBytes.size(); }
+
+    private:
+        MapBundleHeader mHeader{};
+        std::vector<uint8_t> mBytes;
+    };
+
+    std::vector<uint8_t> MakeCellFlags(const MapData& mapData)
+    {
+        std::vector<uint8_t> flags(mapData.tileFlags.size(), 0);
+        for (size_t i = 0; i < flags.size(); ++i)
+        {
+            const TilePropertyFlags& cell = mapData.tileFlags[i];
+            flags[i] = (uint8_t)((cell.blocking ? kCellBlocking : 0)
+                | (cell.water ? kCellWater : 0)
+                | (cell.slow ? kCellSlow : 0));
+        }
+        return flags;
+    }
+}
+
+std::string GetMapBundlePath(const std::string& tmxPath)
+{
+    return std::filesystem::path(tmxPath).replace_extension(".monb").string();
+}
+
+bool WriteMapBundle(const std::string& bundlePath, const MapData& mapData,
+    const std::vector<BundleImageSource>& images, const std::vector<std::string>& sourcePaths,
+    BundleWriteStats* outStats)
+{
+    // Bundles store dense layers; infinite maps stay on the TMX + ChunkStreamer path.
+    if (mapData.infinite)
+    {
+        std::cerr << "Infinite (chunked) maps cannot be cooked into a bundle\n";
+        return false;
+    }
+
+    StringTable strings;
+
+    BundleInfo info{};
+    info.width = mapData.width;
+    info.height = mapData.height;
+    info.tileW = mapData.tileW;
+    info.tileH = mapData.tileH;
+
+    // --- Tilesets (+ their per-tile tables)
+    std::vector<BundleTileset> tilesets;
+    std::vector<BundleTileImage> tileImages;
+    std::vector<BundleAnimation> animations;
+    std::vector<AnimationFrame> frames;
+    std::vector<BundleTileFlags> tileFlags;
+
+    for (const TilesetDef& def : mapData.tilesets)
+    {
+        BundleTileset record{};
+        record.firstGid = def.firstGid;
+        record.tileCount = def.tileCount;
+        record.columns = def.columns;
+        record.tileW = def.tileW;
+        record.tileH = def.tileH;
+        record.imageW = def.imageW;
+        record.imageH = def.imageH;
+        record.imagePath = strings.Add(def.imagePath);
+        record.isImageCollection = def.isImageCollection ? 1u : 0u;
+
+        record.firstTileImage = (uint32_t)tileImages.size();
+        for (const auto& entry : def.tileImages)
+        {
+            const TileImageDef& image = entry.second;
+            tileImages.push_back({ entry.first, image.w, image.h, strings.Add(image.path),
+                { image.trimX, image.trimY, image.trimW, image.trimH } });
+        }
+        record.tileImageCount = (uint32_t)tileImages.size() - record.firstTileImage;
+
+        record.firstAnimation = (uint32_t)animations.size();
+        for (const auto& entry : def.animations)
+        {
+            BundleAnimation animation{};
+            animation.tileId = entry.first;
+            animation.totalDurationMs = entry.second.totalDurationMs;
+            animation.firstFrame = (uint32_t)frames.size();
+            animation.frameCount = (uint32_t)entry.second.frames.size();
+            frames.insert(frames.end(), entry.second.frames.begin(), entry.second.frames.end());
+            animations.push_back(animation);
+        }
+        record.animationCount = (uint32_t)animations.size() - record.firstAnimation;
+
+        record.firstTileFlags = (uint32_t)tileFlags.size();
+        for (const auto& entry : def.tileFlags)
+        {
+            BundleTileFlags flags{};
+            flags.tileId = entry.first;
+            flags.blocking = entry.second.blocking ? 1 : 0;
+            flags.water = entry.second.water ? 1 : 0;
+            flags.slow = entry.second.slow ? 1 : 0;
+            tileFlags.push_back(flags);
+        }
+        record.tileFlagsCount = (uint32_t)tileFlags.size() - record.firstTileFlags;
+
+        tilesets.push_back(record);
+    }
+
+    // --- Objects
+    std::vector<BundleObjectInstance> instances;
+    instances.reserve(mapData.objectInstances.size());
+    for (const MapObjectInstance& instance : mapData.objectInstances)
+    {
+        BundleObjectInstance record{};
+        record.tileIndex = instance.tileIndex;
+        record.worldPos[0] = instance.worldPos.x;
+        record.worldPos[1] = instance.worldPos.y;
+        record.size[0] = instance.size.x;
+        record.size[1] = instance.size.y;
+        record.name = strings.Add(instance.name);
+        record.type = strings.Add(instance.type);
+        instances.push_back(record);
+    }
+
+    std::vector<BundleObject> objects;
+    std::vector<BundleProperty> properties;
+    for (const MapObject& object : mapData.objects)
+    {
+        BundleObject record{};
+        record.id = object.id;
+        record.name = strings.Add(object.name);
+        record.type = strings.Add(object.type);
+        record.positionPx[0] = object.positionPx.x;
+        record.positionPx[1] = object.positionPx.y;
+        record.sizePx[0] = object.sizePx.x;
+        record.sizePx[1] = object.sizePx.y;
+        record.firstProperty = (uint32_t)properties.size();
+        for (const auto& prop : object.properties)
+            properties.push_back({ strings.Add(prop.first), strings.Add(prop.second) });
+        record.propertyCount = (uint32_t)properties.size() - record.firstProperty;
+        objects.push_back(record);
+    }
+
+    std::vector<BundleDoor> doors;
+    for (const DoorDef& door : mapData.doors)
+    {
+        BundleDoor record{};
+        record.posPx[0] = door.posPx.x;
+        record.posPx[1] = door.posPx.y;
+        record.sizePx[0] = door.sizePx.x;
+        record.sizePx[1] = door.sizePx.y;
+        record.targetMap = strings.Add(door.targetMap);
+        record.targetSpawn = strings.Add(door.targetSpawn);
+        doors.push_back(record);
+    }
+
+    std::vector<BundleSpawn> spawns;
+    for (const SpawnDef& spawn : mapData.spawns)
+    {
+        BundleSpawn record{};
+        record.name = strings.Add(spawn.name);
+        record.posPx[0] = spawn.posPx.x;
+        record.posPx[1] = spawn.posPx.y;
+        spawns.push_back(record);
+    }
+
+    // --- Images (pixel offsets are filled in by AddPixels)
+    std::vector<BundleImage> imageRecords(images.size());
+    for (size_t i = 0; i < images.size(); ++i)
+    {
+        const BundleImageSource& image = images[i];
+        if ((size_t)image.width * image.height * 4 != image.rgba.size())
+        {
+            std::cerr << "Bundle image '" << image.path << "' has the wrong pixel size\n";
+            return false;
+        }
+
+        imageRecords[i].path = strings.Add(image.path);
+        imageRecords[i].width = image.width;
+        imageRecords[i].height = image.height;
+        imageRecords[i].contentHash = HashPixels(image.rgba.data(), image.width, image.height);
+    }
+
+    std::vector<BundleSource> sources;
+    for (const std::string& path : sourcePaths)
+    {
+        std::error_code ec;
+        const auto writeTime = std::filesystem::last_write_time(path, ec);
+        if (ec)
+        {
+            std::cerr << "Bundle source '" << path << "' can't be read: " << ec.message() << "\n";
+            return false;
+        }
+
+        BundleSource record{};
+        record.path = strings.Add(path);
+        record.writeTime = (int64_t)writeTime.time_since_epoch().count();
+        sources.push_back(record);
+    }
+
+    std::vector<BundleLayer> layers;
+    for (const MapLayerDef& layer : mapData.layers)
+    {
+        BundleLayer record{};
+        record.name = strings.Add(layer.name);
+        record.pass = (uint32_t)layer.pass;
+        record.visible = layer.visible ? 1 : 0;
+        layers.push_back(record);
+    }
+
+    const std::vector<uint8_t> cellFlags = MakeCellFlags(mapData);
+
+    BundleBuilder builder;
+    builder.AddSection(BundleSection::Info, &info, sizeof(info));
+    builder.AddSection(BundleSection::Layers, layers);
+    builder.AddSection(BundleSection::LayerGids, mapData.layerGids);
+    builder.AddSection(BundleSection::Collision, mapData.collision);
+    builder.AddSection(BundleSection::CellFlags, cellFlags);
+    builder.AddSection(BundleSection::Tilesets, tilesets);
+    builder.AddSection(BundleSection::TileImages, tileImages);
+    builder.AddSection(BundleSection::Animations, animations);
+    builder.AddSection(BundleSection::AnimationFrames, frames);
+    builder.AddSection(BundleSection::TileFlags, tileFlags);
+    builder.AddSection(BundleSection::ObjectInstances, instances);
+    builder.AddSection(BundleSection::Objects, objects);
+    builder.AddSection(BundleSection::Properties, properties);
+    builder.AddSection(BundleSection::Doors, doors);
+    builder.AddSection(BundleSection::Spawns, spawns);
+    builder.AddSection(BundleSection::Images, imageRecords);
+    builder.AddSection(BundleSection::Sources, sources);
+    builder.AddSection(BundleSection::Strings, strings.Bytes());
+    BundleWriteStats stats;
+    builder.AddPixels(images, imageRecords, stats);
+    builder.PatchSection(BundleSection::Images, imageRecords.data(), imageRecords.size() * sizeof(BundleImage));
+
+    if (!builder.Write(bundlePath))
+    {
+        std::cerr << "Failed to write bundle: " << bundlePath << "\n";
+        return false;
+    }
+
+    if (outStats)
+        *outStats = stats;
+    return true;
+}
+
+bool MapBundle::ValidateSection(BundleSection section, size_t recordSize, size_t recordAlign) const
+{
+    const BundleSectionEntry& entry = mHeader->sections[(size_t)section];
+
+    if (entry.offset > mFile.Size() || entry.size > mFile.Size() - entry.offset)
+        return false;
+    if (entry.offset % recordAlign != 0 || entry.size % recordSize != 0)
+        return false;
+
+    return true;
+}
+
+bool MapBundle::Open(const std::string& bundlePath)
+{
+    Close();
+
+    if (!mFile.Open(bundlePath))
+        return false;
+
+    if (mFile.Size() < sizeof(MapBundleHeader))
+    {
+        std::cerr << "Bundle too small: " << bundlePath << "\n";
+        Close();
+        return false;
+    }
+
+    const MapBundleHeader* header = reinterpret_cast<const MapBundleHeader*>(mFile.Data());
+    if (header->magic != kMapBundleMagic || header->version != kMapBundleVersion
+        || header->sectionCount != (uint32_t)BundleSection::Count)
+    {
+        std::cerr << "Bundle '" << bundlePath << "' has an unsupported header (version "
+            << header->version << ", expected " << kMapBundleVersion << ")\n";
+        Close();
+        return false;
+    }
+
+    mHeader = header;
+
+    struct Layout
+    {
+        BundleSection section;
+        size_t size;
+        size_t align;
+    };
+
+    const Layout layouts[] = {
+        { BundleSection::Info, sizeof(BundleInfo), alignof(BundleInfo) },
+        { BundleSection::Layers, sizeof(BundleLayer), alignof(BundleLayer) },
+        { BundleSection::LayerGids, sizeof(uint32_t), alignof(uint32_t) },
+        { BundleSection::Collision, 1, 1 },
+        { BundleSection::CellFlags, 1, 1 },
+        { BundleSection::Tilesets, sizeof(BundleTileset), alignof(BundleTileset) },
+        { BundleSection::TileImages, sizeof(BundleTileImage), alignof(BundleTileImage) },
+        { BundleSection::Animations, sizeof(BundleAnimation), alignof(BundleAnimation) },
+        { BundleSection::AnimationFrames, sizeof(AnimationFrame), alignof(AnimationFrame) },
+        { BundleSection::TileFlags, sizeof(BundleTileFlags), alignof(BundleTileFlags) },
+        { BundleSection::ObjectInstances, sizeof(BundleObjectInstance), alignof(BundleObjectInstance) },
+        { BundleSection::Objects, sizeof(BundleObject), alignof(BundleObject) },
+        { BundleSection::Properties, sizeof(BundleProperty), alignof(BundleProperty) },
+        { BundleSection::Doors, sizeof(BundleDoor), alignof(BundleDoor) },
+        { BundleSection::Spawns, sizeof(BundleSpawn), alignof(BundleSpawn) },
+        { BundleSection::Images, sizeof(BundleImage), alignof(BundleImage) },
+        { BundleSection::Sources, sizeof(BundleSource), alignof(BundleSource) },
+        { BundleSection::Strings, 1, 1 },
+        { BundleSection::Pixels, 1, 1 },
+    };
+
+    for (const Layout& layout : layouts)
+    {
+        if (!ValidateSection(layout.section, layout.size, layout.align))
+        {
+            std::cerr << "Bundle '" << bundlePath << "' section " << (uint32_t)layout.section << " is out of bounds\n";
+            Close();
+            return false;
+        }
+    }
+
+    const ArrayView<BundleInfo> info = GetSection<BundleInfo>(BundleSection::Info);
+    const ArrayView<char> stringBytes = GetSection<char>(BundleSection::Strings);
+    if (info.size() != 1 || stringBytes.empty() || stringBytes[stringBytes.size() - 1] != '\0')
+    {
+        std::cerr << "Bundle '" << bundlePath << "' is missing map info or strings\n";
+        Close();
+        return false;
+    }
+
+    mInfo = &info[0];
+
+    // Cell layers are either absent or exactly width * height (per tile layer for the gids).
+    const size_t cellCount = (size_t)std::max(0, mInfo->width) * (size_t)std::max(0, mInfo->height);
+    const size_t cellSizes[] = {
+        GetCollision().size(), GetSection<uint8_t>(BundleSection::CellFlags).size()
+    };
+    for (size_t size : cellSizes)
+    {
+        if (size != 0 && size != cellCount)
+        {
+            std::cerr << "Bundle '" << bundlePath << "' has a layer of the wrong size\n";
+            Close();
+            return false;
+        }
+    }
+
+    if (GetLayerGids().size() != GetSection<BundleLayer>(BundleSection::Layers).size() * cellCount)
+    {
+        std::cerr << "Bundle '" << bundlePath << "' tile layers don't match the map size\n";
+        Close();
+        return false;
+    }
+
+    return true;
+}
+
+void MapBundle::Close()
+{
+    mFile.Close();
+    mHeader = nullptr;
+    mInfo = nullptr;
+}
+
+const char* MapBundle::GetString(uint32_t ref) const
+{
+    const ArrayView<char> bytes = GetSection<char>(BundleSection::Strings);
+    return ref < bytes.size() ? bytes.data() + ref : "";
+}
+
+bool MapBundle::FindImage(const std::string& path, const uint8_t*& outRgba, int& outWidth, int& outHeight) const
+{
+    if (!IsOpen())
+        return false;
+
+    const BundleSectionEntry& pixels = mHeader->sections[(size_t)BundleSection::Pixels];
+
+    for (const BundleImage& image : GetSection<BundleImage>(BundleSection::Images))
+    {
+        if (path != GetString(image.path))
+            continue;
+
+        const uint64_t expected = (uint64_t)image.width * (uint64_t)image.height * 4u;
+        if (image.width <= 0 || image.height <= 0 || image.pixelSize != expected
+            || image.pixelOffset < pixels.offset
+            || image.pixelOffset + image.pixelSize > pixels.offset + pixels.size)
+        {
+            std::cerr << "Bundle image '" << path << "' is corrupt\n";
+            return false;
+        }
+
+        outRgba = mFile.Data() + image.pixelOffset;
+        outWidth = image.width;
+        outHeight = image.height;
+        return true;
+    }
+
+    return false;
+}
+
+bool MapBundle::FindImageHash(const std::string& path, uint64_t& outHash) const
+{
+    if (!IsOpen())
+        return false;
+
+    for (const BundleImage& image : GetSection<BundleImage>(BundleSection::Images))
+    {
+        if (path == GetString(image.path))
+        {
+            outHash = image.contentHash;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+bool MapBundle::FindChangedSource(std::string& outPath) const
+{
+    if (!IsOpen())
+        return false;
+
+    for (const BundleSource& source : GetSection<BundleSource>(BundleSection::Sources))
+    {
+        std::error_code ec;
+        const char* path = GetString(source.path);
+        const auto writeTime = std::filesystem::last_write_time(path, ec);
+        if (ec || (int64_t)writeTime.time_since_epoch().count() != source.writeTime)
+        {
+            outPath = path;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+bool MapBundle::ToLoadedMap(LoadedMap& outMap) const
+{
+    outMap = LoadedMap{};
+    if (!IsOpen())
+        return false;
+
+    MapData& mapData = outMap.mapData;
+    mapData.width = mInfo->width;
+    mapData.height = mInfo->height;
+    mapData.tileW = mInfo->tileW;
+    mapData.tileH = mInfo->tileH;
+
+    // Gid / collision arrays stay in the mapping (see MapView).
+    for (const BundleLayer& record : GetSection<BundleLayer>(BundleSection::Layers))
+    {
+        if (record.pass >= (uint32_t)LayerPass::Count)
+        {
+            std::cerr << "Bundle layer table is corrupt\n";
+            return false;
+        }
+
+        MapLayerDef layer;
+        layer.name = GetString(record.name);
+        layer.pass = (LayerPass)record.pass;
+        layer.visible = record.visible != 0;
+        mapData.layers.push_back(std::move(layer));
+    }
+
+    for (uint8_t bits : GetSection<uint8_t>(BundleSection::CellFlags))
+    {
+        TilePropertyFlags flags{};
+        flags.blocking = (bits & kCellBlocking) != 0;
+        flags.water = (bits & kCellWater) != 0;
+        flags.slow = (bits & kCellSlow) != 0;
+        mapData.tileFlags.push_back(flags);
+    }
+
+    const ArrayView<BundleTileImage> tileImages = GetSection<BundleTileImage>(BundleSection::TileImages);
+    const ArrayView<BundleAnimation> animations = GetSection<BundleAnimation>(BundleSection::Animations);
+    const ArrayView<AnimationFrame> frames = GetSection<AnimationFrame>(BundleSection::AnimationFrames);
+    const ArrayView<BundleTileFlags> tileFlags = GetSection<BundleTileFlags>(BundleSection::TileFlags);
+
+    auto InRange = [](uint32_t first, uint32_t count, size_t size)
+        {
+            return first <= size && count <= size - first;
+        };
+
+    for (const BundleTileset& record : GetSection<BundleTileset>(BundleSection::Tilesets))
+    {
+        if (!InRange(record.firstTileImage, record.tileImageCount, tileImages.size())
+            || !InRange(record.firstAnimation, record.animationCount, animations.size())
+            || !InRange(record.firstTileFlags, record.tileFlagsCount, tileFlags.size()))
+        {
+            std::cerr << "Bundle tileset table is corrupt\n";
+            return false;
+        }
+
+        TilesetDef def{};
+        def.firstGid = record.firstGid;
+        def.tileCount = record.tileCount;
+        def.columns = record.columns;
+        def.tileW = record.tileW;
+        def.tileH = record.tileH;
+        def.imagePath = GetString(record.imagePath);
+        def.imageW = record.imageW;
+        def.imageH = record.imageH;
+        def.isImageCollection = record.isImageCollection != 0;
+
+        for (uint32_t i = 0; i < record.tileImageCount; ++i)
+        {
+            const BundleTileImage& image = tileImages[record.firstTileImage + i];
+            def.tileImages[image.tileId] = TileImageDef{ GetString(image.path), image.w, image.h,
+                image.trim[0], image.trim[1], image.trim[2], image.trim[3] };
+        }
+
+        for (uint32_t i = 0; i < record.animationCount; ++i)
+        {
+            const BundleAnimation& animation = animations[record.firstAnimation + i];
+            if (!InRange(animation.firstFrame, animation.frameCount, frames.size()))
+            {
+                std::cerr << "Bundle animation table is corrupt\n";
+                return false;
+            }
+
+            TileAnimation& out = def.animations[animation.tileId];
+            out.totalDurationMs = animation.totalDurationMs;
+            out.frames.assign(frames.begin() + animation.firstFrame,
+                frames.begin() + animation.firstFrame + animation.frameCount);
+        }
+
+        for (uint32_t i = 0; i < record.tileFlagsCount; ++i)
+        {
+            const BundleTileFlags& flags = tileFlags[record.firstTileFlags + i];
+            def.tileFlags[flags.tileId] = TilePropertyFlags{ flags.blocking != 0, flags.water != 0, flags.slow != 0 };
+        }
+
+        mapData.tilesets.push_back(std::move(def));
+    }
+
+    for (const BundleObjectInstance& record : GetSection<BundleObjectInstance>(BundleSection::ObjectInstances))
+    {
+        MapObjectInstance instance{};
+        instance.tileIndex = record.tileIndex;
+        instance.worldPos = { record.worldPos[0], record.worldPos[1] };
+        instance.size = { record.size[0], record.size[1] };
+        instance.name = GetString(record.name);
+        instance.type = GetString(record.type);
+        mapData.objectInstances.push_back(std::move(instance));
+    }
+
+    const ArrayView<BundleProperty> properties = GetSection<BundleProperty>(BundleSection::Properties);
+    for (const BundleObject& record : GetSection<BundleObject>(BundleSection::Objects))
+    {
+        if (!InRange(record.firstProperty, record.propertyCount, properties.size()))
+        {
+            std::cerr << "Bundle object table is corrupt\n";
+            return false;
+        }
+
+        MapObject object{};
+        object.id = record.id;
+        object.name = GetString(record.name);
+        object.type = GetString(record.type);
+        object.positionPx = { record.positionPx[0], record.positionPx[1] };
+        object.sizePx = { record.sizePx[0], record.sizePx[1] };
+        for (uint32_t i = 0; i < record.propertyCount; ++i)
+        {
+            const BundleProperty& prop = properties[record.firstProperty + i];
+            object.properties[GetString(prop.key)] = GetString(prop.value);
+        }
+        mapData.objects.push_back(std::move(object));
+    }
+
+    for (const BundleDoor& record : GetSection<BundleDoor>(BundleSection::Doors))
+    {
+        DoorDef door{};
+        door.posPx = { record.posPx[0], record.posPx[1] };
+        door.sizePx = { record.sizePx[0], record.sizePx[1] };
+        door.targetMap = GetString(record.targetMap);
+        door.targetSpawn = GetString(record.targetSpawn);
+        mapData.doors.push_back(std::move(door));
+    }
+
+    for (const BundleSpawn& record : GetSection<BundleSpawn>(BundleSection::Spawns))
+    {
+        SpawnDef spawn{};
+        spawn.name = GetString(record.name);
+        spawn.posPx = { record.posPx[0], record.posPx[1] };
+        mapData.spawns.push_back(std::move(spawn));
+    }
+
+    return true;
+}
+
+bool LoadMapPreferBundle(const std::string& tmxPath, LoadedMap& outMap, MapBundle& outBundle)
+{
+    outBundle.Close();
+
+    const std::string bundlePath = GetMapBundlePath(tmxPath);
+
+    std::error_code ec;
+    if (std::filesystem::exists(bundlePath, ec))
+    {
+        std::string changedPath;
+        if (!outBundle.Open(bundlePath))
+        {
+            std::cerr << "Bundle " << bundlePath << " unusable, loading TMX\n";
+        }
+        else if (outBundle.FindChangedSource(changedPath))
+        {
+            std::cout << "Bundle " << bundlePath << " is out of date (" << changedPath << " changed), loading TMX\n";
+            outBundle.Close();
+        }
+        else if (outBundle.ToLoadedMap(outMap))
+        {
+            std::cout << "Bundle loaded: " << bundlePath << " (" << outBundle.GetFileSize() / 1024 << " KB mapped)\n";
+            return true;
+        }
+        else
+        {
+            std::cerr << "Bundle " << bundlePath << " unusable, loading TMX\n";
+            outBundle.Close();
+        }
+    }
+
+    return LoadTmxMap(tmxPath, outMap);
+}
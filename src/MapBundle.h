@@ -0,0 +1,300 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "ArrayView.h"
+#include "ImageSource.h"
+#include "MappedFile.h"
+#include "TmxLoader.h"
+
+/*
+    MapBundle
+    ---------
+    Cooked map: a .tmx, its tilesets and every image they reference in one
+    file, written offline by mon_cook (tools/MapCooker.cpp).
+
+    Layout (little-endian):
+        MapBundleHeader                (magic, version, section table)
+        sections, 64-byte aligned      (arrays of the POD records below)
+
+    All offsets are from the start of the file. Strings are byte offsets
+    into the Strings section (NUL-terminated). Images are decoded RGBA8,
+    so loading is one mmap: no XML, no CSV, no PNG decode.
+*/
+
+constexpr uint32_t kMapBundleMagic = 0x424E4F4Du; // "MONB"
+// 2: tile image trim rects, 3: image content hashes, 4: N tile layers,
+// 5: sources, 6: XXH64 content hashes
+constexpr uint32_t kMapBundleVersion = 6;
+
+enum class BundleSection : uint32_t
+{
+    Info,
+    Layers,          // BundleLayer
+    LayerGids,       // uint32_t gid per cell per layer, layer-major
+    Collision,       // uint8_t per cell
+    CellFlags,       // uint8_t per cell (BundleCellFlag bits)
+    Tilesets,        // BundleTileset
+    TileImages,      // BundleTileImage
+    Animations,      // BundleAnimation
+    AnimationFrames, // AnimationFrame
+    TileFlags,       // BundleTileFlags
+    ObjectInstances, // BundleObjectInstance
+    Objects,         // BundleObject
+    Properties,      // BundleProperty
+    Doors,           // BundleDoor
+    Spawns,          // BundleSpawn
+    Images,          // BundleImage
+    Sources,         // BundleSource
+    Strings,         // char
+    Pixels,          // RGBA8 texel data referenced by BundleImage
+
+    Count
+};
+
+struct BundleSectionEntry
+{
+    uint64_t offset = 0;
+    uint64_t size = 0;
+};
+
+struct MapBundleHeader
+{
+    uint32_t magic = kMapBundleMagic;
+    uint32_t version = kMapBundleVersion;
+    uint32_t sectionCount = (uint32_t)BundleSection::Count;
+    uint32_t reserved = 0;
+    BundleSectionEntry sections[(size_t)BundleSection::Count];
+};
+
+enum BundleCellFlag : uint8_t
+{
+    kCellBlocking = 1 << 0,
+    kCellWater = 1 << 1,
+    kCellSlow = 1 << 2
+};
+
+struct BundleInfo
+{
+    int32_t width = 0;
+    int32_t height = 0;
+    int32_t tileW = 0;
+    int32_t tileH = 0;
+};
+
+struct BundleLayer
+{
+    uint32_t name = 0;
+    uint32_t pass = 0;    // LayerPass
+    uint32_t visible = 1;
+    uint32_t reserved = 0;
+};
+
+struct BundleTileset
+{
+    int32_t firstGid = 1;
+    int32_t tileCount = 0;
+    int32_t columns = 0;
+    int32_t tileW = 0;
+    int32_t tileH = 0;
+    int32_t imageW = 0;
+    int32_t imageH = 0;
+    uint32_t imagePath = 0;
+    uint32_t isImageCollection = 0;
+    uint32_t firstTileImage = 0;
+    uint32_t tileImageCount = 0;
+    uint32_t firstAnimation = 0;
+    uint32_t animationCount = 0;
+    uint32_t firstTileFlags = 0;
+    uint32_t tileFlagsCount = 0;
+};
+
+struct BundleTileImage
+{
+    int32_t tileId = 0;
+    int32_t w = 0;
+    int32_t h = 0;
+    uint32_t path = 0;
+    int32_t trim[4] = {}; // x, y, w, h in TSX pixels (w == 0: untrimmed)
+};
+
+struct BundleAnimation
+{
+    int32_t tileId = 0;
+    int32_t totalDurationMs = 0;
+    uint32_t firstFrame = 0;
+    uint32_t frameCount = 0;
+};
+
+struct BundleTileFlags
+{
+    int32_t tileId = 0;
+    uint8_t blocking = 0;
+    uint8_t water = 0;
+    uint8_t slow = 0;
+    uint8_t pad = 0;
+};
+
+struct BundleObjectInstance
+{
+    uint32_t tileIndex = 0;
+    float worldPos[2] = {};
+    float size[2] = {};
+    uint32_t name = 0;
+    uint32_t type = 0;
+};
+
+struct BundleObject
+{
+    int32_t id = 0;
+    uint32_t name = 0;
+    uint32_t type = 0;
+    float positionPx[2] = {};
+    float sizePx[2] = {};
+    uint32_t firstProperty = 0;
+    uint32_t propertyCount = 0;
+};
+
+struct BundleProperty
+{
+    uint32_t key = 0;
+    uint32_t value = 0;
+};
+
+struct BundleDoor
+{
+    float posPx[2] = {};
+    float sizePx[2] = {};
+    uint32_t targetMap = 0;
+    uint32_t targetSpawn = 0;
+};
+
+struct BundleSpawn
+{
+    uint32_t name = 0;
+    float posPx[2] = {};
+};
+
+struct BundleImage
+{
+    uint32_t path = 0;
+    int32_t width = 0;
+    int32_t height = 0;
+    uint32_t reserved = 0;
+    uint64_t pixelOffset = 0; // from file start, RGBA8, rows top to bottom; shared by identical images
+    uint64_t pixelSize = 0;
+    uint64_t contentHash = 0; // HashPixels()
+};
+
+// A file the bundle was cooked from (TMX, TSX, image) and its write time
+// then, so the client can tell when any of them changed since.
+struct BundleSource
+{
+    uint32_t path = 0;
+    uint32_t reserved = 0;
+    int64_t writeTime = 0; // std::filesystem::file_time_type ticks
+};
+
+// Decoded image handed to the cooker's writer.
+struct BundleImageSource
+{
+    std::string path;
+    int width = 0;
+    int height = 0;
+    std::vector<uint8_t> rgba;
+};
+
+struct BundleWriteStats
+{
+    size_t dedupedImages = 0; // images whose pixels were already stored under another path
+    size_t dedupedBytes = 0;
+};
+
+// Writes mapData + images as a bundle. Image paths must match the paths
+// stored in the tileset defs (that's how the client looks them up).
+// Identical pixels are stored once and shared by their records.
+// sourcePaths: the files it was cooked from; their write times are
+// recorded for FindChangedSource().
+bool WriteMapBundle(const std::string& bundlePath, const MapData& mapData,
+    const std::vector<BundleImageSource>& images, const std::vector<std::string>& sourcePaths = {},
+    BundleWriteStats* outStats = nullptr);
+
+// "maps/foo.tmx" -> "maps/foo.monb"
+std::string GetMapBundlePath(const std::string& tmxPath);
+
+class MapBundle : public ImageSource
+{
+public:
+    MapBundle() = default;
+
+    MapBundle(const MapBundle&) = delete;
+    MapBundle& operator=(const MapBundle&) = delete;
+
+    MapBundle(MapBundle&& other) noexcept { *this = std::move(other); }
+    MapBundle& operator=(MapBundle&& other) noexcept
+    {
+        if (this != &other)
+        {
+            mFile = std::move(other.mFile);
+            mHeader = other.mHeader;
+            mInfo = other.mInfo;
+            other.mHeader = nullptr;
+            other.mInfo = nullptr;
+        }
+        return *this;
+    }
+
+    // Maps the file and validates header + section bounds; nothing is copied.
+    bool Open(const std::string& bundlePath);
+    void Close();
+
+    bool IsOpen() const { return mHeader != nullptr; }
+    size_t GetFileSize() const { return mFile.Size(); }
+
+    const BundleInfo& GetInfo() const { return *mInfo; }
+
+    // Every layer's gids back to back, as MapData::layerGids.
+    ArrayView<uint32_t> GetLayerGids() const { return GetSection<uint32_t>(BundleSection::LayerGids); }
+    ArrayView<uint8_t> GetCollision() const { return GetSection<uint8_t>(BundleSection::Collision); }
+
+    // "" for an out-of-range reference.
+    const char* GetString(uint32_t ref) const;
+
+    // RGBA8 pixels of a cooked image, pointing into the mapping.
+    bool FindImage(const std::string& path, const uint8_t*& outRgba, int& outWidth, int& outHeight) const override;
+    bool FindImageHash(const std::string& path, uint64_t& outHash) const override;
+
+    // True (with the path) when a file the bundle was cooked from is gone
+    // or has another write time than when it was cooked.
+    bool FindChangedSource(std::string& outPath) const;
+
+    // Rebuild the in-memory MapData the TMX loader would have produced,
+    // minus the gid / collision arrays (the layer defs are filled in):
+    // read those through MapView.
+    bool ToLoadedMap(LoadedMap& outMap) const;
+
+private:
+    template <typename T>
+    ArrayView<T> GetSection(BundleSection section) const
+    {
+        const BundleSectionEntry& entry = mHeader->sections[(size_t)section];
+        return ArrayView<T>(reinterpret_cast<const T*>(mFile.Data() + entry.offset),
+            (size_t)(entry.size / sizeof(T)));
+    }
+
+    bool ValidateSection(BundleSection section, size_t recordSize, size_t recordAlign) const;
+
+    MappedFile mFile;
+    const MapBundleHeader* mHeader = nullptr;
+    const BundleInfo* mInfo = nullptr;
+};
+
+// Load tmxPath through its cooked bundle when one exists and none of the
+// files it was cooked from (.tmx, .tsx, images) changed since (re-run
+// mon_cook after editing them), else through LoadTmxMap. outBundle stays
+// open for texture lookups.
+bool LoadMapPreferBundle(const std::string& tmxPath, LoadedMap& outMap, MapBundle& outBundle);
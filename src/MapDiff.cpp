@@ -0,0 +1,163 @@
+#include "MapDiff.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace
+{
+    template <typename Map, typename Equal>
+    bool MapsEqual(const Map& a, const Map& b, Equal equal)
+    {
+        if (a.size() != b.size())
+            return false;
+
+        for (const auto& [key, value] : a)
+        {
+            const auto it = b.find(key);
+            if (it == b.end() || !equal(value, it->second))
+                return false;
+        }
+        return true;
+    }
+
+    template <typename T, typename Equal>
+    bool VectorsEqual(const std::vector<T>& a, const std::vector<T>& b, Equal equal)
+    {
+        return a.size() == b.size() && std::equal(a.begin(), a.end(), b.begin(), equal);
+    }
+
+    bool FlagsEqual(const TilePropertyFlags& a, const TilePropertyFlags& b)
+    {
+        return a.blocking == b.blocking && a.water == b.water && a.slow == b.slow;
+    }
+
+    bool TileImagesEqual(const TileImageDef& a, const TileImageDef& b)
+    {
+        return a.path == b.path && a.w == b.w && a.h == b.h
+            && a.trimX == b.trimX && a.trimY == b.trimY && a.trimW == b.trimW && a.trimH == b.trimH;
+    }
+
+    bool AnimationsEqual(const TileAnimation& a, const TileAnimation& b)
+    {
+        return a.totalDurationMs == b.totalDurationMs
+            && VectorsEqual(a.frames, b.frames, [](const AnimationFrame& x, const AnimationFrame& y)
+                {
+                    return x.tileId == y.tileId && x.durationMs == y.durationMs;
+                });
+    }
+
+    bool TilesetsEqual(const TilesetDef& a, const TilesetDef& b)
+    {
+        return a.firstGid == b.firstGid && a.tileCount == b.tileCount && a.columns == b.columns
+            && a.tileW == b.tileW && a.tileH == b.tileH
+            && a.imagePath == b.imagePath && a.imageW == b.imageW && a.imageH == b.imageH
+            && a.isImageCollection == b.isImageCollection && a.sourcePath == b.sourcePath
+            && MapsEqual(a.tileImages, b.tileImages, TileImagesEqual)
+            && MapsEqual(a.animations, b.animations, AnimationsEqual)
+            && MapsEqual(a.tileFlags, b.tileFlags, FlagsEqual);
+    }
+
+    bool ObjectsEqual(const MapData& a, const MapData& b)
+    {
+        const bool objects = VectorsEqual(a.objects, b.objects, [](const MapObject& x, const MapObject& y)
+            {
+                return x.id == y.id && x.name == y.name && x.type == y.type
+                    && x.positionPx == y.positionPx && x.sizePx == y.sizePx && x.properties == y.properties;
+            });
+        const bool instances = VectorsEqual(a.objectInstances, b.objectInstances,
+            [](const MapObjectInstance& x, const MapObjectInstance& y)
+            {
+                return x.tileIndex == y.tileIndex && x.worldPos == y.worldPos && x.size == y.size
+                    && x.name == y.name && x.type == y.type;
+            });
+        const bool doors = VectorsEqual(a.doors, b.doors, [](const DoorDef& x, const DoorDef& y)
+            {
+                return x.posPx == y.posPx && x.sizePx == y.sizePx
+                    && x.targetMap == y.targetMap && x.targetSpawn == y.targetSpawn;
+            });
+        const bool spawns = VectorsEqual(a.spawns, b.spawns, [](const SpawnDef& x, const SpawnDef& y)
+            {
+                return x.name == y.name && x.posPx == y.posPx;
+            });
+        return objects && instances && doors && spawns;
+    }
+
+    // Equal runs are skipped a block at a time; an edit touches few cells.
+    void DiffLayer(const std::vector<uint32_t>& live, const std::vector<uint32_t>& edited, std::vector<uint32_t>& outCells)
+    {
+        constexpr size_t kBlock = 64;
+
+        outCells.clear();
+        const size_t count = live.size();
+        for (size_t begin = 0; begin < count; begin += kBlock)
+        {
+            const size_t end = std::min(count, begin + kBlock);
+            if (std::memcmp(live.data() + begin, edited.data() + begin, (end - begin) * sizeof(uint32_t)) == 0)
+                continue;
+
+            for (size_t i = begin; i < end; ++i)
+            {
+                if (live[i] != edited[i])
+                    outCells.push_back((uint32_t)i);
+            }
+        }
+    }
+
+    // The TileMap's layer list (and its chunk storage) follows the defs, so any change is a layout change.
+    bool SameLayers(const MapData& a, const MapData& b)
+    {
+        const bool defs = VectorsEqual(a.layers, b.layers, [](const MapLayerDef& x, const MapLayerDef& y)
+            {
+                return x.name == y.name && x.pass == y.pass && x.visible == y.visible;
+            });
+        return defs && a.layerGids.size() == b.layerGids.size()
+            && a.collision.size() == b.collision.size() && a.tileFlags.size() == b.tileFlags.size();
+    }
+}
+
+void DiffMaps(const MapData& live, const MapData& edited, MapDiff& outDiff)
+{
+    outDiff = MapDiff{};
+
+    if (live.infinite || edited.infinite
+        || live.width != edited.width || live.height != edited.height
+        || live.tileW != edited.tileW || live.tileH != edited.tileH
+        || !SameLayers(live, edited))
+    {
+        outDiff.layoutChanged = true;
+        return;
+    }
+
+    outDiff.tilesetsChanged = !VectorsEqual(live.tilesets, edited.tilesets, TilesetsEqual);
+    outDiff.collisionChanged = live.collision != edited.collision
+        || !VectorsEqual(live.tileFlags, edited.tileFlags, FlagsEqual);
+    outDiff.objectsChanged = !ObjectsEqual(live, edited);
+
+    DiffLayer(live.layerGids, edited.layerGids, outDiff.layerCells);
+}
+
+void ApplyMapDiff(MapData& live, MapData& edited, const MapDiff& diff)
+{
+    if (diff.layoutChanged)
+        return;
+
+    for (uint32_t cell : diff.layerCells)
+        live.layerGids[cell] = edited.layerGids[cell];
+
+    if (diff.collisionChanged)
+    {
+        std::copy(edited.collision.begin(), edited.collision.end(), live.collision.begin());
+        std::copy(edited.tileFlags.begin(), edited.tileFlags.end(), live.tileFlags.begin());
+    }
+
+    if (diff.tilesetsChanged)
+        live.tilesets = std::move(edited.tilesets);
+
+    if (diff.objectsChanged)
+    {
+        live.objects = std::move(edited.objects);
+        live.objectInstances = std::move(edited.objectInstances);
+        live.doors = std::move(edited.doors);
+        live.spawns = std::move(edited.spawns);
+    }
+}
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "TmxLoader.h"
+
+/*
+    MapDiff
+    -------
+    What changed between the live map and a fresh parse of its TMX, for
+    the hot reload of debug builds. The gid layers are compared cell by
+    cell so only the chunks holding an edit are rebuilt; the rest (tileset
+    defs, collision, objects) is only flagged, since replacing it whole is
+    cheap next to what it triggers.
+
+    A layout change (size, tile size, infinite, a layer added, removed,
+    renamed, reordered or moved to another pass) can't be applied in
+    place: the caller reloads the map instead.
+*/
+struct MapDiff
+{
+    bool layoutChanged = false;
+    bool tilesetsChanged = false;  // any def: images, animations, tile flags, firstGid
+    bool collisionChanged = false; // collision or per-cell tile flags
+    bool objectsChanged = false;   // objects, tile objects, doors or spawns
+
+    // Indices into MapData::layerGids (layer * width * height + y * width + x) whose gid differs.
+    std::vector<uint32_t> layerCells;
+
+    bool IsEmpty() const
+    {
+        return !layoutChanged && !tilesetsChanged && !collisionChanged && !objectsChanged
+            && layerCells.empty();
+    }
+};
+
+// Dense (TMX-backed) maps only; an infinite map on either side is a layout change.
+void DiffMaps(const MapData& live, const MapData& edited, MapDiff& outDiff);
+
+// Moves edited's changes into live (diff must not be a layout change).
+// The gid, collision and cell flag arrays are overwritten in place, so
+// MapViews / TileMaps pointing into live stay valid.
+void ApplyMapDiff(MapData& live, MapData& edited, const MapDiff& diff);
@@ -0,0 +1,332 @@
+#include "MapPreloader.h"
+
+#include "AssetFiles.h"
+#include "PixelHash.h"
+#include "TextureRegistry.h"
+#include "TextureVariants.h"
+#include "TileReferences.h"
+#include "stb_image.h"
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <sstream>
+
+namespace
+{
+    // Every image a map's tilesets load up front, with its expected size: the
+    // TSX image for sheets, the selected resolution variant for the collection
+    // tiles the map references (all of them without referencedGids).
+    struct TilesetImage
+    {
+        std::string path;
+        int width;
+        int height;
+    };
+
+    std::vector<TilesetImage> CollectTilesetImages(const MapData& mapData, const std::vector<uint8_t>* referencedGids,
+        float textureScale, const ImageSource* source)
+    {
+        std::vector<TilesetImage> images;
+        std::unordered_set<std::string> seen;
+
+        auto Add = [&](const std::string& path, int width, int height)
+            {
+                if (!path.empty() && seen.insert(path).second)
+                    images.push_back({ path, width, height });
+            };
+
+        for (const TilesetDef& def : mapData.tilesets)
+        {
+            if (!def.isImageCollection)
+                Add(def.imagePath, def.imageW, def.imageH);
+
+            for (const auto& entry : def.tileImages)
+            {
+                if (referencedGids && !IsGidReferenced(*referencedGids, static_cast<uint32_t>(def.firstGid + entry.first)))
+                    continue;
+
+                int width = 0, height = 0;
+                const std::string path = SelectTextureVariant(entry.second.path, entry.second.w, entry.second.h,
+                    textureScale, source, width, height);
+                Add(path, width, height);
+            }
+        }
+        return images;
+    }
+}
+
+bool DecodedImages::FindImage(const std::string& path, const uint8_t*& outRgba, int& outWidth, int& outHeight) const
+{
+    const auto it = mImages.find(path);
+    if (it == mImages.end())
+        return false;
+
+    outRgba = it->second.rgba.data();
+    outWidth = it->second.width;
+    outHeight = it->second.height;
+    return true;
+}
+
+bool DecodedImages::FindImageHash(const std::string& path, uint64_t& outHash) const
+{
+    const auto it = mImages.find(path);
+    if (it == mImages.end())
+        return false;
+
+    outHash = it->second.contentHash;
+    return true;
+}
+
+void DecodedImages::Add(const std::string& path, int width, int height, std::vector<uint8_t> rgba)
+{
+    mBytes += rgba.size();
+    const uint64_t hash = HashPixels(rgba.data(), width, height);
+    mImages[path] = Image{ width, height, hash, std::move(rgba) };
+}
+
+MapPreloader::MapPreloader(size_t budgetBytes, float textureScale)
+    : mBudgetBytes(budgetBytes)
+    , mTextureScale(textureScale)
+{
+    mWorker = std::thread(&MapPreloader::WorkerLoop, this);
+}
+
+MapPreloader::~MapPreloader()
+{
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        mStopping = true;
+        mQueue.clear();
+    }
+    mWake.notify_all();
+    mWorker.join();
+}
+
+bool MapPreloader::IsKnownLocked(const std::string& path) const
+{
+    if (mInFlight == path || mStaged.count(path) || mRejected.count(path))
+        return true;
+
+    return std::any_of(mQueue.begin(), mQueue.end(), [&](const Job& job) { return job.path == path; });
+}
+
+void MapPreloader::Request(const std::string& mapPath, bool urgent, const std::unordered_set<std::string>& residentImages)
+{
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+
+        auto queued = std::find_if(mQueue.begin(), mQueue.end(), [&](const Job& job) { return job.path == mapPath; });
+        if (queued != mQueue.end())
+        {
+            if (urgent && queued != mQueue.begin())
+            {
+                Job job = std::move(*queued);
+                mQueue.erase(queued);
+                mQueue.push_front(std::move(job));
+            }
+            return;
+        }
+
+        mWanted.insert(mapPath);
+        if (IsKnownLocked(mapPath))
+            return;
+
+        Job job{ mapPath, residentImages };
+        if (urgent)
+            mQueue.push_front(std::move(job));
+        else
+            mQueue.push_back(std::move(job));
+    }
+    mWake.notify_one();
+}
+
+void MapPreloader::Retain(const std::vector<std::string>& mapPaths)
+{
+    const std::unordered_set<std::string> keep(mapPaths.begin(), mapPaths.end());
+
+    std::lock_guard<std::mutex> lock(mMutex);
+    mWanted = keep;
+
+    for (auto it = mStaged.begin(); it != mStaged.end();)
+    {
+        if (keep.count(it->first))
+        {
+            ++it;
+            continue;
+        }
+        mStagedBytes -= it->second->bytes;
+        it = mStaged.erase(it);
+    }
+
+    mQueue.erase(std::remove_if(mQueue.begin(), mQueue.end(),
+        [&](const Job& job) { return !keep.count(job.path); }), mQueue.end());
+
+    for (auto it = mRejected.begin(); it != mRejected.end();)
+        it = keep.count(*it) ? std::next(it) : mRejected.erase(it);
+}
+
+bool MapPreloader::Take(const std::string& mapPath, StagedMap& outStaged)
+{
+    std::unique_lock<std::mutex> lock(mMutex);
+    mStagedCond.wait(lock, [&]() { return mInFlight != mapPath; });
+
+    auto it = mStaged.find(mapPath);
+    if (it == mStaged.end())
+    {
+        mQueue.erase(std::remove_if(mQueue.begin(), mQueue.end(),
+            [&](const Job& job) { return job.path == mapPath; }), mQueue.end());
+        ++mMisses;
+        return false;
+    }
+
+    mStagedBytes -= it->second->bytes;
+    outStaged = std::move(*it->second);
+    mStaged.erase(it);
+    ++mHits;
+    return true;
+}
+
+size_t MapPreloader::EstimateBytes(const StagedMap& staged, const std::unordered_set<std::string>& residentImages) const
+{
+    if (staged.bundle.IsOpen())
+        return staged.bundle.GetFileSize();
+
+    const MapData& mapData = staged.map.mapData;
+    size_t bytes = mapData.layerGids.size() * sizeof(uint32_t) + mapData.collision.size();
+    for (const auto& entry : mapData.chunks)
+    {
+        for (const MapChunkLayer& layer : entry.second.layers)
+            bytes += layer.data.size();
+        bytes += entry.second.collision.data.size();
+    }
+
+    for (const TilesetImage& image : CollectTilesetImages(mapData, &staged.referencedGids, mTextureScale, nullptr))
+    {
+        if (!residentImages.count(TextureRegistry::CanonicalPath(image.path)))
+            bytes += (size_t)std::max(0, image.width) * (size_t)std::max(0, image.height) * 4;
+    }
+    return bytes;
+}
+
+bool MapPreloader::Stage(const Job& job, StagedMap& outStaged, size_t budgetLeft) const
+{
+    outStaged.path = job.path;
+    if (!LoadMapPreferBundle(job.path, outStaged.map, outStaged.bundle))
+        return false;
+
+    CollectReferencedGids(outStaged.map.mapData, &outStaged.bundle, outStaged.referencedGids);
+
+    outStaged.bytes = EstimateBytes(outStaged, job.residentImages);
+    if (outStaged.bytes > budgetLeft)
+        return false;
+
+    const std::vector<TilesetImage> images = CollectTilesetImages(outStaged.map.mapData, &outStaged.referencedGids, mTextureScale,
+        outStaged.bundle.IsOpen() ? &outStaged.bundle : nullptr);
+
+    if (outStaged.bundle.IsOpen())
+    {
+        // Fault the cooked pixels in now rather than during the upload.
+        volatile uint8_t sink = 0;
+        for (const TilesetImage& image : images)
+        {
+            const uint8_t* rgba = nullptr;
+            int width = 0, height = 0;
+            if (!outStaged.bundle.FindImage(image.path, rgba, width, height))
+                continue;
+
+            const size_t size = (size_t)width * (size_t)height * 4;
+            for (size_t offset = 0; offset < size; offset += 4096)
+                sink = sink + rgba[offset];
+        }
+        return true;
+    }
+
+    stbi_set_flip_vertically_on_load_thread(0);
+    for (const TilesetImage& image : images)
+    {
+        if (job.residentImages.count(TextureRegistry::CanonicalPath(image.path)))
+            continue;
+
+        int width = 0, height = 0;
+        unsigned char* decoded = LoadAssetImage(image.path, width, height);
+        if (!decoded)
+            continue; // the transition reports it
+
+        outStaged.images.Add(image.path, width, height,
+            std::vector<uint8_t>(decoded, decoded + (size_t)width * (size_t)height * 4));
+        stbi_image_free(decoded);
+    }
+
+    outStaged.bytes = std::max(outStaged.bytes, outStaged.images.GetBytes());
+    return true;
+}
+
+void MapPreloader::WorkerLoop()
+{
+    for (;;)
+    {
+        Job job;
+        size_t budgetLeft = 0;
+        {
+            std::unique_lock<std::mutex> lock(mMutex);
+            mWake.wait(lock, [this]() { return mStopping || !mQueue.empty(); });
+            if (mStopping)
+                return;
+
+            job = std::move(mQueue.front());
+            mQueue.pop_front();
+            mInFlight = job.path;
+            budgetLeft = mBudgetBytes - std::min(mStagedBytes, mBudgetBytes);
+        }
+
+        const auto start = std::chrono::steady_clock::now();
+        auto staged = std::make_unique<StagedMap>();
+        const bool loaded = Stage(job, *staged, budgetLeft);
+        staged->stageMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+        std::ostringstream log;
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            mInFlight.clear();
+
+            if (loaded && !mWanted.count(job.path))
+            {
+                // Retain() dropped it while it was being staged.
+            }
+            else if (loaded)
+            {
+                log << "Preloaded " << job.path << " in " << staged->stageMs << " ms ("
+                    << staged->images.GetCount() << " images decoded, " << staged->bytes / 1024 << " KiB staged)\n";
+                mStagedBytes += staged->bytes;
+                mStaged[job.path] = std::move(staged);
+            }
+            else
+            {
+                if (staged->bytes > budgetLeft)
+                {
+                    log << "Preload of " << job.path << " skipped: needs " << staged->bytes / 1024
+                        << " KiB, " << budgetLeft / 1024 << " KiB of budget left\n";
+                    ++mOverBudget;
+                }
+                mRejected.insert(job.path);
+            }
+        }
+        mStagedCond.notify_all();
+        std::cout << log.str();
+    }
+}
+
+MapPreloaderStats MapPreloader::GetStats() const
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+
+    MapPreloaderStats stats{};
+    stats.staged = mStaged.size();
+    stats.stagedBytes = mStagedBytes;
+    stats.queued = mQueue.size() + (mInFlight.empty() ? 0 : 1);
+    stats.hits = mHits;
+    stats.misses = mMisses;
+    stats.overBudget = mOverBudget;
+    return stats;
+}
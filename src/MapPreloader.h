@@ -0,0 +1,147 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "ImageSource.h"
+#include "MapBundle.h"
+#include "TmxLoader.h"
+
+// RGBA8 images decoded off the main thread, by TilesetDef image path.
+class DecodedImages : public ImageSource
+{
+public:
+    bool FindImage(const std::string& path, const uint8_t*& outRgba, int& outWidth, int& outHeight) const override;
+    bool FindImageHash(const std::string& path, uint64_t& outHash) const override;
+
+    // Hashes the pixels here, on the preloader thread, so the registry doesn't have to.
+    void Add(const std::string& path, int width, int height, std::vector<uint8_t> rgba);
+
+    size_t GetCount() const { return mImages.size(); }
+    size_t GetBytes() const { return mBytes; }
+
+private:
+    struct Image
+    {
+        int width = 0;
+        int height = 0;
+        uint64_t contentHash = 0;
+        std::vector<uint8_t> rgba;
+    };
+
+    std::unordered_map<std::string, Image> mImages;
+    size_t mBytes = 0;
+};
+
+// A door target parsed and decoded ahead of the transition.
+struct StagedMap
+{
+    std::string path;
+    LoadedMap map;
+    MapBundle bundle;      // open when the map came from a .monb
+    DecodedImages images;  // TMX path: tileset images that weren't resident yet
+    std::vector<uint8_t> referencedGids; // CollectReferencedGids
+    size_t bytes = 0;      // charged against the preload budget
+    double stageMs = 0.0;
+
+    // Where the tileset textures' pixels come from.
+    const ImageSource* GetImages() const
+    {
+        if (bundle.IsOpen())
+            return &bundle;
+        return &images;
+    }
+};
+
+struct MapPreloaderStats
+{
+    size_t staged = 0;
+    size_t stagedBytes = 0;
+    size_t queued = 0;
+    size_t hits = 0;           // Take() found the map staged (or in flight)
+    size_t misses = 0;
+    size_t overBudget = 0;     // requests dropped by the budget
+};
+
+/*
+    MapPreloader
+    ------------
+    Stages door target maps on a worker thread, so a transition only has
+    to swap the map in and upload textures:
+
+      - Request() queues a map (urgent = front of the queue, e.g. the
+        player is standing next to its door).
+      - The worker loads it like LoadMapPreferBundle, collects its
+        referenced gids and decodes the tileset images those need that the
+        caller didn't report as already resident. A
+        bundle's pixels are in the mapping; the worker only touches them so
+        the transition doesn't page-fault.
+      - Retain() drops staged and queued maps that are no longer door
+        targets (called after each map change).
+      - Take() hands a staged map over; a map still being staged is waited
+        for, since finishing it is never slower than starting over.
+
+    Staged maps are charged (layers + decoded pixels) against budgetBytes;
+    a map that doesn't fit is not staged and loads on demand as before.
+    textureScale must match the TilesetRegistry's, so the worker decodes
+    the same resolution variants the transition will ask for.
+*/
+class MapPreloader
+{
+public:
+    explicit MapPreloader(size_t budgetBytes, float textureScale = 1.0f);
+    ~MapPreloader();
+
+    MapPreloader(const MapPreloader&) = delete;
+    MapPreloader& operator=(const MapPreloader&) = delete;
+
+    // residentImages: canonical paths the TextureRegistry already holds.
+    void Request(const std::string& mapPath, bool urgent, const std::unordered_set<std::string>& residentImages);
+    void Retain(const std::vector<std::string>& mapPaths);
+
+    bool Take(const std::string& mapPath, StagedMap& outStaged);
+
+    MapPreloaderStats GetStats() const;
+
+private:
+    struct Job
+    {
+        std::string path;
+        std::unordered_set<std::string> residentImages;
+    };
+
+    bool IsKnownLocked(const std::string& path) const;
+    size_t EstimateBytes(const StagedMap& staged, const std::unordered_set<std::string>& residentImages) const;
+    bool Stage(const Job& job, StagedMap& outStaged, size_t budgetLeft) const;
+
+    void WorkerLoop();
+
+private:
+    size_t mBudgetBytes = 0;
+    float mTextureScale = 1.0f;
+
+    std::thread mWorker;
+    mutable std::mutex mMutex;
+    std::condition_variable mWake;
+    std::condition_variable mStagedCond;
+
+    std::deque<Job> mQueue;
+    std::string mInFlight;
+    std::unordered_map<std::string, std::unique_ptr<StagedMap>> mStaged;
+    std::unordered_set<std::string> mWanted;   // requested since the last Retain()
+    std::unordered_set<std::string> mRejected; // over budget or failed, until Retain() forgets them
+    size_t mStagedBytes = 0;
+    size_t mHits = 0;
+    size_t mMisses = 0;
+    size_t mOverBudget = 0;
+    bool mStopping = false;
+};
@@ -0,0 +1,110 @@
+#pragma once
+
+#include <cstdint>
+
+#include "ArrayView.h"
+#include "ChunkStreamer.h"
+#include "MapBundle.h"
+#include "TmxLoader.h"
+
+/*
+    MapView
+    -------
+    Read-only view of a map's per-cell layers (gids + collision). Tile
+    layer i is GetLayerGids(i), in MapData::layers order.
+
+    From a MapBundle the arrays point straight into the memory mapping, so
+    nothing is copied and only the pages actually read become resident.
+    From a MapData (TMX path) they point into its vectors.
+
+    For an infinite map the dense layers are empty and cell queries go to
+    the ChunkStreamer: only resident chunks are inside, the rest is blocked.
+
+    The source must outlive the view (and every TileMap / PlayerController
+    reading through it). Absent layers are empty views.
+*/
+class MapView
+{
+public:
+    MapView() = default;
+
+    explicit MapView(const MapBundle& bundle)
+        : mWidth(bundle.GetInfo().width)
+        , mHeight(bundle.GetInfo().height)
+        , mTileW(bundle.GetInfo().tileW)
+        , mTileH(bundle.GetInfo().tileH)
+        , mLayerGids(bundle.GetLayerGids())
+        , mCollision(bundle.GetCollision())
+    {
+    }
+
+    explicit MapView(const MapData& mapData)
+        : mWidth(mapData.width)
+        , mHeight(mapData.height)
+        , mTileW(mapData.tileW)
+        , mTileH(mapData.tileH)
+        , mLayerGids(mapData.layerGids)
+        , mCollision(mapData.collision)
+    {
+    }
+
+    MapView(const MapData& mapData, const ChunkStreamer& chunks)
+        : MapView(mapData)
+    {
+        mChunks = &chunks;
+    }
+
+    // False for infinite maps (GetWidth / GetHeight are 0 there).
+    bool IsBounded() const { return mChunks == nullptr; }
+
+    int GetWidth() const { return mWidth; }
+    int GetHeight() const { return mHeight; }
+    int GetTileWidthPx() const { return mTileW; }
+    int GetTileHeightPx() const { return mTileH; }
+
+    size_t GetLayerCount() const
+    {
+        const size_t cells = (size_t)mWidth * (size_t)mHeight;
+        return cells > 0 ? mLayerGids.size() / cells : 0;
+    }
+
+    // Empty past the last layer (and for infinite maps).
+    ArrayView<uint32_t> GetLayerGids(size_t layer) const
+    {
+        const size_t cells = (size_t)mWidth * (size_t)mHeight;
+        if (layer >= GetLayerCount())
+            return {};
+        return ArrayView<uint32_t>(mLayerGids.data() + layer * cells, cells);
+    }
+
+    ArrayView<uint8_t> GetCollision() const { return mCollision; }
+
+    bool IsInside(int x, int y) const
+    {
+        if (mChunks)
+            return mChunks->IsResident(x, y);
+        return x >= 0 && x < mWidth && y >= 0 && y < mHeight;
+    }
+
+    // Outside the map counts as blocked; a map without collision never blocks.
+    bool IsBlocked(int x, int y) const
+    {
+        if (mChunks)
+            return mChunks->IsBlocked(x, y);
+        if (!IsInside(x, y))
+            return true;
+        const size_t index = (size_t)y * mWidth + x;
+        return index < mCollision.size() && mCollision[index] != 0;
+    }
+
+private:
+    int mWidth = 0;
+    int mHeight = 0;
+    int mTileW = 0;
+    int mTileH = 0;
+
+    ArrayView<uint32_t> mLayerGids;
+    ArrayView<uint8_t> mCollision;
+
+    const ChunkStreamer* mChunks = nullptr;
+};
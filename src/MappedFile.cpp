@@ -0,0 +1,179 @@
+#include "MappedFile.h"
+
+#include <algorithm>
+#include <iostream>
+#include <utility>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+MappedFile::~MappedFile()
+{
+    Close();
+}
+
+MappedFile::MappedFile(MappedFile&& other) noexcept
+{
+    *this = std::move(other);
+}
+
+MappedFile& MappedFile::operator=(MappedFile&& other) noexcept
+{
+    if (this != &other)
+    {
+        Close();
+
+        std::swap(mData, other.mData);
+        std::swap(mSize, other.mSize);
+#ifdef _WIN32
+        std::swap(mFile, other.mFile);
+        std::swap(mMapping, other.mMapping);
+#else
+        std::swap(mFd, other.mFd);
+#endif
+    }
+    return *this;
+}
+
+#ifdef _WIN32
+
+bool MappedFile::Open(const std::string& path)
+{
+    Close();
+
+    HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+        OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE)
+    {
+        std::cerr << "Failed to open '" << path << "' for mapping\n";
+        return false;
+    }
+
+    LARGE_INTEGER size{};
+    if (!GetFileSizeEx(file, &size) || size.QuadPart <= 0)
+    {
+        std::cerr << "Cannot map empty file '" << path << "'\n";
+        CloseHandle(file);
+        return false;
+    }
+
+    HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (!mapping)
+    {
+        std::cerr << "CreateFileMapping failed for '" << path << "'\n";
+        CloseHandle(file);
+        return false;
+    }
+
+    void* view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    if (!view)
+    {
+        std::cerr << "MapViewOfFile failed for '" << path << "'\n";
+        CloseHandle(mapping);
+        CloseHandle(file);
+        return false;
+    }
+
+    mFile = file;
+    mMapping = mapping;
+    mData = static_cast<const uint8_t*>(view);
+    mSize = static_cast<size_t>(size.QuadPart);
+    return true;
+}
+
+void MappedFile::Close()
+{
+    if (mData)
+        UnmapViewOfFile(mData);
+    if (mMapping)
+        CloseHandle(static_cast<HANDLE>(mMapping));
+    if (mFile)
+        CloseHandle(static_cast<HANDLE>(mFile));
+
+    mData = nullptr;
+    mSize = 0;
+    mFile = nullptr;
+    mMapping = nullptr;
+}
+
+void MappedFile::Prefetch(size_t offset, size_t size) const
+{
+    if (!mData || offset >= mSize || size == 0)
+        return;
+
+#if defined(_WIN32_WINNT) && _WIN32_WINNT >= 0x0602 // Windows 8
+    WIN32_MEMORY_RANGE_ENTRY range{};
+    range.VirtualAddress = const_cast<uint8_t*>(mData + offset);
+    range.NumberOfBytes = std::min(size, mSize - offset);
+    PrefetchVirtualMemory(GetCurrentProcess(), 1, &range, 0);
+#endif
+}
+
+#else
+
+bool MappedFile::Open(const std::string& path)
+{
+    Close();
+
+    const int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0)
+    {
+        std::cerr << "Failed to open '" << path << "' for mapping\n";
+        return false;
+    }
+
+    struct stat st {};
+    if (::fstat(fd, &st) != 0 || st.st_size <= 0)
+    {
+        std::cerr << "Cannot map empty file '" << path << "'\n";
+        ::close(fd);
+        return false;
+    }
+
+    void* view = ::mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+    if (view == MAP_FAILED)
+    {
+        std::cerr << "mmap failed for '" << path << "'\n";
+        ::close(fd);
+        return false;
+    }
+
+    mFd = fd;
+    mData = static_cast<const uint8_t*>(view);
+    mSize = static_cast<size_t>(st.st_size);
+    return true;
+}
+
+void MappedFile::Close()
+{
+    if (mData)
+        ::munmap(const_cast<uint8_t*>(mData), mSize);
+    if (mFd >= 0)
+        ::close(mFd);
+
+    mData = nullptr;
+    mSize = 0;
+    mFd = -1;
+}
+
+void MappedFile::Prefetch(size_t offset, size_t size) const
+{
+    if (!mData || offset >= mSize || size == 0)
+        return;
+
+    const size_t pageSize = static_cast<size_t>(::sysconf(_SC_PAGESIZE));
+    const size_t begin = offset & ~(pageSize - 1);
+    const size_t end = std::min(mSize, offset + size);
+    ::madvise(const_cast<uint8_t*>(mData) + begin, end - begin, MADV_WILLNEED);
+}
+
+#endif
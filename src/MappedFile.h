@@ -0,0 +1,50 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+/*
+    MappedFile
+    ----------
+    Read-only memory mapping of a whole file (mmap / MapViewOfFile).
+    Pages are faulted in by the OS as they are touched, so opening a large
+    file costs nothing until its bytes are read.
+
+    Move-only; the mapping is released with the object.
+*/
+class MappedFile
+{
+public:
+    MappedFile() = default;
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    MappedFile(MappedFile&& other) noexcept;
+    MappedFile& operator=(MappedFile&& other) noexcept;
+
+    bool Open(const std::string& path);
+    void Close();
+
+    bool IsOpen() const { return mData != nullptr; }
+
+    const uint8_t* Data() const { return mData; }
+    size_t Size() const { return mSize; }
+
+    // Hint that [offset, offset + size) is about to be read, so the OS
+    // reads it in one go instead of one fault (and readahead) at a time.
+    void Prefetch(size_t offset, size_t size) const;
+
+private:
+    const uint8_t* mData = nullptr;
+    size_t mSize = 0;
+
+#ifdef _WIN32
+    void* mFile = nullptr;    // HANDLE
+    void* mMapping = nullptr; // HANDLE
+#else
+    int mFd = -1;
+#endif
+};
@@ -0,0 +1,15 @@
+#include "PixelHash.h"
+
+#include <cstddef>
+
+// Header-only build of the xxHash that ships with zstd: no symbols shared
+// with (or clashing with) the zstd library's own copy.
+#define XXH_INLINE_ALL
+#include "common/xxhash.h"
+
+uint64_t HashPixels(const uint8_t* rgba, int width, int height)
+{
+    const size_t size = (size_t)width * (size_t)height * 4;
+    const uint64_t seed = ((uint64_t)(uint32_t)width << 32) | (uint32_t)height;
+    return XXH64(rgba, size, seed);
+}
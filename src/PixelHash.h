@@ -0,0 +1,19 @@
+#pragma once
+
+#include <cstdint>
+
+/*
+    Pixel hashing
+    -------------
+    Content key for decoded RGBA8 images, so pixels that came from
+    different files (a spritesheet copied into two tileset folders, two
+    identical brick variants) are stored and uploaded once: mon_cook
+    writes each distinct image into a bundle once, TextureRegistry hands
+    out the texture it already has.
+
+    64-bit XXH64 (the xxHash vendored with zstd, which leaves XXH3 out),
+    seeded with the size.
+    Not cryptographic; a collision between two same-sized images is the
+    only way it can be wrong.
+*/
+uint64_t HashPixels(const uint8_t* rgba, int width, int height);
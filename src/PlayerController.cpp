@@ -1,4 +1,5 @@
 #include "PlayerController.h"
+#include "MapView.h"
 #include "Player.h"
 
 #include <GLFW/glfw3.h>
@@ -13,22 +14,9 @@ PlayerController::PlayerController(Player& player)
 {
 }
 
-bool PlayerController::IsBlockedAt(
-    int tx, int ty,
-    int mapW, int mapH,
-    const std::vector<int>& collisionGrid
-) const
-{
-    if (tx < 0 || tx >= mapW || ty < 0 || ty >= mapH)
-        return true;
-
-    return collisionGrid[ty * mapW + tx] != 0;
-}
-
 bool PlayerController::CollidesAt(
     const glm::vec2& pos,
-    int mapW, int mapH,
-    const std::vector<int>& collisionGrid
+    const MapView& map
 ) const
 {
     glm::vec2 corners[4] =
@@ -44,7 +32,7 @@ bool PlayerController::CollidesAt(
         int tx = (int)std::floor(c.x);
         int ty = (int)std::floor(c.y);
 
-        if (IsBlockedAt(tx, ty, mapW, mapH, collisionGrid))
+        if (map.IsBlocked(tx, ty))
             return true;
     }
 
@@ -54,9 +42,7 @@ bool PlayerController::CollidesAt(
 void PlayerController::Update(
     GLFWwindow* window,
     float deltaTime,
-    int mapW,
-    int mapH,
-    const std::vector<int>& collisionGrid
+    const MapView& map
 )
 {
     // ------------------------------------
@@ -224,7 +210,7 @@ void PlayerController::Update(
         glm::vec2 testPos = pos;
         testPos.x += desiredMove.x;
 
-        if (!CollidesAt(testPos, mapW, mapH, collisionGrid))
+        if (!CollidesAt(testPos, map))
             pos.x = testPos.x;
     }
 
@@ -234,13 +220,16 @@ void PlayerController::Update(
         glm::vec2 testPos = pos;
         testPos.y += desiredMove.y;
 
-        if (!CollidesAt(testPos, mapW, mapH, collisionGrid))
+        if (!CollidesAt(testPos, map))
             pos.y = testPos.y;
     }
 
-    // Clamp within map bounds
-    pos.x = std::clamp(pos.x, 0.0f, (float)(mapW - 1));
-    pos.y = std::clamp(pos.y, 0.0f, (float)(mapH - 1));
+    // Clamp within map bounds (infinite maps: unloaded chunks already block)
+    if (map.IsBounded())
+    {
+        pos.x = std::clamp(pos.x, 0.0f, (float)(map.GetWidth() - 1));
+        pos.y = std::clamp(pos.y, 0.0f, (float)(map.GetHeight() - 1));
+    }
 
     auto SnapAxis = [](float& v)
     {
@@ -1,10 +1,11 @@
 #pragma once
 
 #include <glm/glm.hpp>
-#include <vector>
 
 struct GLFWwindow;
 
+class MapView;
+
 class Player;
 class PlayerController
 {
@@ -14,9 +15,7 @@ public:
     void Update(
         GLFWwindow* window,
         float deltaTime,
-        int mapW,
-        int mapH,
-        const std::vector<int>& collisionGrid
+        const MapView& map
     );
 
 private:
@@ -27,6 +26,5 @@ private:
     bool wasCtrlDown = false;
 
     // --- helpers ---
-    bool IsBlockedAt(int tx, int ty, int mapW, int mapH, const std::vector<int>& collisionGrid) const;
-    bool CollidesAt(const glm::vec2& pos, int mapW, int mapH, const std::vector<int>& collisionGrid) const;
+    bool CollidesAt(const glm::vec2& pos, const MapView& map) const;
 };
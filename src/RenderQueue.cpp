@@ -0,0 +1,267 @@
+#include "RenderQueue.h"
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+
+uint64_t RenderQueue::MakeSortKey(float depthKey, GLuint texture)
+{
+    // Map IEEE-754 bits to an unsigned integer with the same ordering:
+    // negatives flip all bits, positives flip the sign bit.
+    if (depthKey == 0.0f)
+        depthKey = 0.0f; // fold -0 into +0
+
+    uint32_t bits = 0;
+    std::memcpy(&bits, &depthKey, sizeof(bits));
+    bits = (bits & 0x80000000u) ? ~bits : (bits | 0x80000000u);
+
+    return (static_cast<uint64_t>(bits) << 32) | static_cast<uint64_t>(texture);
+}
+
+void RenderQueue::RadixSort(std::vector<KeyIndex>& keys, std::vector<KeyIndex>& scratch)
+{
+    const size_t count = keys.size();
+    if (count < 2)
+        return;
+
+    scratch.resize(count);
+
+    // One histogram per byte, gathered in a single pass.
+    size_t histograms[8][256] = {};
+    for (const KeyIndex& ki : keys)
+    {
+        for (int pass = 0; pass < 8; ++pass)
+            histograms[pass][(ki.key >> (pass * 8)) & 0xFF]++;
+    }
+
+    KeyIndex* src = keys.data();
+    KeyIndex* dst = scratch.data();
+
+    for (int pass = 0; pass < 8; ++pass)
+    {
+        size_t* histogram = histograms[pass];
+        const int shift = pass * 8;
+
+        // Every key shares this byte (e.g. the high bytes of texture ids).
+        if (histogram[(src[0].key >> shift) & 0xFF] == count)
+            continue;
+
+        size_t offset = 0;
+        for (int b = 0; b < 256; ++b)
+        {
+            const size_t n = histogram[b];
+            histogram[b] = offset;
+            offset += n;
+        }
+
+        for (size_t i = 0; i < count; ++i)
+        {
+            const KeyIndex& ki = src[i];
+            dst[histogram[(ki.key >> shift) & 0xFF]++] = ki;
+        }
+
+        std::swap(src, dst);
+    }
+
+    if (src != keys.data())
+        keys.swap(scratch);
+}
+
+void RenderQueue::ClearStatic()
+{
+    mStaticCmds.clear();
+    mStaticKeys.clear();
+    mStaticFree.clear();
+    mStaticFreeList.clear();
+    mStaticDepthAboveTop = 0.0f;
+    mStaticDepthAboveBottom = 0.0f;
+    mDrawList.clear();
+}
+
+uint32_t RenderQueue::PushStatic(const RenderCmd& cmd)
+{
+    mStaticCmds.push_back(cmd);
+    mStaticCmds.back().sortKey = MakeSortKey(cmd.depthKey, cmd.texture);
+    mStaticFree.push_back(0);
+    return static_cast<uint32_t>(mStaticCmds.size() - 1);
+}
+
+void RenderQueue::SortStatic()
+{
+    mStaticKeys.clear();
+    mStaticKeys.reserve(mStaticCmds.size());
+    for (size_t i = 0; i < mStaticCmds.size(); ++i)
+    {
+        if (!mStaticFree[i])
+            mStaticKeys.push_back({ mStaticCmds[i].sortKey, static_cast<uint32_t>(i) });
+    }
+
+    RadixSort(mStaticKeys, mKeysTmp);
+
+    mStaticDepthAboveTop = std::numeric_limits<float>::lowest();
+    mStaticDepthAboveBottom = std::numeric_limits<float>::max();
+    for (size_t i = 0; i < mStaticCmds.size(); ++i)
+    {
+        if (!mStaticFree[i])
+            GrowStaticBounds(mStaticCmds[i]);
+    }
+}
+
+void RenderQueue::InsertStatic(const std::vector<RenderCmd>& cmds, std::vector<uint32_t>& outIndices)
+{
+    outIndices.clear();
+    if (cmds.empty())
+        return;
+
+    if (mStaticKeys.empty())
+    {
+        mStaticDepthAboveTop = std::numeric_limits<float>::lowest();
+        mStaticDepthAboveBottom = std::numeric_limits<float>::max();
+    }
+
+    mStaticNewKeys.clear();
+    for (const RenderCmd& cmd : cmds)
+    {
+        uint32_t index = 0;
+        if (!mStaticFreeList.empty())
+        {
+            index = mStaticFreeList.back();
+            mStaticFreeList.pop_back();
+            mStaticCmds[index] = cmd;
+            mStaticFree[index] = 0;
+        }
+        else
+        {
+            index = static_cast<uint32_t>(mStaticCmds.size());
+            mStaticCmds.push_back(cmd);
+            mStaticFree.push_back(0);
+        }
+
+        RenderCmd& stored = mStaticCmds[index];
+        stored.sortKey = MakeSortKey(stored.depthKey, stored.texture);
+        GrowStaticBounds(stored);
+
+        mStaticNewKeys.push_back({ stored.sortKey, index });
+        outIndices.push_back(index);
+    }
+
+    RadixSort(mStaticNewKeys, mKeysTmp);
+
+    // Stable merge: on equal keys the commands already present draw first.
+    mKeysTmp.resize(mStaticKeys.size() + mStaticNewKeys.size());
+    std::merge(mStaticKeys.begin(), mStaticKeys.end(), mStaticNewKeys.begin(), mStaticNewKeys.end(), mKeysTmp.begin(),
+        [](const KeyIndex& a, const KeyIndex& b) { return a.key < b.key; });
+    mStaticKeys.swap(mKeysTmp);
+
+    // The draw list may point into a reallocated mStaticCmds.
+    mDrawList.clear();
+}
+
+void RenderQueue::RemoveStatic(const std::vector<uint32_t>& indices)
+{
+    if (indices.empty())
+        return;
+
+    for (uint32_t index : indices)
+    {
+        if (mStaticFree[index])
+            continue;
+        mStaticFree[index] = 1;
+        mStaticFreeList.push_back(index);
+    }
+
+    // Depth bounds stay as they were: wider than needed is still correct.
+    mStaticKeys.erase(std::remove_if(mStaticKeys.begin(), mStaticKeys.end(),
+        [&](const KeyIndex& ki) { return mStaticFree[ki.index] != 0; }), mStaticKeys.end());
+
+    mDrawList.clear();
+}
+
+void RenderQueue::GrowStaticBounds(const RenderCmd& cmd)
+{
+    // How far a command's depth can sit from its rect, for the view window.
+    mStaticDepthAboveTop = std::max(mStaticDepthAboveTop, cmd.depthKey - cmd.posPx.y);
+    mStaticDepthAboveBottom = std::min(mStaticDepthAboveBottom, cmd.depthKey - (cmd.posPx.y + cmd.sizePx.y));
+}
+
+void RenderQueue::UpdateStatic(uint32_t index, const RenderCmd& cmd)
+{
+    RenderCmd& target = mStaticCmds[index];
+    target.texture = cmd.texture;
+    target.posPx = cmd.posPx;
+    target.sizePx = cmd.sizePx;
+    target.uvMin = cmd.uvMin;
+    target.uvMax = cmd.uvMax;
+
+    if (!mStaticKeys.empty())
+        GrowStaticBounds(target);
+}
+
+void RenderQueue::SortDynamic()
+{
+    mKeys.resize(mCmds.size());
+    for (size_t i = 0; i < mCmds.size(); ++i)
+        mKeys[i] = { mCmds[i].sortKey, static_cast<uint32_t>(i) };
+
+    RadixSort(mKeys, mKeysTmp);
+}
+
+void RenderQueue::Merge(size_t staticBegin, size_t staticEnd, const glm::vec2* viewMinPx, const glm::vec2* viewMaxPx)
+{
+    mDrawList.clear();
+    mDrawList.reserve((staticEnd - staticBegin) + mKeys.size());
+
+    auto isVisible = [&](const RenderCmd& cmd)
+        {
+            if (!viewMinPx)
+                return true;
+            return cmd.posPx.x <= viewMaxPx->x && cmd.posPx.x + cmd.sizePx.x >= viewMinPx->x
+                && cmd.posPx.y <= viewMaxPx->y && cmd.posPx.y + cmd.sizePx.y >= viewMinPx->y;
+        };
+
+    size_t s = staticBegin;
+    size_t d = 0;
+    while (s < staticEnd || d < mKeys.size())
+    {
+        const bool takeStatic = d == mKeys.size()
+            || (s < staticEnd && mStaticKeys[s].key <= mKeys[d].key);
+
+        if (takeStatic)
+        {
+            const RenderCmd& cmd = mStaticCmds[mStaticKeys[s++].index];
+            if (isVisible(cmd))
+                mDrawList.push_back(&cmd);
+        }
+        else
+        {
+            mDrawList.push_back(&mCmds[mKeys[d++].index]);
+        }
+    }
+}
+
+void RenderQueue::SortByDepthStable()
+{
+    SortDynamic();
+    Merge(0, mStaticKeys.size(), nullptr, nullptr);
+}
+
+void RenderQueue::SortByDepthStable(const glm::vec2& viewMinPx, const glm::vec2& viewMaxPx)
+{
+    SortDynamic();
+
+    if (mStaticKeys.empty())
+    {
+        Merge(0, 0, nullptr, nullptr);
+        return;
+    }
+
+    const uint64_t lowKey = MakeSortKey(viewMinPx.y + mStaticDepthAboveBottom, 0);
+    const uint64_t highKey = MakeSortKey(viewMaxPx.y + mStaticDepthAboveTop, std::numeric_limits<GLuint>::max());
+
+    const auto first = std::lower_bound(mStaticKeys.begin(), mStaticKeys.end(), lowKey,
+        [](const KeyIndex& ki, uint64_t key) { return ki.key < key; });
+    const auto last = std::upper_bound(first, mStaticKeys.end(), highKey,
+        [](uint64_t key, const KeyIndex& ki) { return key < ki.key; });
+
+    Merge((size_t)(first - mStaticKeys.begin()), (size_t)(last - mStaticKeys.begin()), &viewMinPx, &viewMaxPx);
+}
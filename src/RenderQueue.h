@@ -1,6 +1,6 @@
 #pragma once
+#include <cstdint>
 #include <vector>
-#include <algorithm>
 #include <glm/glm.hpp>
 #include <glad/glad.h>
 
@@ -9,6 +9,7 @@
     ---------
     One draw call worth of data for SpriteRenderer.
     depthKey determines draw order (lower first, higher last).
+    sortKey is filled by RenderQueue::Push (see RenderQueue::MakeSortKey).
 */
 struct RenderCmd
 {
@@ -18,33 +19,107 @@ struct RenderCmd
     glm::vec2 uvMin{ 0.0f, 0.0f };
     glm::vec2 uvMax{ 1.0f, 1.0f };
     float depthKey = 0.0f;         // feet-based / iso-diagonal-based
+    uint64_t sortKey = 0;
 };
 
 /*
     RenderQueue
     -----------
     Collect render commands, then sort + draw once.
+
+    Two partitions:
+      - static:  map content (walls, tile objects). Filled and sorted once
+                 per map load with PushStatic() / SortStatic(); streamed
+                 chunks come and go with InsertStatic() / RemoveStatic().
+      - dynamic: player, NPCs, effects. Cleared and pushed every frame.
+
+    SortByDepthStable() radix sorts only the dynamic commands, then merges
+    them with the pre-sorted static list. DrawList() is the merged order.
 */
 class RenderQueue
 {
 public:
-    void Clear() { mCmds.clear(); }
+    // Dynamic partition
+    void Clear() { mCmds.clear(); mDrawList.clear(); }
     void Reserve(size_t n) { mCmds.reserve(n); }
 
-    void Push(const RenderCmd& cmd) { mCmds.push_back(cmd); }
-
-    // Stable sort avoids “shimmer” when depthKeys are equal.
-    void SortByDepthStable()
+    void Push(const RenderCmd& cmd)
     {
-        std::stable_sort(mCmds.begin(), mCmds.end(),
-            [](const RenderCmd& a, const RenderCmd& b)
-            {
-                return a.depthKey < b.depthKey;
-            });
+        mCmds.push_back(cmd);
+        mCmds.back().sortKey = MakeSortKey(cmd.depthKey, cmd.texture);
     }
 
+    // Static partition
+    void ClearStatic();
+
+    // Returns the index used by GetStatic().
+    uint32_t PushStatic(const RenderCmd& cmd);
+
+    void SortStatic();
+
+    // Incremental edits after SortStatic() (e.g. streamed map chunks): the
+    // new commands are sorted on their own and merged into the sorted keys,
+    // so the rest of the partition isn't re-sorted. Removed indices are
+    // reused by later inserts; outIndices receives the GetStatic() indices.
+    void InsertStatic(const std::vector<RenderCmd>& cmds, std::vector<uint32_t>& outIndices);
+    void RemoveStatic(const std::vector<uint32_t>& indices);
+
+    // For animation updates: copies texture / rect / uvs of cmd into the static
+    // command. Its depth (and so its place in the sorted order) is kept.
+    void UpdateStatic(uint32_t index, const RenderCmd& cmd);
+
+    const RenderCmd& GetStatic(uint32_t index) const { return mStaticCmds[index]; }
+
+    size_t GetStaticCount() const { return mStaticCmds.size() - mStaticFreeList.size(); }
+
+    // High 32 bits: depth as an order-preserving integer.
+    // Low 32 bits: texture id, so equal depths batch by texture.
+    // Submission order breaks remaining ties (the radix sort is stable).
+    static uint64_t MakeSortKey(float depthKey, GLuint texture);
+
+    // Sort the dynamic commands and merge every static command.
+    // On equal keys static commands draw first.
+    void SortByDepthStable();
+
+    // Same, but static commands outside the world-pixel rect are skipped.
+    // The depth window is found by binary search, so this assumes depthKey
+    // is the feet world Y (DepthFromFeetWorldY).
+    void SortByDepthStable(const glm::vec2& viewMinPx, const glm::vec2& viewMaxPx);
+
+    // Dynamic commands in submission order.
     const std::vector<RenderCmd>& Items() const { return mCmds; }
 
+    // Merged draw order, valid after SortByDepthStable() until the next change.
+    const std::vector<const RenderCmd*>& DrawList() const { return mDrawList; }
+
 private:
+    struct KeyIndex
+    {
+        uint64_t key;
+        uint32_t index;
+    };
+
+    // LSD radix sort on key; stable. Result ends up in keys.
+    static void RadixSort(std::vector<KeyIndex>& keys, std::vector<KeyIndex>& scratch);
+
+    void SortDynamic();
+    void GrowStaticBounds(const RenderCmd& cmd);
+    void Merge(size_t staticBegin, size_t staticEnd, const glm::vec2* viewMinPx, const glm::vec2* viewMaxPx);
+
     std::vector<RenderCmd> mCmds;
+
+    // Static partition: commands keep their push index; mStaticKeys is sorted.
+    std::vector<RenderCmd> mStaticCmds;
+    std::vector<KeyIndex> mStaticKeys;
+    std::vector<uint8_t> mStaticFree;      // per command: removed, slot on the free list
+    std::vector<uint32_t> mStaticFreeList;
+    std::vector<KeyIndex> mStaticNewKeys;  // InsertStatic scratch
+    float mStaticDepthAboveTop = 0.0f;    // max(depthKey - top)
+    float mStaticDepthAboveBottom = 0.0f; // min(depthKey - bottom)
+
+    std::vector<const RenderCmd*> mDrawList;
+
+    // Sort scratch, kept to avoid per-frame allocations.
+    std::vector<KeyIndex> mKeys;
+    std::vector<KeyIndex> mKeysTmp;
 };
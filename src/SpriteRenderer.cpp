@@ -1,9 +1,55 @@
 #include "SpriteRenderer.h"
 #include "Camera2d.h"
+#include "RenderQueue.h"
+#include "TextureResidency.h"
 
 #include <glm/gtc/matrix_transform.hpp>
 #include <glm/gtc/type_ptr.hpp>
 
+#include <algorithm>
+#include <cstddef>
+#include <numeric>
+#include <string>
+
+SpriteMesh::~SpriteMesh()
+{
+    Release();
+}
+
+SpriteMesh::SpriteMesh(SpriteMesh&& other) noexcept
+    : mVAO(other.mVAO), mVBO(other.mVBO), mQuadCount(other.mQuadCount), mRanges(std::move(other.mRanges))
+{
+    other.mVAO = 0;
+    other.mVBO = 0;
+    other.mQuadCount = 0;
+}
+
+SpriteMesh& SpriteMesh::operator=(SpriteMesh&& other) noexcept
+{
+    if (this != &other)
+    {
+        Release();
+        mVAO = other.mVAO;
+        mVBO = other.mVBO;
+        mQuadCount = other.mQuadCount;
+        mRanges = std::move(other.mRanges);
+        other.mVAO = 0;
+        other.mVBO = 0;
+        other.mQuadCount = 0;
+    }
+    return *this;
+}
+
+void SpriteMesh::Release()
+{
+    if (mVBO) glDeleteBuffers(1, &mVBO);
+    if (mVAO) glDeleteVertexArrays(1, &mVAO);
+    mVBO = 0;
+    mVAO = 0;
+    mQuadCount = 0;
+    mRanges.clear();
+}
+
 SpriteRenderer::SpriteRenderer(GLuint shaderProgram, int screenWidth, int screenHeight)
     : mShaderProgram(shaderProgram), mScreenWidth(screenWidth), mScreenHeight(screenHeight)
 {
@@ -14,11 +60,18 @@ SpriteRenderer::SpriteRenderer(GLuint shaderProgram, int screenWidth, int screen
     glUseProgram(mShaderProgram);
     glUniform1i(mTextureLoc, 0);
 
+    mBatchVertices.reserve(kMaxBatchQuads * 4);
+
     InitRenderData();
 }
 
 SpriteRenderer::~SpriteRenderer()
 {
+    if (mInstanceVBO) glDeleteBuffers(1, &mInstanceVBO);
+    if (mQuadVBO) glDeleteBuffers(1, &mQuadVBO);
+    if (mInstanceVAO) glDeleteVertexArrays(1, &mInstanceVAO);
+    if (mBatchVBO) glDeleteBuffers(1, &mBatchVBO);
+    if (mBatchVAO) glDeleteVertexArrays(1, &mBatchVAO);
     if (mEBO) glDeleteBuffers(1, &mEBO);
     if (mVBO) glDeleteBuffers(1, &mVBO);
     if (mVAO) glDeleteVertexArrays(1, &mVAO);
@@ -30,6 +83,84 @@ void SpriteRenderer::SetScreenSize(int screenWidth, int screenHeight)
     mScreenHeight = screenHeight;
 }
 
+void SpriteRenderer::SetInstancedShader(GLuint shaderProgram)
+{
+    Flush();
+
+    mInstanceShader = shaderProgram;
+    mInstanceProjectionLoc = glGetUniformLocation(mInstanceShader, "uProjection");
+
+    // Bind uTextures[i] to texture unit i once; slots map 1:1 to units.
+    glUseProgram(mInstanceShader);
+    for (int i = 0; i < kMaxTextureSlots; ++i)
+    {
+        const std::string name = "uTextures[" + std::to_string(i) + "]";
+        glUniform1i(glGetUniformLocation(mInstanceShader, name.c_str()), i);
+    }
+
+    if (!mInstanceVAO)
+        InitInstanceData();
+}
+
+void SpriteRenderer::SetMode(SpriteRenderMode mode)
+{
+    if (mode == SpriteRenderMode::Instanced && !mInstanceShader)
+        mode = SpriteRenderMode::Batched;
+
+    if (mode == mMode)
+        return;
+
+    Flush();
+    mMode = mode;
+}
+
+void SpriteRenderer::BeginFrame()
+{
+    mStats = SpriteRenderStats{};
+    mLastTexture = 0;
+    mBatchVertices.clear();
+    mBatchTexture = 0;
+    mInstances.clear();
+    mSlotCount = 0;
+
+    glm::mat4 projection = glm::ortho(
+        0.0f, (float)mScreenWidth,
+        (float)mScreenHeight, 0.0f,
+        -1.0f, 1.0f
+    );
+
+    glUseProgram(mShaderProgram);
+    glUniformMatrix4fv(mProjectionLoc, 1, GL_FALSE, glm::value_ptr(projection));
+
+    if (mInstanceShader)
+    {
+        glUseProgram(mInstanceShader);
+        glUniformMatrix4fv(mInstanceProjectionLoc, 1, GL_FALSE, glm::value_ptr(projection));
+    }
+}
+
+void SpriteRenderer::EndFrame()
+{
+    Flush();
+}
+
+void SpriteRenderer::CountBatch(GLuint texture)
+{
+    if (mStats.quads == 0 || texture != mLastTexture)
+        mStats.batches++;
+
+    mLastTexture = texture;
+    mStats.quads++;
+}
+
+void SpriteRenderer::BindTexture(GLuint texture)
+{
+    if (mResidency)
+        mResidency->MarkUsed(texture);
+
+    glBindTexture(GL_TEXTURE_2D, texture);
+}
+
 void SpriteRenderer::Draw(GLuint texture,
     const glm::vec2& worldPosition,
     const glm::vec2& size,
@@ -49,11 +180,50 @@ void SpriteRenderer::Draw(GLuint texture,
     // Convert world -> screen
     glm::vec2 screenPos = worldPosition - camera.GetPosition();
 
-    glm::mat4 projection = glm::ortho(
-        0.0f, (float)mScreenWidth,
-        (float)mScreenHeight, 0.0f,
-        -1.0f, 1.0f
-    );
+    CountBatch(texture);
+
+    if (mMode == SpriteRenderMode::Instanced)
+    {
+        int slot = -1;
+        for (int i = 0; i < mSlotCount; ++i)
+        {
+            if (mSlotTextures[i] == texture)
+            {
+                slot = i;
+                break;
+            }
+        }
+
+        if (slot < 0 && mSlotCount == kMaxTextureSlots)
+            Flush();
+
+        if ((int)mInstances.size() >= kMaxBatchQuads)
+        {
+            Flush();
+            slot = -1;
+        }
+
+        if (slot < 0)
+        {
+            slot = mSlotCount++;
+            mSlotTextures[slot] = texture;
+        }
+
+        mInstances.push_back({ screenPos, size, uvMin, uvMax, (float)slot });
+        return;
+    }
+
+    if (mMode == SpriteRenderMode::Batched)
+    {
+        if (texture != mBatchTexture || (int)mBatchVertices.size() >= kMaxBatchQuads * 4)
+            Flush();
+
+        mBatchTexture = texture;
+
+        mBatchVertices.resize(mBatchVertices.size() + 4);
+        WriteQuadVertices(&mBatchVertices[mBatchVertices.size() - 4], screenPos, size, uvMin, uvMax);
+        return;
+    }
 
     glm::mat4 model(1.0f);
     model = glm::translate(model, glm::vec3(screenPos, 0.0f));
@@ -72,15 +242,194 @@ void SpriteRenderer::Draw(GLuint texture,
     glBufferSubData(GL_ARRAY_BUFFER, 0, sizeof(verts), verts);
 
     glUseProgram(mShaderProgram);
-    glUniformMatrix4fv(mProjectionLoc, 1, GL_FALSE, glm::value_ptr(projection));
     glUniformMatrix4fv(mModelLoc, 1, GL_FALSE, glm::value_ptr(model));
 
     glActiveTexture(GL_TEXTURE0);
-    glBindTexture(GL_TEXTURE_2D, texture);
+    BindTexture(texture);
 
     glBindVertexArray(mVAO);
     glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, nullptr);
     glBindVertexArray(0);
+
+    mStats.drawCalls++;
+}
+
+void SpriteRenderer::DrawQueue(const RenderQueue& queue, const Camera2D& camera)
+{
+    for (const RenderCmd* cmd : queue.DrawList())
+        Draw(cmd->texture, cmd->posPx, cmd->sizePx, camera, cmd->uvMin, cmd->uvMax);
+}
+
+void SpriteRenderer::WriteQuadVertices(SpriteVertex* out,
+    const glm::vec2& pos, const glm::vec2& size,
+    const glm::vec2& uvMin, const glm::vec2& uvMax)
+{
+    const glm::vec2 p1 = pos + size;
+    out[0] = { { pos.x, pos.y }, { uvMin.x, uvMin.y } };
+    out[1] = { { p1.x,  pos.y }, { uvMax.x, uvMin.y } };
+    out[2] = { { p1.x,  p1.y  }, { uvMax.x, uvMax.y } };
+    out[3] = { { pos.x, p1.y  }, { uvMin.x, uvMax.y } };
+}
+
+void SpriteRenderer::BuildMesh(SpriteMesh& mesh, const std::vector<SpriteQuad>& quads, std::vector<int>& outQuadIndices) const
+{
+    mesh.Release();
+    outQuadIndices.assign(quads.size(), -1);
+
+    if (quads.empty())
+        return;
+
+    // Group by texture, keeping submission order inside each group.
+    std::vector<int> order(quads.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(),
+        [&](int a, int b) { return quads[a].texture < quads[b].texture; });
+
+    std::vector<SpriteVertex> vertices(quads.size() * 4);
+    for (size_t slot = 0; slot < order.size(); ++slot)
+    {
+        const SpriteQuad& quad = quads[order[slot]];
+        WriteQuadVertices(&vertices[slot * 4], quad.posPx, quad.sizePx, quad.uvMin, quad.uvMax);
+        outQuadIndices[order[slot]] = (int)slot;
+
+        if (mesh.mRanges.empty() || mesh.mRanges.back().texture != quad.texture)
+            mesh.mRanges.push_back({ quad.texture, (int)slot, 0 });
+        mesh.mRanges.back().quadCount++;
+    }
+
+    mesh.mQuadCount = (int)quads.size();
+
+    glGenVertexArrays(1, &mesh.mVAO);
+    glGenBuffers(1, &mesh.mVBO);
+
+    glBindVertexArray(mesh.mVAO);
+
+    glBindBuffer(GL_ARRAY_BUFFER, mesh.mVBO);
+    glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(SpriteVertex), vertices.data(), GL_STATIC_DRAW);
+
+    // Ranges are drawn with a base vertex, so the shared quad index buffer fits.
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, mEBO);
+
+    glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, sizeof(SpriteVertex), (void*)0);
+    glEnableVertexAttribArray(0);
+
+    glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, sizeof(SpriteVertex), (void*)(sizeof(glm::vec2)));
+    glEnableVertexAttribArray(1);
+
+    glBindVertexArray(0);
+}
+
+void SpriteRenderer::UpdateMeshQuad(SpriteMesh& mesh, int quadIndex, const SpriteQuad& quad) const
+{
+    if (quadIndex < 0 || quadIndex >= mesh.mQuadCount)
+        return;
+
+    SpriteVertex vertices[4];
+    WriteQuadVertices(vertices, quad.posPx, quad.sizePx, quad.uvMin, quad.uvMax);
+
+    glBindBuffer(GL_ARRAY_BUFFER, mesh.mVBO);
+    glBufferSubData(GL_ARRAY_BUFFER, quadIndex * 4 * sizeof(SpriteVertex), sizeof(vertices), vertices);
+}
+
+void SpriteRenderer::DrawMesh(const SpriteMesh& mesh, const glm::vec2& offsetPx)
+{
+    if (mesh.IsEmpty())
+        return;
+
+    // Keep painter order with anything already batched.
+    Flush();
+
+    const glm::mat4 model = glm::translate(glm::mat4(1.0f), glm::vec3(offsetPx, 0.0f));
+    glUseProgram(mShaderProgram);
+    glUniformMatrix4fv(mModelLoc, 1, GL_FALSE, glm::value_ptr(model));
+
+    glActiveTexture(GL_TEXTURE0);
+    glBindVertexArray(mesh.mVAO);
+
+    for (const SpriteMesh::Range& range : mesh.mRanges)
+    {
+        BindTexture(range.texture);
+
+        for (int first = 0; first < range.quadCount; first += kMaxBatchQuads)
+        {
+            const int count = std::min(kMaxBatchQuads, range.quadCount - first);
+            glDrawElementsBaseVertex(GL_TRIANGLES, count * 6, GL_UNSIGNED_INT, nullptr,
+                (range.firstQuad + first) * 4);
+            mStats.drawCalls++;
+        }
+
+        mStats.batches++;
+        mStats.quads += range.quadCount;
+    }
+
+    glBindVertexArray(0);
+
+    // Sprites drawn after the mesh must not merge into its last batch count.
+    mLastTexture = 0;
+}
+
+void SpriteRenderer::Flush()
+{
+    FlushBatch();
+    FlushInstances();
+}
+
+void SpriteRenderer::FlushBatch()
+{
+    if (mBatchVertices.empty())
+        return;
+
+    const int quadCount = (int)mBatchVertices.size() / 4;
+
+    // Orphan the previous storage so the driver does not stall on in-flight draws.
+    glBindBuffer(GL_ARRAY_BUFFER, mBatchVBO);
+    glBufferData(GL_ARRAY_BUFFER, kMaxBatchQuads * 4 * sizeof(SpriteVertex), nullptr, GL_STREAM_DRAW);
+    glBufferSubData(GL_ARRAY_BUFFER, 0, mBatchVertices.size() * sizeof(SpriteVertex), mBatchVertices.data());
+
+    // Batched vertices are already in screen space.
+    const glm::mat4 identity(1.0f);
+    glUseProgram(mShaderProgram);
+    glUniformMatrix4fv(mModelLoc, 1, GL_FALSE, glm::value_ptr(identity));
+
+    glActiveTexture(GL_TEXTURE0);
+    BindTexture(mBatchTexture);
+
+    glBindVertexArray(mBatchVAO);
+    glDrawElements(GL_TRIANGLES, quadCount * 6, GL_UNSIGNED_INT, nullptr);
+    glBindVertexArray(0);
+
+    mStats.drawCalls++;
+    mBatchVertices.clear();
+}
+
+void SpriteRenderer::FlushInstances()
+{
+    if (mInstances.empty())
+    {
+        mSlotCount = 0;
+        return;
+    }
+
+    glBindBuffer(GL_ARRAY_BUFFER, mInstanceVBO);
+    glBufferData(GL_ARRAY_BUFFER, kMaxBatchQuads * sizeof(SpriteInstance), nullptr, GL_STREAM_DRAW);
+    glBufferSubData(GL_ARRAY_BUFFER, 0, mInstances.size() * sizeof(SpriteInstance), mInstances.data());
+
+    glUseProgram(mInstanceShader);
+
+    for (int i = 0; i < mSlotCount; ++i)
+    {
+        glActiveTexture(GL_TEXTURE0 + i);
+        BindTexture(mSlotTextures[i]);
+    }
+    glActiveTexture(GL_TEXTURE0);
+
+    glBindVertexArray(mInstanceVAO);
+    glDrawElementsInstanced(GL_TRIANGLES, 6, GL_UNSIGNED_INT, nullptr, (GLsizei)mInstances.size());
+    glBindVertexArray(0);
+
+    mStats.drawCalls++;
+    mInstances.clear();
+    mSlotCount = 0;
 }
 
 void SpriteRenderer::InitRenderData()
@@ -94,7 +443,18 @@ void SpriteRenderer::InitRenderData()
         0.0f, 1.0f,  0.0f, 1.0f
     };
 
-    unsigned int indices[] = { 0, 1, 2, 2, 3, 0 };
+    // Shared quad index buffer: { 0, 1, 2, 2, 3, 0 } repeated per quad.
+    std::vector<unsigned int> indices(kMaxBatchQuads * 6);
+    for (int q = 0; q < kMaxBatchQuads; ++q)
+    {
+        const unsigned int base = (unsigned int)q * 4;
+        indices[q * 6 + 0] = base + 0;
+        indices[q * 6 + 1] = base + 1;
+        indices[q * 6 + 2] = base + 2;
+        indices[q * 6 + 3] = base + 2;
+        indices[q * 6 + 4] = base + 3;
+        indices[q * 6 + 5] = base + 0;
+    }
 
     glGenVertexArrays(1, &mVAO);
     glGenBuffers(1, &mVBO);
@@ -106,7 +466,7 @@ void SpriteRenderer::InitRenderData()
     glBufferData(GL_ARRAY_BUFFER, sizeof(vertices), vertices, GL_DYNAMIC_DRAW);
 
     glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, mEBO);
-    glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(indices), indices, GL_STATIC_DRAW);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(unsigned int), indices.data(), GL_STATIC_DRAW);
 
     glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 4 * sizeof(float), (void*)0);
     glEnableVertexAttribArray(0);
@@ -114,5 +474,69 @@ void SpriteRenderer::InitRenderData()
     glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 4 * sizeof(float), (void*)(2 * sizeof(float)));
     glEnableVertexAttribArray(1);
 
+    // Batched path: same layout, streaming vertex buffer, shared index buffer.
+    glGenVertexArrays(1, &mBatchVAO);
+    glGenBuffers(1, &mBatchVBO);
+
+    glBindVertexArray(mBatchVAO);
+
+    glBindBuffer(GL_ARRAY_BUFFER, mBatchVBO);
+    glBufferData(GL_ARRAY_BUFFER, kMaxBatchQuads * 4 * sizeof(SpriteVertex), nullptr, GL_STREAM_DRAW);
+
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, mEBO);
+
+    glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, sizeof(SpriteVertex), (void*)0);
+    glEnableVertexAttribArray(0);
+
+    glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, sizeof(SpriteVertex), (void*)(sizeof(glm::vec2)));
+    glEnableVertexAttribArray(1);
+
+    glBindVertexArray(0);
+}
+
+void SpriteRenderer::InitInstanceData()
+{
+    // Static unit quad; everything per-sprite comes from the instance buffer.
+    const float quad[] = {
+        0.0f, 0.0f,
+        1.0f, 0.0f,
+        1.0f, 1.0f,
+        0.0f, 1.0f
+    };
+
+    glGenVertexArrays(1, &mInstanceVAO);
+    glGenBuffers(1, &mQuadVBO);
+    glGenBuffers(1, &mInstanceVBO);
+
+    glBindVertexArray(mInstanceVAO);
+
+    glBindBuffer(GL_ARRAY_BUFFER, mQuadVBO);
+    glBufferData(GL_ARRAY_BUFFER, sizeof(quad), quad, GL_STATIC_DRAW);
+
+    glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 2 * sizeof(float), (void*)0);
+    glEnableVertexAttribArray(0);
+
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, mEBO);
+
+    glBindBuffer(GL_ARRAY_BUFFER, mInstanceVBO);
+    glBufferData(GL_ARRAY_BUFFER, kMaxBatchQuads * sizeof(SpriteInstance), nullptr, GL_STREAM_DRAW);
+
+    const GLsizei stride = sizeof(SpriteInstance);
+
+    // location 2: pos.xy + size.xy
+    glVertexAttribPointer(2, 4, GL_FLOAT, GL_FALSE, stride, (void*)offsetof(SpriteInstance, posPx));
+    glEnableVertexAttribArray(2);
+    glVertexAttribDivisor(2, 1);
+
+    // location 3: uvMin.xy + uvMax.xy
+    glVertexAttribPointer(3, 4, GL_FLOAT, GL_FALSE, stride, (void*)offsetof(SpriteInstance, uvMin));
+    glEnableVertexAttribArray(3);
+    glVertexAttribDivisor(3, 1);
+
+    // location 4: texture slot
+    glVertexAttribPointer(4, 1, GL_FLOAT, GL_FALSE, stride, (void*)offsetof(SpriteInstance, textureSlot));
+    glEnableVertexAttribArray(4);
+    glVertexAttribDivisor(4, 1);
+
     glBindVertexArray(0);
 }
@@ -3,7 +3,85 @@
 #include <glad/glad.h>
 #include <glm/glm.hpp>
 
+#include <vector>
+
 class Camera2D;
+class RenderQueue;
+class TextureResidency;
+
+// One textured quad in pixels (used to build static meshes).
+struct SpriteQuad
+{
+    GLuint texture = 0;
+    glm::vec2 posPx{ 0.0f, 0.0f };
+    glm::vec2 sizePx{ 0.0f, 0.0f };
+    glm::vec2 uvMin{ 0.0f, 0.0f };
+    glm::vec2 uvMax{ 1.0f, 1.0f };
+};
+
+/*
+    SpriteMesh
+    ----------
+    GPU vertex buffer of static quads, grouped into one range per texture.
+    Built / updated / drawn through SpriteRenderer; owns its GL objects.
+*/
+class SpriteMesh
+{
+public:
+    struct Range
+    {
+        GLuint texture = 0;
+        int firstQuad = 0;
+        int quadCount = 0;
+    };
+
+    SpriteMesh() = default;
+    ~SpriteMesh();
+
+    SpriteMesh(const SpriteMesh&) = delete;
+    SpriteMesh& operator=(const SpriteMesh&) = delete;
+
+    SpriteMesh(SpriteMesh&& other) noexcept;
+    SpriteMesh& operator=(SpriteMesh&& other) noexcept;
+
+    bool IsEmpty() const { return mQuadCount == 0; }
+    int GetQuadCount() const { return mQuadCount; }
+
+private:
+    friend class SpriteRenderer;
+
+    void Release();
+
+    GLuint mVAO = 0;
+    GLuint mVBO = 0;
+    int mQuadCount = 0;
+    std::vector<Range> mRanges;
+};
+
+/*
+    SpriteRenderMode
+    ----------------
+    Immediate: one glDrawElements per sprite (reference path).
+    Batched:   sprites are expanded into a streaming vertex buffer on the CPU
+               and flushed only when the texture changes or the buffer is full.
+    Instanced: the unit quad stays static; each sprite is one compact
+               SpriteInstance record drawn with glDrawElementsInstanced.
+               Up to kMaxTextureSlots textures share a single draw.
+*/
+enum class SpriteRenderMode
+{
+    Immediate,
+    Batched,
+    Instanced
+};
+
+// Per-frame counters, reset by BeginFrame().
+struct SpriteRenderStats
+{
+    int drawCalls = 0; // draw calls issued
+    int batches = 0;   // runs of consecutive sprites sharing a texture
+    int quads = 0;     // sprites submitted
+};
 
 /*
     SpriteRenderer
@@ -12,6 +90,12 @@ class Camera2D;
     Supports:
       - Default UVs (0..1)
       - Custom UV rectangle for texture atlases
+      - Batched mode (see SpriteRenderMode)
+
+    Frame usage:
+      BeginFrame()  -> uploads the projection once
+      Draw(...)     -> any number of sprites
+      EndFrame()    -> flushes whatever is still batched
 */
 class SpriteRenderer
 {
@@ -21,6 +105,25 @@ public:
 
     void SetScreenSize(int screenWidth, int screenHeight);
 
+    // Program used by SpriteRenderMode::Instanced (see main.cpp shaders).
+    // Without one, Instanced mode falls back to Batched.
+    void SetInstancedShader(GLuint shaderProgram);
+
+    void SetMode(SpriteRenderMode mode);
+    SpriteRenderMode GetMode() const { return mMode; }
+
+    void BeginFrame();
+    void EndFrame();
+
+    // Submit pending batched / instanced sprites to the GPU.
+    void Flush();
+
+    const SpriteRenderStats& GetStats() const { return mStats; }
+
+    // Every texture bound for drawing is reported here (last-drawn frame
+    // for VRAM eviction). Optional; not owned.
+    void SetTextureResidency(TextureResidency* residency) { mResidency = residency; }
+
     // Draw full texture
     void Draw(GLuint texture,
         const glm::vec2& worldPosition,
@@ -35,8 +138,53 @@ public:
         const glm::vec2& uvMin,
         const glm::vec2& uvMax);
 
+    // Draw every command of an already-sorted queue.
+    void DrawQueue(const RenderQueue& queue, const Camera2D& camera);
+
+    // Upload quads into mesh, grouped by texture (stable within a texture).
+    // outQuadIndices[i] receives the mesh slot of quads[i] for UpdateMeshQuad.
+    void BuildMesh(SpriteMesh& mesh, const std::vector<SpriteQuad>& quads, std::vector<int>& outQuadIndices) const;
+
+    // Rewrite one quad in place; its texture must match the slot's range.
+    void UpdateMeshQuad(SpriteMesh& mesh, int quadIndex, const SpriteQuad& quad) const;
+
+    // Draw a static mesh; offsetPx is added to every vertex (mesh -> screen).
+    void DrawMesh(const SpriteMesh& mesh, const glm::vec2& offsetPx);
+
 private:
+    struct SpriteVertex
+    {
+        glm::vec2 pos;
+        glm::vec2 uv;
+    };
+
+    // Per-instance record for the instanced path (screen space).
+    struct SpriteInstance
+    {
+        glm::vec2 posPx;
+        glm::vec2 sizePx;
+        glm::vec2 uvMin;
+        glm::vec2 uvMax;
+        float textureSlot;
+    };
+
+    // Quads per streaming upload; also sizes the shared index buffer.
+    static constexpr int kMaxBatchQuads = 4096;
+
+    // Texture units sampled by the instanced shader (uTextures[]).
+    static constexpr int kMaxTextureSlots = 8;
+
+    static void WriteQuadVertices(SpriteVertex* out,
+        const glm::vec2& pos, const glm::vec2& size,
+        const glm::vec2& uvMin, const glm::vec2& uvMax);
+
     void InitRenderData();
+    void InitInstanceData();
+    void CountBatch(GLuint texture);
+    void BindTexture(GLuint texture);
+
+    void FlushBatch();
+    void FlushInstances();
 
 private:
     GLuint mShaderProgram = 0;
@@ -48,6 +196,30 @@ private:
     GLuint mVBO = 0;
     GLuint mEBO = 0;
 
+    GLuint mBatchVAO = 0;
+    GLuint mBatchVBO = 0;
+
     int mScreenWidth = 800;
     int mScreenHeight = 600;
+
+    SpriteRenderMode mMode = SpriteRenderMode::Batched;
+    SpriteRenderStats mStats{};
+    GLuint mLastTexture = 0;
+    TextureResidency* mResidency = nullptr;
+
+    // Pending batched quads (screen-space vertices, 4 per quad)
+    std::vector<SpriteVertex> mBatchVertices;
+    GLuint mBatchTexture = 0;
+
+    // Instanced path
+    GLuint mInstanceShader = 0;
+    GLint  mInstanceProjectionLoc = -1;
+
+    GLuint mInstanceVAO = 0;
+    GLuint mQuadVBO = 0;
+    GLuint mInstanceVBO = 0;
+
+    std::vector<SpriteInstance> mInstances;
+    GLuint mSlotTextures[kMaxTextureSlots] = {};
+    int mSlotCount = 0;
 };
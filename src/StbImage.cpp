@@ -0,0 +1,4 @@
+// stb_image implementation (image decoding for the client and tools, and the
+// zlib inflater TmxLoader uses for compressed layers). Define it nowhere else.
+#define STB_IMAGE_IMPLEMENTATION
+#include "stb_image.h"
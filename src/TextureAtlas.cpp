@@ -0,0 +1,227 @@
+#include "TextureAtlas.h"
+
+#include <algorithm>
+
+TextureAtlas::TextureAtlas(int pageSizePx, int paddingPx)
+    : mPageSizePx(pageSizePx)
+    , mPaddingPx(std::max(0, paddingPx))
+{
+}
+
+TextureAtlas::~TextureAtlas()
+{
+    Clear();
+}
+
+void TextureAtlas::Clear()
+{
+    for (Page& page : mPages)
+    {
+        if (page.texture)
+            glDeleteTextures(1, &page.texture);
+    }
+
+    mPages.clear();
+    mImageCount = 0;
+    mUsedTexels = 0;
+
+    if (mClearFramebuffer)
+    {
+        glDeleteFramebuffers(1, &mClearFramebuffer);
+        mClearFramebuffer = 0;
+    }
+}
+
+void TextureAtlas::FreePage(int page)
+{
+    Page& freed = mPages[page];
+    if (freed.texture)
+        glDeleteTextures(1, &freed.texture);
+
+    mImageCount -= freed.imageCount;
+    mUsedTexels -= freed.usedTexels;
+    freed = Page{};
+}
+
+int TextureAtlas::GetLivePageCount() const
+{
+    int count = 0;
+    for (const Page& page : mPages)
+        count += page.texture ? 1 : 0;
+    return count;
+}
+
+float TextureAtlas::GetOccupancy() const
+{
+    const int pages = GetLivePageCount();
+    if (pages == 0)
+        return 0.0f;
+
+    const double pageTexels = (double)mPageSizePx * (double)mPageSizePx;
+    return (float)(mUsedTexels / (pageTexels * (double)pages));
+}
+
+bool TextureAtlas::Place(Page& page, int width, int height, int& outX, int& outY) const
+{
+    // Padded footprint keeps neighbours from touching.
+    const int w = width + mPaddingPx;
+    const int h = height + mPaddingPx;
+
+    // Best fit: the lowest shelf that is tall enough and still has room.
+    Shelf* best = nullptr;
+    for (Shelf& shelf : page.shelves)
+    {
+        if (shelf.height < h || shelf.nextX + w > mPageSizePx)
+            continue;
+
+        if (!best || shelf.height < best->height)
+            best = &shelf;
+    }
+
+    if (!best)
+    {
+        if (page.nextShelfY + h > mPageSizePx || w > mPageSizePx)
+            return false;
+
+        page.shelves.push_back({ page.nextShelfY, h, 0 });
+        page.nextShelfY += h;
+        best = &page.shelves.back();
+    }
+
+    outX = best->nextX;
+    outY = best->y;
+    best->nextX += w;
+    return true;
+}
+
+int TextureAtlas::CreatePage()
+{
+    Page page;
+
+    glGenTextures(1, &page.texture);
+    glBindTexture(GL_TEXTURE_2D, page.texture);
+
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+
+    AllocatePageStorage(page.texture);
+
+    // Reuse the slot of a freed page first.
+    for (size_t i = 0; i < mPages.size(); ++i)
+    {
+        if (!mPages[i].texture)
+        {
+            mPages[i] = std::move(page);
+            return (int)i;
+        }
+    }
+
+    mPages.push_back(std::move(page));
+    return (int)mPages.size() - 1;
+}
+
+void TextureAtlas::AllocatePageStorage(GLuint texture)
+{
+    glBindTexture(GL_TEXTURE_2D, texture);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, mPageSizePx, mPageSizePx, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+
+    // Start fully transparent so padding never shows garbage. Cleared through
+    // a framebuffer (no glClearTexImage in GL 3.3), so nothing is uploaded.
+    GLint previousFramebuffer = 0;
+    GLfloat previousClearColor[4] = {};
+    const GLboolean scissor = glIsEnabled(GL_SCISSOR_TEST);
+    glGetIntegerv(GL_DRAW_FRAMEBUFFER_BINDING, &previousFramebuffer);
+    glGetFloatv(GL_COLOR_CLEAR_VALUE, previousClearColor);
+
+    if (!mClearFramebuffer)
+        glGenFramebuffers(1, &mClearFramebuffer);
+
+    glBindFramebuffer(GL_DRAW_FRAMEBUFFER, mClearFramebuffer);
+    glFramebufferTexture2D(GL_DRAW_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, texture, 0);
+    glDisable(GL_SCISSOR_TEST);
+    glClearColor(0.0f, 0.0f, 0.0f, 0.0f);
+    glClear(GL_COLOR_BUFFER_BIT);
+
+    glFramebufferTexture2D(GL_DRAW_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, 0, 0);
+    glBindFramebuffer(GL_DRAW_FRAMEBUFFER, (GLuint)previousFramebuffer);
+    glClearColor(previousClearColor[0], previousClearColor[1], previousClearColor[2], previousClearColor[3]);
+    if (scissor)
+        glEnable(GL_SCISSOR_TEST);
+}
+
+void TextureAtlas::ReleasePageStorage(int page)
+{
+    static const unsigned char kTransparent[4] = { 0, 0, 0, 0 };
+    glBindTexture(GL_TEXTURE_2D, mPages[page].texture);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, 1, 1, 0, GL_RGBA, GL_UNSIGNED_BYTE, kTransparent);
+}
+
+void TextureAtlas::RestorePageStorage(int page)
+{
+    AllocatePageStorage(mPages[page].texture);
+}
+
+bool TextureAtlas::Add(const unsigned char* rgba, int width, int height, AtlasRegion& outRegion)
+{
+    if (!rgba || !Reserve(width, height, outRegion))
+        return false;
+
+    glBindTexture(GL_TEXTURE_2D, outRegion.texture);
+    glTexSubImage2D(GL_TEXTURE_2D, 0, outRegion.x, outRegion.y, width, height, GL_RGBA, GL_UNSIGNED_BYTE, rgba);
+    return true;
+}
+
+bool TextureAtlas::Reserve(int width, int height, AtlasRegion& outRegion)
+{
+    if (width <= 0 || height <= 0)
+        return false;
+
+    if (!mPageSizeChecked)
+    {
+        GLint maxSize = 0;
+        glGetIntegerv(GL_MAX_TEXTURE_SIZE, &maxSize);
+        if (maxSize > 0)
+            mPageSizePx = std::min(mPageSizePx, (int)maxSize);
+        mPageSizeChecked = true;
+    }
+
+    if (width + mPaddingPx > mPageSizePx || height + mPaddingPx > mPageSizePx)
+        return false;
+
+    int pageIndex = -1;
+    int x = 0;
+    int y = 0;
+    for (size_t i = 0; i < mPages.size(); ++i)
+    {
+        if (mPages[i].texture && Place(mPages[i], width, height, x, y))
+        {
+            pageIndex = (int)i;
+            break;
+        }
+    }
+
+    if (pageIndex < 0)
+    {
+        pageIndex = CreatePage();
+        if (!Place(mPages[pageIndex], width, height, x, y))
+            return false;
+    }
+
+    Page& page = mPages[pageIndex];
+
+    const float invSize = 1.0f / (float)mPageSizePx;
+    outRegion.texture = page.texture;
+    outRegion.page = pageIndex;
+    outRegion.x = x;
+    outRegion.y = y;
+    outRegion.uvMin = glm::vec2((float)x, (float)y) * invSize;
+    outRegion.uvMax = glm::vec2((float)(x + width), (float)(y + height)) * invSize;
+
+    ++page.imageCount;
+    page.usedTexels += (long long)width * height;
+    ++mImageCount;
+    mUsedTexels += (long long)width * height;
+    return true;
+}
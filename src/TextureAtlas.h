@@ -0,0 +1,98 @@
+#pragma once
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+
+#include <vector>
+
+// Where an image landed inside an atlas page.
+struct AtlasRegion
+{
+    GLuint texture = 0;
+    glm::vec2 uvMin{ 0.0f, 0.0f };
+    glm::vec2 uvMax{ 1.0f, 1.0f };
+    int page = -1;
+    int x = 0; // texel offset in the page
+    int y = 0;
+};
+
+/*
+    TextureAtlas
+    ------------
+    Shelf-packs RGBA images into square GL_TEXTURE_2D pages.
+
+    Used for image-collection tilesets (tree.tsx, ...): every frame would
+    otherwise be its own texture and break sprite batching. Images of the
+    same height share a shelf, so same-sized frames pack as a plain grid.
+
+    UVs follow the full-texture convention (image row 0 at v = 0), so a
+    region can replace a whole texture without touching the renderer.
+    Owns its GL textures; Clear() deletes them.
+*/
+class TextureAtlas
+{
+public:
+    // pageSizePx is clamped to GL_MAX_TEXTURE_SIZE when the first page is made.
+    explicit TextureAtlas(int pageSizePx = 2048, int paddingPx = 1);
+    ~TextureAtlas();
+
+    TextureAtlas(const TextureAtlas&) = delete;
+    TextureAtlas& operator=(const TextureAtlas&) = delete;
+
+    // Copy an RGBA8 image into the atlas. False when it can't fit on a page.
+    bool Add(const unsigned char* rgba, int width, int height, AtlasRegion& outRegion);
+
+    // Space only; the caller uploads the pixels to (x, y) of region.texture.
+    bool Reserve(int width, int height, AtlasRegion& outRegion);
+
+    void Clear();
+
+    // Delete one page (its regions become invalid). The slot stays, so other
+    // pages keep their index; the next page created reuses it.
+    void FreePage(int page);
+
+    // Drop a page's pixels but keep its texture name (and so every region
+    // handed out); Restore re-allocates it transparent for re-uploading.
+    void ReleasePageStorage(int page);
+    void RestorePageStorage(int page);
+
+    // Page slots; a freed slot has texture 0.
+    int GetPageCount() const { return (int)mPages.size(); }
+    GLuint GetPageTexture(int page) const { return mPages[page].texture; }
+    int GetLivePageCount() const;
+    int GetPageSizePx() const { return mPageSizePx; }
+    int GetImageCount() const { return mImageCount; }
+
+    // Fraction of page texels covered by images (padding excluded).
+    float GetOccupancy() const;
+
+private:
+    struct Shelf
+    {
+        int y = 0;
+        int height = 0;
+        int nextX = 0;
+    };
+
+    struct Page
+    {
+        GLuint texture = 0;
+        std::vector<Shelf> shelves;
+        int nextShelfY = 0;
+        int imageCount = 0;
+        long long usedTexels = 0;
+    };
+
+    bool Place(Page& page, int width, int height, int& outX, int& outY) const;
+    int CreatePage();
+    void AllocatePageStorage(GLuint texture);
+
+    int mPageSizePx = 2048;
+    int mPaddingPx = 1;
+    bool mPageSizeChecked = false;
+    GLuint mClearFramebuffer = 0; // clears new page storage on the GPU
+
+    std::vector<Page> mPages;
+    int mImageCount = 0;
+    long long mUsedTexels = 0;
+};
@@ -0,0 +1,793 @@
+#include "TextureRegistry.h"
+
+#include "AssetFiles.h"
+#include "ImageSource.h"
+#include "PixelHash.h"
+#include "stb_image.h"
+
+#include <algorithm>
+#include <filesystem>
+#include <iostream>
+
+Texture2D CreateTextureRGBA(const unsigned char* pixels, int width, int height)
+{
+    Texture2D tex{};
+    tex.width = width;
+    tex.height = height;
+
+    glGenTextures(1, &tex.id);
+    glBindTexture(GL_TEXTURE_2D, tex.id);
+
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+
+    // No mipmaps: GL_NEAREST minification never samples them.
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, pixels);
+
+    return tex;
+}
+
+TextureRegistry::TextureRegistry(double gracePeriodSeconds, size_t uploadBudgetBytes, size_t vramBudgetBytes)
+    : mGracePeriodSeconds(gracePeriodSeconds)
+    , mUploader(uploadBudgetBytes, 2)
+    , mResidency(vramBudgetBytes)
+{
+}
+
+TextureRegistry::~TextureRegistry()
+{
+    Clear();
+}
+
+std::string TextureRegistry::CanonicalPath(const std::string& path)
+{
+    std::error_code ec;
+    const std::filesystem::path canonical = std::filesystem::weakly_canonical(path, ec);
+    if (ec)
+        return std::filesystem::path(path).lexically_normal().generic_string();
+    return canonical.generic_string();
+}
+
+uint64_t TextureRegistry::HashImage(const std::string& path, const ImageSource* images, const uint8_t* rgba,
+    int width, int height)
+{
+    uint64_t hash = 0;
+    if (images && images->FindImageHash(path, hash))
+        return hash;
+    return HashPixels(rgba, width, height);
+}
+
+Texture2D TextureRegistry::Acquire(const std::string& path, bool flipY, const ImageSource* images,
+    int expectedWidth, int expectedHeight)
+{
+    const std::string key = CanonicalPath(path) + (flipY ? "|flip" : kNoFlipSuffix);
+
+    const auto alias = mAliases.find(key);
+    auto it = mTextures.find(alias != mAliases.end() ? alias->second : key);
+    if (it != mTextures.end())
+    {
+        ++mHits;
+        if (it->second.refs++ == 0)
+            --mUnreferenced;
+        return it->second.texture;
+    }
+
+    ++mMisses;
+
+    // Image sources hold pixels decoded without a flip.
+    const uint8_t* pixels = nullptr;
+    unsigned char* decoded = nullptr;
+    int width = 0, height = 0;
+    Texture2D texture{};
+    bool hashed = false;
+    uint64_t contentHash = 0;
+
+    // A streamed texture is laid out at the size in the file's header, not
+    // the expected one: a PNG that disagrees with its TSX still gets the
+    // UVs / bytes of what is actually uploaded.
+    const bool cooked = !flipY && images && images->FindImage(path, pixels, width, height);
+    if (!cooked && !flipY && expectedWidth > 0 && expectedHeight > 0 && ReadAssetImageSize(path, width, height))
+    {
+        // Placeholder now, real pixels a few frames later.
+        static const unsigned char kTransparent[4] = { 0, 0, 0, 0 };
+        texture = CreateTextureRGBA(kTransparent, 1, 1);
+        texture.width = width;
+        texture.height = height;
+        mUploader.Enqueue(path, texture.id, 0, 0, width, height, true);
+    }
+    else
+    {
+        if (!cooked)
+        {
+            stbi_set_flip_vertically_on_load(flipY);
+
+            decoded = LoadAssetImage(path, width, height);
+            if (!decoded)
+            {
+                std::cerr << "Failed to load texture '" << path << "': " << stbi_failure_reason() << "\n";
+                return Texture2D{};
+            }
+            pixels = decoded;
+        }
+
+        contentHash = HashImage(path, cooked ? images : nullptr, pixels, width, height);
+        hashed = true;
+
+        // Same pixels under another path: share that texture.
+        const auto same = mContentKeys.find(contentHash);
+        if (same != mContentKeys.end())
+        {
+            Entry& original = mTextures[same->second];
+            if (original.texture.width == width && original.texture.height == height)
+            {
+                stbi_image_free(decoded);
+
+                if (original.refs++ == 0)
+                    --mUnreferenced;
+                original.aliases.push_back(key);
+                mAliases.emplace(key, same->second);
+                ++mDedupedImages;
+                mDedupedBytes += TextureBytes(width, height);
+                return original.texture;
+            }
+        }
+
+        texture = CreateTextureRGBA(pixels, width, height);
+        stbi_image_free(decoded);
+    }
+
+    if (!texture.id)
+        return texture;
+
+    Entry entry;
+    entry.path = path;
+    entry.texture = texture;
+    entry.refs = 1;
+    entry.hashed = hashed;
+    entry.contentHash = contentHash;
+    mTextures.emplace(key, std::move(entry));
+    mTextureKeys.emplace(texture.id, key);
+    if (hashed)
+        mContentKeys.emplace(contentHash, key);
+
+    mUploadedBytes += TextureBytes(width, height);
+    mResidentBytes += TextureBytes(width, height);
+    if (!flipY)
+        mResidency.Track(texture.id, TextureBytes(width, height));
+    return texture;
+}
+
+bool TextureRegistry::AcquireAtlasRegion(const std::string& path, const ImageSource* images,
+    int expectedWidth, int expectedHeight, AtlasRegion& outRegion)
+{
+    const std::string key = CanonicalPath(path);
+
+    const auto alias = mAtlasAliases.find(key);
+    auto it = mAtlasImages.find(alias != mAtlasAliases.end() ? alias->second : key);
+    if (it != mAtlasImages.end())
+    {
+        ++mHits;
+        ++it->second.refs;
+        ++mAtlasPages[it->second.region.page].refs;
+        outRegion = it->second.region;
+        return true;
+    }
+
+    if (mUnpackable.count(key))
+        return false;
+
+    int width = 0, height = 0;
+    const uint8_t* cooked = nullptr;
+    unsigned char* decoded = nullptr;
+
+    if (!images || !images->FindImage(path, cooked, width, height))
+    {
+        // Reserve now at the header's size (not the expected one, so the
+        // region fits what's decoded) and stream the pixels in later.
+        const bool streamed = expectedWidth > 0 && expectedHeight > 0 && ReadAssetImageSize(path, width, height);
+        if (!streamed)
+        {
+            stbi_set_flip_vertically_on_load(false);
+
+            decoded = LoadAssetImage(path, width, height);
+            if (!decoded)
+                return false; // unreadable: Acquire() reports it
+            cooked = decoded;
+        }
+    }
+
+    bool hashed = false;
+    uint64_t contentHash = 0;
+    if (cooked)
+    {
+        contentHash = HashImage(path, decoded ? nullptr : images, cooked, width, height);
+        hashed = true;
+
+        // Same pixels under another path: share that region.
+        const auto same = mAtlasContentKeys.find(contentHash);
+        if (same != mAtlasContentKeys.end())
+        {
+            AtlasEntry& original = mAtlasImages[same->second];
+            if (original.width == width && original.height == height)
+            {
+                stbi_image_free(decoded);
+
+                ++mMisses;
+                ++original.refs;
+                ++mAtlasPages[original.region.page].refs;
+                mAtlasAliases.emplace(key, same->second);
+                ++mDedupedImages;
+                mDedupedBytes += TextureBytes(width, height);
+                outRegion = original.region;
+                return true;
+            }
+        }
+    }
+
+    AtlasRegion region{};
+    const bool packed = mAtlas.Reserve(width, height, region);
+    if (packed)
+    {
+        if (mResidency.IsEvicted(region.texture))
+        {
+            // Landed on an evicted page: it comes back (this image
+            // included) on the next UpdateResidency().
+            mResidency.MarkUsed(region.texture);
+        }
+        else if (cooked)
+        {
+            glBindTexture(GL_TEXTURE_2D, region.texture);
+            glTexSubImage2D(GL_TEXTURE_2D, 0, region.x, region.y, width, height, GL_RGBA, GL_UNSIGNED_BYTE, cooked);
+        }
+        else
+        {
+            mUploader.Enqueue(path, region.texture, region.x, region.y, width, height, false);
+        }
+    }
+    stbi_image_free(decoded);
+
+    if (!packed)
+    {
+        // Too big for a page: remembered so later maps skip the decode.
+        mUnpackable.insert(key);
+        return false;
+    }
+
+    ++mMisses;
+    mUploadedBytes += TextureBytes(width, height);
+
+    if ((int)mAtlasPages.size() < mAtlas.GetPageCount())
+        mAtlasPages.resize((size_t)mAtlas.GetPageCount());
+
+    AtlasPage& page = mAtlasPages[region.page];
+    if (page.texture != region.texture)
+    {
+        // A new page (or a freed slot made again).
+        const size_t pageBytes = TextureBytes(mAtlas.GetPageSizePx(), mAtlas.GetPageSizePx());
+        mResidentBytes += pageBytes;
+        mResidency.Track(region.texture, pageBytes);
+        page = AtlasPage{};
+        page.texture = region.texture;
+    }
+
+    mAtlasImages.emplace(key, AtlasEntry{ path, region, width, height, 1, hashed, contentHash });
+    mAtlasRegionKeys.emplace(AtlasRegionKey(region), key);
+    if (hashed)
+        mAtlasContentKeys.emplace(contentHash, key);
+    ++page.refs;
+    outRegion = region;
+    return true;
+}
+
+void TextureRegistry::Release(GLuint texture)
+{
+    const auto keyIt = mTextureKeys.find(texture);
+    if (keyIt == mTextureKeys.end())
+        return;
+
+    Entry& entry = mTextures[keyIt->second];
+    if (entry.refs <= 0)
+        return;
+
+    if (--entry.refs == 0)
+    {
+        entry.releasedAt = Clock::now();
+        ++mUnreferenced;
+    }
+}
+
+void TextureRegistry::ReleaseAtlasRegion(const AtlasRegion& region)
+{
+    // By region, like Release() by name: it stays right after a hot reload
+    // split the path off the image it was sharing.
+    const auto keyIt = mAtlasRegionKeys.find(AtlasRegionKey(region));
+    if (keyIt == mAtlasRegionKeys.end())
+        return;
+
+    auto it = mAtlasImages.find(keyIt->second);
+    if (it == mAtlasImages.end() || it->second.refs <= 0)
+        return;
+
+    --it->second.refs;
+    AtlasPage& page = mAtlasPages[it->second.region.page];
+    if (--page.refs == 0)
+        page.releasedAt = Clock::now();
+}
+
+void TextureRegistry::CancelAtlasUploads()
+{
+    for (const AtlasPage& page : mAtlasPages)
+    {
+        if (page.texture)
+            mUploader.Cancel(page.texture);
+    }
+}
+
+void TextureRegistry::ClearAtlas()
+{
+    CancelAtlasUploads();
+    for (const AtlasPage& page : mAtlasPages)
+    {
+        if (page.texture)
+            mResidency.Untrack(page.texture);
+    }
+
+    mAtlas.Clear();
+    mAtlasPages.clear();
+    mAtlasImages.clear();
+    mAtlasAliases.clear();
+    mAtlasRegionKeys.clear();
+    mAtlasContentKeys.clear();
+}
+
+void TextureRegistry::FreeAtlasPage(int page)
+{
+    const GLuint texture = mAtlasPages[page].texture;
+    mUploader.Cancel(texture);
+    mResidency.Untrack(texture);
+
+    for (auto it = mAtlasImages.begin(); it != mAtlasImages.end();)
+    {
+        if (it->second.region.page != page)
+        {
+            ++it;
+            continue;
+        }
+
+        const AtlasEntry& entry = it->second;
+        const auto content = entry.hashed ? mAtlasContentKeys.find(entry.contentHash) : mAtlasContentKeys.end();
+        if (content != mAtlasContentKeys.end() && content->second == it->first)
+            mAtlasContentKeys.erase(content);
+
+        mAtlasRegionKeys.erase(AtlasRegionKey(entry.region));
+        it = mAtlasImages.erase(it);
+    }
+
+    for (auto it = mAtlasAliases.begin(); it != mAtlasAliases.end();)
+    {
+        if (mAtlasImages.count(it->second))
+            ++it;
+        else
+            it = mAtlasAliases.erase(it);
+    }
+
+    mAtlas.FreePage(page);
+    mAtlasPages[page] = AtlasPage{};
+}
+
+int TextureRegistry::FindAtlasPage(GLuint texture) const
+{
+    for (int page = 0; page < mAtlas.GetPageCount(); ++page)
+    {
+        if (mAtlas.GetPageTexture(page) == texture)
+            return page;
+    }
+    return -1;
+}
+
+size_t TextureRegistry::Collect()
+{
+    bool atlasIdle = false;
+    for (const AtlasPage& page : mAtlasPages)
+        atlasIdle = atlasIdle || (page.texture && page.refs == 0);
+    if (mUnreferenced == 0 && !atlasIdle)
+        return 0;
+
+    const Clock::time_point now = Clock::now();
+    auto Expired = [&](Clock::time_point releasedAt)
+        {
+            return std::chrono::duration<double>(now - releasedAt).count() >= mGracePeriodSeconds;
+        };
+
+    size_t deleted = 0;
+    for (auto it = mTextures.begin(); it != mTextures.end();)
+    {
+        Entry& entry = it->second;
+        if (entry.refs > 0 || !Expired(entry.releasedAt))
+        {
+            ++it;
+            continue;
+        }
+
+        const size_t bytes = TextureBytes(entry.texture.width, entry.texture.height);
+        if (!mResidency.IsEvicted(entry.texture.id))
+        {
+            mResidentBytes -= bytes;
+            mReclaimedBytes += bytes;
+        }
+        ++mReclaimedTextures;
+        --mUnreferenced;
+        ++deleted;
+
+        mResidency.Untrack(entry.texture.id);
+        mUploader.Cancel(entry.texture.id);
+        glDeleteTextures(1, &entry.texture.id);
+        mTextureKeys.erase(entry.texture.id);
+
+        for (const std::string& alias : entry.aliases)
+            mAliases.erase(alias);
+        const auto content = entry.hashed ? mContentKeys.find(entry.contentHash) : mContentKeys.end();
+        if (content != mContentKeys.end() && content->second == it->first)
+            mContentKeys.erase(content);
+
+        it = mTextures.erase(it);
+    }
+
+    // Pages go one by one, as soon as all of their images are unreferenced.
+    const size_t pageBytes = TextureBytes(mAtlas.GetPageSizePx(), mAtlas.GetPageSizePx());
+    for (int page = 0; atlasIdle && page < (int)mAtlasPages.size(); ++page)
+    {
+        const AtlasPage& state = mAtlasPages[page];
+        if (!state.texture || state.refs > 0 || !Expired(state.releasedAt))
+            continue;
+
+        if (!mResidency.IsEvicted(state.texture))
+        {
+            mResidentBytes -= pageBytes;
+            mReclaimedBytes += pageBytes;
+        }
+        ++mReclaimedTextures;
+        ++deleted;
+
+        FreeAtlasPage(page);
+    }
+
+    return deleted;
+}
+
+void TextureRegistry::Clear()
+{
+    for (auto& [key, entry] : mTextures)
+    {
+        mResidency.Untrack(entry.texture.id);
+        mUploader.Cancel(entry.texture.id);
+        glDeleteTextures(1, &entry.texture.id);
+    }
+
+    mTextures.clear();
+    mTextureKeys.clear();
+    mAliases.clear();
+    mContentKeys.clear();
+
+    ClearAtlas();
+    mUnpackable.clear();
+
+    mUnreferenced = 0;
+    mResidentBytes = 0;
+}
+
+bool TextureRegistry::SplitTexture(const std::string& key)
+{
+    const auto alias = mAliases.find(key);
+    if (alias != mAliases.end())
+    {
+        std::vector<std::string>& aliases = mTextures[alias->second].aliases;
+        aliases.erase(std::remove(aliases.begin(), aliases.end(), key), aliases.end());
+        mAliases.erase(alias);
+        return true;
+    }
+
+    const auto it = mTextures.find(key);
+    if (it == mTextures.end() || it->second.aliases.empty())
+        return false;
+
+    // The texture keeps the old pixels: the first alias owns it from now on.
+    Entry entry = std::move(it->second);
+    mTextures.erase(it);
+
+    const std::string owner = entry.aliases.front();
+    entry.aliases.erase(entry.aliases.begin());
+    entry.path = owner.substr(0, owner.rfind('|'));
+    mAliases.erase(owner);
+    for (const std::string& other : entry.aliases)
+        mAliases[other] = owner;
+
+    mTextureKeys[entry.texture.id] = owner;
+    const auto content = entry.hashed ? mContentKeys.find(entry.contentHash) : mContentKeys.end();
+    if (content != mContentKeys.end() && content->second == key)
+        content->second = owner;
+
+    mTextures.emplace(owner, std::move(entry));
+    return true;
+}
+
+bool TextureRegistry::SplitAtlasImage(const std::string& key)
+{
+    const auto alias = mAtlasAliases.find(key);
+    if (alias != mAtlasAliases.end())
+    {
+        mAtlasAliases.erase(alias);
+        return true;
+    }
+
+    const auto it = mAtlasImages.find(key);
+    if (it == mAtlasImages.end())
+        return false;
+
+    std::string owner;
+    for (const auto& [other, target] : mAtlasAliases)
+    {
+        if (target == key)
+        {
+            owner = other;
+            break;
+        }
+    }
+    if (owner.empty())
+        return false;
+
+    // The region keeps the old pixels: one alias owns it from now on.
+    AtlasEntry entry = std::move(it->second);
+    mAtlasImages.erase(it);
+
+    entry.path = owner;
+    mAtlasAliases.erase(owner);
+    for (auto& [other, target] : mAtlasAliases)
+    {
+        if (target == key)
+            target = owner;
+    }
+
+    mAtlasRegionKeys[AtlasRegionKey(entry.region)] = owner;
+    const auto content = entry.hashed ? mAtlasContentKeys.find(entry.contentHash) : mAtlasContentKeys.end();
+    if (content != mAtlasContentKeys.end() && content->second == key)
+        content->second = owner;
+
+    mAtlasImages.emplace(owner, std::move(entry));
+    return true;
+}
+
+size_t TextureRegistry::ReloadImage(const std::string& path, bool& outSplit)
+{
+    const std::string canonical = CanonicalPath(path);
+    size_t updated = 0;
+    outSplit = false;
+
+    auto Decode = [&](bool flipY, int& width, int& height) -> unsigned char*
+        {
+            stbi_set_flip_vertically_on_load(flipY);
+            unsigned char* decoded = LoadAssetImage(path, width, height);
+            if (!decoded)
+                std::cerr << "Failed to reload '" << path << "': " << stbi_failure_reason() << "\n";
+            return decoded;
+        };
+
+    for (const bool flipY : { false, true })
+    {
+        const std::string key = canonical + (flipY ? "|flip" : kNoFlipSuffix);
+
+        // Shared with identical images: writing it would change them too.
+        if (SplitTexture(key))
+        {
+            outSplit = true;
+            continue;
+        }
+
+        const auto it = mTextures.find(key);
+        if (it == mTextures.end())
+            continue;
+
+        Entry& entry = it->second;
+
+        // Its pixels no longer match the hash: nothing may alias it from now on.
+        const auto content = entry.hashed ? mContentKeys.find(entry.contentHash) : mContentKeys.end();
+        if (content != mContentKeys.end() && content->second == it->first)
+            mContentKeys.erase(content);
+        entry.hashed = false;
+
+        if (mUploader.IsPending(entry.texture.id))
+        {
+            // Still a placeholder (or half streamed): stream the new file instead.
+            mUploader.Cancel(entry.texture.id);
+            mUploader.Enqueue(entry.path, entry.texture.id, 0, 0, entry.texture.width, entry.texture.height, true);
+            ++updated;
+            continue;
+        }
+
+        int width = 0, height = 0;
+        unsigned char* decoded = Decode(flipY, width, height);
+        if (!decoded)
+            continue;
+
+        if (width != entry.texture.width || height != entry.texture.height)
+        {
+            std::cerr << "'" << path << "' changed size (" << entry.texture.width << "x" << entry.texture.height
+                << " -> " << width << "x" << height << "); reload its tileset to pick it up\n";
+        }
+        else if (!mResidency.IsEvicted(entry.texture.id))
+        {
+            // An evicted texture streams the file back in when it's drawn again.
+            glBindTexture(GL_TEXTURE_2D, entry.texture.id);
+            glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, width, height, GL_RGBA, GL_UNSIGNED_BYTE, decoded);
+            ++updated;
+        }
+        stbi_image_free(decoded);
+    }
+
+    const bool atlasSplit = SplitAtlasImage(canonical);
+    outSplit = outSplit || atlasSplit;
+
+    const auto atlasIt = atlasSplit ? mAtlasImages.end() : mAtlasImages.find(canonical);
+    if (atlasIt != mAtlasImages.end())
+    {
+        AtlasEntry& entry = atlasIt->second;
+
+        const auto content = entry.hashed ? mAtlasContentKeys.find(entry.contentHash) : mAtlasContentKeys.end();
+        if (content != mAtlasContentKeys.end() && content->second == atlasIt->first)
+            mAtlasContentKeys.erase(content);
+        entry.hashed = false;
+
+        int width = 0, height = 0;
+        unsigned char* decoded = Decode(false, width, height);
+        if (decoded && (width != entry.width || height != entry.height))
+        {
+            std::cerr << "'" << path << "' changed size (" << entry.width << "x" << entry.height
+                << " -> " << width << "x" << height << "); reload its tileset to pick it up\n";
+        }
+        else if (decoded && !mResidency.IsEvicted(entry.region.texture))
+        {
+            glBindTexture(GL_TEXTURE_2D, entry.region.texture);
+            glTexSubImage2D(GL_TEXTURE_2D, 0, entry.region.x, entry.region.y, width, height,
+                GL_RGBA, GL_UNSIGNED_BYTE, decoded);
+            ++updated;
+        }
+        stbi_image_free(decoded);
+    }
+
+    if (outSplit)
+        std::cout << "'" << path << "' was shared with identical image(s); its tilesets get a copy of their own\n";
+
+    return updated;
+}
+
+void TextureRegistry::StreamImage(const std::string& path, GLuint texture, int x, int y,
+    int width, int height, bool allocate)
+{
+    const uint8_t* cooked = nullptr;
+    int cookedWidth = 0, cookedHeight = 0;
+    if (mReloadSource && mReloadSource->FindImage(path, cooked, cookedWidth, cookedHeight)
+        && cookedWidth == width && cookedHeight == height)
+    {
+        mUploader.EnqueuePixels(path, texture, x, y, cooked, width, height, allocate);
+        return;
+    }
+
+    mUploader.Enqueue(path, texture, x, y, width, height, allocate);
+}
+
+void TextureRegistry::Evict(GLuint texture)
+{
+    mUploader.Cancel(texture);
+
+    const size_t bytes = mResidency.GetBytes(texture);
+    mResidentBytes -= std::min(bytes, mResidentBytes);
+
+    const int page = FindAtlasPage(texture);
+    if (page >= 0)
+    {
+        mAtlas.ReleasePageStorage(page);
+        return;
+    }
+
+    // Same name, 1x1 storage: meshes and tile tables that hold it stay valid.
+    static const unsigned char kTransparent[4] = { 0, 0, 0, 0 };
+    glBindTexture(GL_TEXTURE_2D, texture);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, 1, 1, 0, GL_RGBA, GL_UNSIGNED_BYTE, kTransparent);
+}
+
+void TextureRegistry::Reload(GLuint texture)
+{
+    mResidentBytes += mResidency.GetBytes(texture);
+
+    const int page = FindAtlasPage(texture);
+    if (page >= 0)
+    {
+        mAtlas.RestorePageStorage(page);
+        for (const auto& [key, entry] : mAtlasImages)
+        {
+            if (entry.region.page == page)
+                StreamImage(entry.path, texture, entry.region.x, entry.region.y, entry.width, entry.height, false);
+        }
+        return;
+    }
+
+    const auto keyIt = mTextureKeys.find(texture);
+    if (keyIt == mTextureKeys.end())
+        return;
+
+    const Entry& entry = mTextures[keyIt->second];
+    StreamImage(entry.path, texture, 0, 0, entry.texture.width, entry.texture.height, true);
+}
+
+size_t TextureRegistry::UpdateResidency()
+{
+    mResidency.NextFrame();
+
+    mResidency.TakeReloads(mResidencyScratch);
+    for (GLuint texture : mResidencyScratch)
+        Reload(texture);
+
+    mResidency.TakeEvictions(mResidencyScratch);
+    for (GLuint texture : mResidencyScratch)
+        Evict(texture);
+
+    return mResidencyScratch.size();
+}
+
+std::unordered_set<std::string> TextureRegistry::GetResidentPaths() const
+{
+    const size_t suffixLength = std::char_traits<char>::length(kNoFlipSuffix);
+
+    std::unordered_set<std::string> paths;
+    paths.reserve(mTextures.size() + mAliases.size() + mAtlasImages.size() + mAtlasAliases.size());
+
+    auto AddUnflipped = [&](const std::string& key)
+        {
+            if (key.size() > suffixLength && key.compare(key.size() - suffixLength, suffixLength, kNoFlipSuffix) == 0)
+                paths.insert(key.substr(0, key.size() - suffixLength));
+        };
+
+    for (const auto& [key, entry] : mTextures)
+        AddUnflipped(key);
+    for (const auto& [key, target] : mAliases)
+        AddUnflipped(key);
+    for (const auto& [key, entry] : mAtlasImages)
+        paths.insert(key);
+    for (const auto& [key, target] : mAtlasAliases)
+        paths.insert(key);
+    return paths;
+}
+
+TextureRegistryStats TextureRegistry::GetStats() const
+{
+    TextureRegistryStats stats{};
+    stats.hits = mHits;
+    stats.misses = mMisses;
+    stats.uploadedBytes = mUploadedBytes;
+    stats.residentTextures = mTextures.size();
+    stats.residentBytes = mResidentBytes;
+    stats.reclaimedTextures = mReclaimedTextures;
+    stats.reclaimedBytes = mReclaimedBytes;
+    stats.dedupedImages = mDedupedImages;
+    stats.dedupedBytes = mDedupedBytes;
+    stats.atlasImages = mAtlas.GetImageCount();
+    stats.atlasPages = mAtlas.GetLivePageCount();
+
+    const TextureUploaderStats uploads = mUploader.GetStats();
+    stats.pendingUploads = uploads.queued + uploads.streaming;
+    stats.streamedBytes = uploads.streamedBytes;
+
+    const TextureResidencyStats residency = mResidency.GetStats();
+    stats.budgetBytes = residency.budgetBytes;
+    stats.evictedTextures = residency.evictedTextures;
+    stats.evictions = residency.evictions;
+    stats.reloads = residency.reloads;
+
+    stats.unreferenced = mUnreferenced;
+    for (const auto& [key, entry] : mAtlasImages)
+        stats.unreferenced += entry.refs == 0 ? 1 : 0;
+
+    return stats;
+}
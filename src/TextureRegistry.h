@@ -0,0 +1,252 @@
+#pragma once
+
+#include <glad/glad.h>
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "TextureAtlas.h"
+#include "TextureResidency.h"
+#include "TextureUploader.h"
+
+class ImageSource;
+
+/*
+    Texture2D
+    ---------
+    Small helper so we can keep:
+      - OpenGL texture ID
+      - the original image width/height (needed for atlas UV calculations)
+*/
+struct Texture2D
+{
+    GLuint id = 0;
+    int width = 0;
+    int height = 0;
+};
+
+// Upload RGBA8 pixels (rows top to bottom) as a new texture.
+Texture2D CreateTextureRGBA(const unsigned char* pixels, int width, int height);
+
+struct TextureRegistryStats
+{
+    size_t hits = 0;
+    size_t misses = 0;
+    size_t uploadedBytes = 0;     // every upload so far (base level)
+    size_t residentTextures = 0;  // standalone textures, atlas pages excluded
+    size_t residentBytes = 0;     // standalone textures + atlas pages (base level), evicted ones excluded
+    size_t unreferenced = 0;      // textures / atlas images waiting out the grace period
+    size_t reclaimedTextures = 0;
+    size_t reclaimedBytes = 0;
+    size_t pendingUploads = 0;    // placeholders still decoding / streaming
+    size_t streamedBytes = 0;     // through the uploader's PBO ring
+    int atlasImages = 0;
+    int atlasPages = 0;
+    size_t budgetBytes = 0;       // VRAM budget of the residency manager
+    size_t evictedTextures = 0;   // currently down to a 1x1 placeholder
+    size_t evictions = 0;
+    size_t reloads = 0;
+    size_t dedupedImages = 0;     // acquires served by an identical image already resident
+    size_t dedupedBytes = 0;      // uploads those skipped
+};
+
+/*
+    TextureRegistry
+    ---------------
+    Process-wide, reference-counted textures keyed by canonical path, so a
+    map change only decodes and uploads images the previous map didn't
+    already have.
+
+      - Acquire() returns a standalone texture and takes a reference.
+        Pixels the image source has are uploaded right away. Otherwise,
+        when the caller knows the image size (the TSX does), the id is a
+        1x1 transparent placeholder until TextureUploader has decoded and
+        streamed the file into it; without a size it's a blocking decode.
+        The placeholder is laid out at the size in the file's header
+        (ReadAssetImageSize), so a TSX that's out of date with its PNG
+        doesn't leave wrong UVs behind.
+      - AcquireAtlasRegion() packs the image into the shared atlas instead,
+        with the same placeholder rule (the region stays transparent until
+        streamed). False when it can't be packed (too big for a page or
+        unreadable); the caller then falls back to Acquire().
+      - Release() drops a reference. Unreferenced textures stay resident
+        for the grace period, so walking back through a door is free, and
+        are deleted by Collect() after that.
+
+    Atlas space can't be freed per image: a page is deleted (its slot
+    reused by the next new page) once none of its images has been
+    referenced for the grace period.
+
+    Images are also deduplicated by content: whenever the pixels are in
+    hand at acquire time (image source or blocking decode) they're hashed
+    (HashPixels), and a path whose pixels match a resident image of the
+    same size becomes an alias of it, sharing its texture / region and
+    reference count. Streamed images are uploaded before their pixels are
+    known and are only ever matched by later acquires.
+
+    On top of that, TextureResidency keeps the GPU bytes under a budget
+    whether or not the textures are referenced. UpdateResidency() drops
+    the pixels of the least recently drawn textures and atlas pages (the
+    name stays valid, reduced to 1x1 transparent), and streams them back
+    in through the uploader when the renderer draws them again: from the
+    reload source's cooked pixels when it has them, else from the file.
+    Only unflipped images are managed; a flipped one can't be re-streamed.
+
+    Needs a current GL context, like TextureAtlas.
+*/
+class TextureRegistry
+{
+public:
+    explicit TextureRegistry(double gracePeriodSeconds = 20.0, size_t uploadBudgetBytes = 4u * 1024u * 1024u,
+        size_t vramBudgetBytes = 512u * 1024u * 1024u);
+    ~TextureRegistry();
+
+    TextureRegistry(const TextureRegistry&) = delete;
+    TextureRegistry& operator=(const TextureRegistry&) = delete;
+
+    // id 0 on failure (logged). Width / height are the expected size (0 = unknown):
+    // non-zero streams the image in, at the size its header gives.
+    Texture2D Acquire(const std::string& path, bool flipY, const ImageSource* images = nullptr,
+        int expectedWidth = 0, int expectedHeight = 0);
+    bool AcquireAtlasRegion(const std::string& path, const ImageSource* images,
+        int expectedWidth, int expectedHeight, AtlasRegion& outRegion);
+
+    void Release(GLuint texture);
+    void ReleaseAtlasRegion(const AtlasRegion& region);
+
+    // Main thread, once per frame: stream decoded placeholders (up to the
+    // upload budget). Returns the bytes uploaded.
+    size_t PumpUploads() { return mUploader.Pump(); }
+
+    // Main thread, once per frame. Returns the number of textures deleted.
+    size_t Collect();
+
+    // Main thread, once per frame before drawing: reload evicted textures
+    // drawn last frame, then evict down to the budget. Returns the number
+    // of textures evicted.
+    size_t UpdateResidency();
+
+    // The renderer reports draws here; the budget is set here too.
+    TextureResidency& GetResidency() { return mResidency; }
+
+    // Where evicted textures are reloaded from first (the current map's
+    // bundle). Not owned; may be null.
+    void SetReloadSource(const ImageSource* images) { mReloadSource = images; }
+
+    // Deletes everything, referenced or not.
+    void Clear();
+
+    // Hot reload: re-decodes path and writes it over every texture / atlas
+    // region holding it with glTexSubImage2D (same names, same regions, so
+    // nothing that holds them changes). An image whose size changed is
+    // skipped (logged): its tileset has to be reloaded. Returns the number
+    // of textures / regions updated.
+    // A path sharing its texture / region with identical images (dedupe)
+    // isn't written: it's split off instead, the others keep the old pixels,
+    // and outSplit is set. Its tilesets then have to be acquired again
+    // (TilesetRegistry::Retire) to give it a texture of its own.
+    size_t ReloadImage(const std::string& path, bool& outSplit);
+
+    TextureRegistryStats GetStats() const;
+
+    // Canonical paths of every image held unflipped (textures + atlas).
+    std::unordered_set<std::string> GetResidentPaths() const;
+
+    // weakly_canonical, falling back to the lexically normal path.
+    static std::string CanonicalPath(const std::string& path);
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    struct Entry
+    {
+        std::string path; // as acquired, for reloads
+        Texture2D texture;
+        int refs = 0;
+        Clock::time_point releasedAt{};
+        bool hashed = false;
+        uint64_t contentHash = 0;
+        std::vector<std::string> aliases; // keys in mAliases
+    };
+
+    struct AtlasEntry
+    {
+        std::string path;
+        AtlasRegion region;
+        int width = 0;
+        int height = 0;
+        int refs = 0;
+        bool hashed = false;
+        uint64_t contentHash = 0;
+    };
+
+    // References summed over an atlas page's images.
+    struct AtlasPage
+    {
+        GLuint texture = 0; // tracked by the residency manager
+        int refs = 0;
+        Clock::time_point releasedAt{};
+    };
+
+    static constexpr const char* kNoFlipSuffix = "|noflip";
+
+    void CancelAtlasUploads();
+    void ClearAtlas();
+    void FreeAtlasPage(int page);
+
+    static uint64_t AtlasRegionKey(const AtlasRegion& region)
+    {
+        return ((uint64_t)region.page << 42) | ((uint64_t)region.x << 21) | (uint64_t)region.y;
+    }
+
+    // Hot reload: take key out of a deduplicated texture / region. False
+    // when it shares nothing. When it owns the shared one, an alias takes
+    // the entry over.
+    bool SplitTexture(const std::string& key);
+    bool SplitAtlasImage(const std::string& key);
+    int FindAtlasPage(GLuint texture) const;
+
+    // Queue an upload of `path` into texture at (x, y), preferring the reload source.
+    void StreamImage(const std::string& path, GLuint texture, int x, int y, int width, int height, bool allocate);
+    void Evict(GLuint texture);
+    void Reload(GLuint texture);
+
+    // Pixel hash of an image the source / a decode handed us.
+    static uint64_t HashImage(const std::string& path, const ImageSource* images, const uint8_t* rgba, int width, int height);
+
+    static size_t TextureBytes(int width, int height) { return (size_t)width * (size_t)height * 4; }
+
+    double mGracePeriodSeconds = 20.0;
+    TextureUploader mUploader;
+    TextureResidency mResidency;
+    const ImageSource* mReloadSource = nullptr;
+    std::vector<GLuint> mResidencyScratch;
+
+    std::unordered_map<std::string, Entry> mTextures; // canonical path + flip
+    std::unordered_map<GLuint, std::string> mTextureKeys;
+    std::unordered_map<std::string, std::string> mAliases; // canonical path + flip -> mTextures key with the same pixels
+    std::unordered_map<uint64_t, std::string> mContentKeys; // content hash -> mTextures key
+
+    TextureAtlas mAtlas;
+    std::unordered_map<std::string, AtlasEntry> mAtlasImages; // canonical path
+    std::unordered_map<std::string, std::string> mAtlasAliases; // canonical path -> mAtlasImages key with the same pixels
+    std::unordered_map<uint64_t, std::string> mAtlasRegionKeys; // AtlasRegionKey -> mAtlasImages key
+    std::unordered_map<uint64_t, std::string> mAtlasContentKeys; // content hash -> mAtlasImages key
+    std::unordered_set<std::string> mUnpackable;              // known not to fit a page
+    std::vector<AtlasPage> mAtlasPages; // per mAtlas page slot
+
+    size_t mUnreferenced = 0;
+    size_t mResidentBytes = 0;
+    size_t mHits = 0;
+    size_t mMisses = 0;
+    size_t mUploadedBytes = 0;
+    size_t mReclaimedTextures = 0;
+    size_t mReclaimedBytes = 0;
+    size_t mDedupedImages = 0;
+    size_t mDedupedBytes = 0;
+};
@@ -0,0 +1,128 @@
+#include "TextureResidency.h"
+
+#include <algorithm>
+
+TextureResidency::TextureResidency(size_t budgetBytes)
+    : mBudgetBytes(budgetBytes)
+{
+}
+
+void TextureResidency::Track(GLuint texture, size_t bytes)
+{
+    if (texture == 0)
+        return;
+
+    if (texture >= mUnits.size())
+        mUnits.resize((size_t)texture + 1);
+
+    Untrack(texture);
+
+    Unit& unit = mUnits[texture];
+    unit.bytes = bytes;
+    unit.lastUsedFrame = mFrame; // new textures get a frame to be drawn before they're candidates
+    unit.tracked = true;
+
+    mResidentBytes += bytes;
+    ++mTracked;
+}
+
+void TextureResidency::Untrack(GLuint texture)
+{
+    if (texture >= mUnits.size() || !mUnits[texture].tracked)
+        return;
+
+    Unit& unit = mUnits[texture];
+    if (unit.evicted)
+    {
+        mEvictedBytes -= unit.bytes;
+        --mEvicted;
+    }
+    else
+    {
+        mResidentBytes -= unit.bytes;
+    }
+    --mTracked;
+
+    // A queued reload for this name is skipped by TakeReloads().
+    unit = Unit{};
+}
+
+bool TextureResidency::IsEvicted(GLuint texture) const
+{
+    return texture < mUnits.size() && mUnits[texture].tracked && mUnits[texture].evicted;
+}
+
+void TextureResidency::TakeReloads(std::vector<GLuint>& outTextures)
+{
+    outTextures.clear();
+
+    for (GLuint texture : mReloads)
+    {
+        Unit& unit = mUnits[texture];
+        if (!unit.reloadQueued)
+            continue;
+
+        unit.reloadQueued = false;
+        if (!unit.tracked || !unit.evicted)
+            continue;
+
+        unit.evicted = false;
+        mEvictedBytes -= unit.bytes;
+        mResidentBytes += unit.bytes;
+        --mEvicted;
+        ++mReloadCount;
+        outTextures.push_back(texture);
+    }
+    mReloads.clear();
+}
+
+void TextureResidency::TakeEvictions(std::vector<GLuint>& outTextures)
+{
+    outTextures.clear();
+    if (mResidentBytes <= mBudgetBytes)
+        return;
+
+    // Drawn last frame (or this one) = on screen; never a candidate.
+    mCandidates.clear();
+    for (size_t i = 0; i < mUnits.size(); ++i)
+    {
+        const Unit& unit = mUnits[i];
+        if (unit.tracked && !unit.evicted && unit.lastUsedFrame + 1 < mFrame)
+            mCandidates.push_back((GLuint)i);
+    }
+
+    std::sort(mCandidates.begin(), mCandidates.end(),
+        [this](GLuint a, GLuint b) { return mUnits[a].lastUsedFrame < mUnits[b].lastUsedFrame; });
+
+    for (GLuint texture : mCandidates)
+    {
+        if (mResidentBytes <= mBudgetBytes)
+            break;
+
+        Unit& unit = mUnits[texture];
+        unit.evicted = true;
+        mResidentBytes -= unit.bytes;
+        mEvictedBytes += unit.bytes;
+        ++mEvicted;
+        ++mEvictions;
+        outTextures.push_back(texture);
+    }
+}
+
+size_t TextureResidency::GetBytes(GLuint texture) const
+{
+    return texture < mUnits.size() && mUnits[texture].tracked ? mUnits[texture].bytes : 0;
+}
+
+TextureResidencyStats TextureResidency::GetStats() const
+{
+    TextureResidencyStats stats{};
+    stats.budgetBytes = mBudgetBytes;
+    stats.residentBytes = mResidentBytes;
+    stats.evictedBytes = mEvictedBytes;
+    stats.trackedTextures = mTracked;
+    stats.evictedTextures = mEvicted;
+    stats.evictions = mEvictions;
+    stats.reloads = mReloadCount;
+    return stats;
+}
@@ -0,0 +1,101 @@
+#pragma once
+
+#include <glad/glad.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+struct TextureResidencyStats
+{
+    size_t budgetBytes = 0;
+    size_t residentBytes = 0;    // tracked textures that currently hold their pixels
+    size_t evictedBytes = 0;     // tracked textures reduced to a 1x1 placeholder
+    size_t trackedTextures = 0;
+    size_t evictedTextures = 0;
+    size_t evictions = 0;        // since startup
+    size_t reloads = 0;
+};
+
+/*
+    TextureResidency
+    ----------------
+    Bookkeeping for a VRAM budget. Knows nothing about GL beyond texture
+    names; TextureRegistry does the actual freeing and re-uploading:
+
+      - Track() / Untrack() as textures (or atlas pages) are created and
+        deleted, with their estimated GPU bytes.
+      - MarkUsed() from the renderer every time a texture is bound, which
+        stamps it with the current frame.
+      - NextFrame(), once per frame before drawing.
+      - TakeEvictions() hands out the least recently drawn textures until
+        the resident total is back under the budget. Anything drawn in the
+        previous frame is kept, so an over-budget but fully visible scene
+        doesn't thrash.
+      - An evicted texture that gets drawn again is queued for reload;
+        TakeReloads() hands those out.
+
+    Texture names are small integers, so state lives in a vector indexed
+    by name: MarkUsed() is a bounds check and a store.
+*/
+class TextureResidency
+{
+public:
+    explicit TextureResidency(size_t budgetBytes);
+
+    void SetBudgetBytes(size_t budgetBytes) { mBudgetBytes = budgetBytes; }
+
+    void Track(GLuint texture, size_t bytes);
+    void Untrack(GLuint texture);
+    bool IsEvicted(GLuint texture) const;
+
+    void MarkUsed(GLuint texture)
+    {
+        if (texture >= mUnits.size() || !mUnits[texture].tracked)
+            return;
+
+        Unit& unit = mUnits[texture];
+        unit.lastUsedFrame = mFrame;
+        if (unit.evicted && !unit.reloadQueued)
+        {
+            unit.reloadQueued = true;
+            mReloads.push_back(texture);
+        }
+    }
+
+    void NextFrame() { ++mFrame; }
+
+    // Evicted textures drawn since the last call; they count as resident
+    // again once handed out.
+    void TakeReloads(std::vector<GLuint>& outTextures);
+
+    // Least recently drawn first; they count as evicted once handed out.
+    void TakeEvictions(std::vector<GLuint>& outTextures);
+
+    size_t GetBytes(GLuint texture) const;
+    TextureResidencyStats GetStats() const;
+
+private:
+    struct Unit
+    {
+        size_t bytes = 0;
+        uint64_t lastUsedFrame = 0;
+        bool tracked = false;
+        bool evicted = false;
+        bool reloadQueued = false;
+    };
+
+    size_t mBudgetBytes = 0;
+    uint64_t mFrame = 1;
+
+    std::vector<Unit> mUnits; // by texture name
+    std::vector<GLuint> mReloads;
+    std::vector<GLuint> mCandidates; // scratch for TakeEvictions()
+
+    size_t mResidentBytes = 0;
+    size_t mEvictedBytes = 0;
+    size_t mTracked = 0;
+    size_t mEvicted = 0;
+    size_t mEvictions = 0;
+    size_t mReloadCount = 0;
+};
@@ -0,0 +1,261 @@
+#include "TextureUploader.h"
+
+#include "AssetFiles.h"
+#include "stb_image.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <iostream>
+
+TextureUploader::TextureUploader(size_t frameBudgetBytes, int workerCount)
+    : mFrameBudgetBytes(std::max<size_t>(frameBudgetBytes, 4096))
+{
+    for (int i = 0; i < std::max(1, workerCount); ++i)
+        mWorkers.emplace_back(&TextureUploader::WorkerLoop, this);
+}
+
+TextureUploader::~TextureUploader()
+{
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        mStopping = true;
+        mQueue.clear();
+    }
+    mWake.notify_all();
+    for (std::thread& worker : mWorkers)
+        worker.join();
+
+    if (mPboBytes > 0)
+        glDeleteBuffers(kRingSize, mPbos);
+}
+
+void TextureUploader::Enqueue(const std::string& path, GLuint texture, int x, int y,
+    int expectedWidth, int expectedHeight, bool allocate)
+{
+    auto job = std::make_shared<Job>();
+    job->path = path;
+    job->texture = texture;
+    job->x = x;
+    job->y = y;
+    job->expectedWidth = expectedWidth;
+    job->expectedHeight = expectedHeight;
+    job->allocate = allocate;
+
+    mJobs.push_back(job);
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        mQueue.push_back(std::move(job));
+    }
+    mWake.notify_one();
+}
+
+void TextureUploader::EnqueuePixels(const std::string& path, GLuint texture, int x, int y,
+    const uint8_t* rgba, int width, int height, bool allocate)
+{
+    auto job = std::make_shared<Job>();
+    job->path = path;
+    job->texture = texture;
+    job->x = x;
+    job->y = y;
+    job->expectedWidth = job->width = width;
+    job->expectedHeight = job->height = height;
+    job->allocate = allocate;
+    job->rgba.assign(rgba, rgba + (size_t)width * (size_t)height * 4);
+    job->decoded = true;
+
+    mJobs.push_back(job);
+    mStreaming.push_back(std::move(job));
+}
+
+void TextureUploader::Cancel(GLuint texture)
+{
+    // Workers skip cancelled jobs; Pump() drops them.
+    for (const std::shared_ptr<Job>& job : mJobs)
+    {
+        if (job->texture == texture)
+            job->cancelled = true;
+    }
+}
+
+bool TextureUploader::IsPending(GLuint texture) const
+{
+    return std::any_of(mJobs.begin(), mJobs.end(), [texture](const std::shared_ptr<Job>& job)
+        {
+            return job->texture == texture && !job->cancelled;
+        });
+}
+
+void TextureUploader::WorkerLoop()
+{
+    stbi_set_flip_vertically_on_load_thread(0);
+
+    for (;;)
+    {
+        std::shared_ptr<Job> job;
+        {
+            std::unique_lock<std::mutex> lock(mMutex);
+            mWake.wait(lock, [this]() { return mStopping || !mQueue.empty(); });
+            if (mStopping)
+                return;
+
+            job = std::move(mQueue.front());
+            mQueue.pop_front();
+            ++mDecoding;
+        }
+
+        double ms = 0.0;
+        if (!job->cancelled)
+        {
+            const auto start = std::chrono::steady_clock::now();
+
+            unsigned char* pixels = LoadAssetImage(job->path, job->width, job->height);
+            if (pixels)
+            {
+                job->rgba.assign(pixels, pixels + (size_t)job->width * (size_t)job->height * 4);
+                job->decoded = true;
+                stbi_image_free(pixels);
+            }
+            else
+            {
+                std::cerr << "Failed to load texture '" << job->path << "': " << stbi_failure_reason() << "\n";
+            }
+
+            ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        }
+
+        std::lock_guard<std::mutex> lock(mMutex);
+        --mDecoding;
+        mDecodeMsTotal += ms;
+        mDecoded.push_back(std::move(job));
+    }
+}
+
+void TextureUploader::CreatePixelBuffers(size_t bytes)
+{
+    if (mPboBytes == 0)
+        glGenBuffers(kRingSize, mPbos);
+
+    // Storage is (re)specified on every band anyway (orphaning).
+    mPboBytes = bytes;
+}
+
+bool TextureUploader::CheckSize(const Job& job) const
+{
+    if (job.nextRow > 0 || (job.width == job.expectedWidth && job.height == job.expectedHeight))
+        return true;
+
+    // A standalone texture takes the decoded size; an atlas region can't grow.
+    std::cerr << "Texture '" << job.path << "' is " << job.width << "x" << job.height << ", expected "
+        << job.expectedWidth << "x" << job.expectedHeight << (job.allocate ? "" : " (atlas region, skipped)") << "\n";
+    return job.allocate;
+}
+
+bool TextureUploader::UploadBand(Job& job, size_t& budget)
+{
+    const size_t rowBytes = (size_t)job.width * 4;
+
+    if (job.nextRow == 0 && job.allocate)
+    {
+        glBindTexture(GL_TEXTURE_2D, job.texture);
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, job.width, job.height, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+    }
+
+    if (rowBytes > mPboBytes)
+        CreatePixelBuffers(rowBytes);
+
+    // At least one row, so a frame whose budget is nearly spent still progresses.
+    const int rowsLeft = job.height - job.nextRow;
+    const size_t budgetRows = std::max<size_t>(1, std::min(budget, mPboBytes) / rowBytes);
+    const int rows = (int)std::min<size_t>((size_t)rowsLeft, budgetRows);
+    const size_t bytes = (size_t)rows * rowBytes;
+
+    const GLuint pbo = mPbos[mNextPbo];
+    mNextPbo = (mNextPbo + 1) % kRingSize;
+
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, pbo);
+    glBufferData(GL_PIXEL_UNPACK_BUFFER, (GLsizeiptr)mPboBytes, nullptr, GL_STREAM_DRAW);
+
+    void* dst = glMapBufferRange(GL_PIXEL_UNPACK_BUFFER, 0, (GLsizeiptr)bytes,
+        GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT);
+    if (dst)
+    {
+        std::memcpy(dst, job.rgba.data() + (size_t)job.nextRow * rowBytes, bytes);
+        glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER);
+
+        glBindTexture(GL_TEXTURE_2D, job.texture);
+        glTexSubImage2D(GL_TEXTURE_2D, 0, job.x, job.y + job.nextRow, job.width, rows,
+            GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+    }
+    else
+    {
+        // Mapping failed: plain upload from client memory.
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+        glBindTexture(GL_TEXTURE_2D, job.texture);
+        glTexSubImage2D(GL_TEXTURE_2D, 0, job.x, job.y + job.nextRow, job.width, rows,
+            GL_RGBA, GL_UNSIGNED_BYTE, job.rgba.data() + (size_t)job.nextRow * rowBytes);
+    }
+
+    // Client-memory uploads elsewhere must not read from the PBO.
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+
+    job.nextRow += rows;
+    budget -= std::min(budget, bytes);
+    mStreamedBytes += bytes;
+    return job.nextRow < job.height;
+}
+
+size_t TextureUploader::Pump()
+{
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        for (std::shared_ptr<Job>& job : mDecoded)
+            mStreaming.push_back(std::move(job));
+        mDecoded.clear();
+    }
+
+    if (mPboBytes == 0 && !mStreaming.empty())
+        CreatePixelBuffers(mFrameBudgetBytes);
+
+    const size_t streamedBefore = mStreamedBytes;
+    size_t budget = mFrameBudgetBytes;
+    while (!mStreaming.empty() && budget > 0)
+    {
+        Job& job = *mStreaming.front();
+
+        const bool uploadable = !job.cancelled && job.decoded && CheckSize(job);
+        if (uploadable && UploadBand(job, budget))
+            continue;
+
+        if (uploadable)
+            ++mCompleted;
+        else if (!job.cancelled)
+            ++mFailed;
+
+        const Job* finished = &job;
+        mJobs.erase(std::remove_if(mJobs.begin(), mJobs.end(),
+            [finished](const std::shared_ptr<Job>& entry) { return entry.get() == finished; }), mJobs.end());
+        mStreaming.pop_front();
+    }
+
+    return mStreamedBytes - streamedBefore;
+}
+
+bool TextureUploader::IsIdle() const
+{
+    return mJobs.empty();
+}
+
+TextureUploaderStats TextureUploader::GetStats() const
+{
+    TextureUploaderStats stats{};
+    stats.streaming = mStreaming.size();
+    stats.completed = mCompleted;
+    stats.failed = mFailed;
+    stats.streamedBytes = mStreamedBytes;
+
+    std::lock_guard<std::mutex> lock(mMutex);
+    stats.queued = mQueue.size() + mDecoding + mDecoded.size();
+    stats.decodeMsTotal = mDecodeMsTotal;
+    return stats;
+}
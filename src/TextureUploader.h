@@ -0,0 +1,131 @@
+#pragma once
+
+#include <glad/glad.h>
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+struct TextureUploaderStats
+{
+    size_t queued = 0;         // waiting for / in decode
+    size_t streaming = 0;      // decoded, rows still to upload
+    size_t completed = 0;
+    size_t failed = 0;
+    size_t streamedBytes = 0;
+    double decodeMsTotal = 0.0;
+};
+
+/*
+    TextureUploader
+    ---------------
+    PNG decode on worker threads, upload on the main thread through a ring
+    of pixel buffer objects:
+
+      - Enqueue() names a texture that already exists (the caller hands
+        out its id right away, as a placeholder) and where the image goes
+        in it: a standalone texture is (re)allocated at the decoded size,
+        an atlas region is written at (x, y).
+      - Pump(), once per frame, copies decoded rows into the next PBO of
+        the ring and issues glTexSubImage2D from it, until the frame's
+        byte budget is spent. A large image streams in row bands over
+        several frames instead of stalling one.
+
+    Each PBO is orphaned before it's mapped, so the copy never waits for
+    the GPU to finish reading the previous band. Cancel() drops the work
+    queued for a texture that is about to be deleted.
+*/
+class TextureUploader
+{
+public:
+    TextureUploader(size_t frameBudgetBytes, int workerCount);
+    ~TextureUploader();
+
+    TextureUploader(const TextureUploader&) = delete;
+    TextureUploader& operator=(const TextureUploader&) = delete;
+
+    // expectedWidth / Height: the size the caller laid the texture out for
+    // (the registry reads it from the file's header). An atlas region whose
+    // image decodes to another size, i.e. the file changed in between, is skipped.
+    void Enqueue(const std::string& path, GLuint texture, int x, int y,
+        int expectedWidth, int expectedHeight, bool allocate);
+
+    // Pixels already in memory (a bundle's cooked images): copied, and
+    // streamed under the same budget without a decode.
+    void EnqueuePixels(const std::string& path, GLuint texture, int x, int y,
+        const uint8_t* rgba, int width, int height, bool allocate);
+
+    void Cancel(GLuint texture);
+
+    // Main thread: an upload into texture is queued, decoding or streaming.
+    bool IsPending(GLuint texture) const;
+
+    // Main thread (GL). Returns the bytes uploaded this call.
+    size_t Pump();
+
+    bool IsIdle() const;
+    TextureUploaderStats GetStats() const;
+
+private:
+    struct Job
+    {
+        std::string path;
+        GLuint texture = 0;
+        int x = 0;
+        int y = 0;
+        int expectedWidth = 0;
+        int expectedHeight = 0;
+        bool allocate = false;
+
+        std::atomic<bool> cancelled{ false };
+
+        // Filled by the worker
+        std::vector<uint8_t> rgba;
+        int width = 0;
+        int height = 0;
+        bool decoded = false;
+
+        // Main thread
+        int nextRow = 0;
+    };
+
+    void WorkerLoop();
+    void CreatePixelBuffers(size_t bytes);
+
+    // Decoded size vs. the size the caller laid out (logged once).
+    bool CheckSize(const Job& job) const;
+
+    // Upload the next band of `job`; false once the job is finished.
+    bool UploadBand(Job& job, size_t& budget);
+
+    static constexpr int kRingSize = 3;
+
+    size_t mFrameBudgetBytes = 0;
+
+    // Main thread only
+    GLuint mPbos[kRingSize] = {};
+    size_t mPboBytes = 0;
+    int mNextPbo = 0;
+    std::deque<std::shared_ptr<Job>> mStreaming;
+    std::vector<std::shared_ptr<Job>> mJobs; // every unfinished job, for Cancel()
+    size_t mCompleted = 0;
+    size_t mFailed = 0;
+    size_t mStreamedBytes = 0;
+
+    // Shared with the workers
+    std::vector<std::thread> mWorkers;
+    mutable std::mutex mMutex;
+    std::condition_variable mWake;
+    std::deque<std::shared_ptr<Job>> mQueue;
+    std::vector<std::shared_ptr<Job>> mDecoded;
+    size_t mDecoding = 0;
+    double mDecodeMsTotal = 0.0;
+    bool mStopping = false;
+};
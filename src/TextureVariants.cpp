@@ -0,0 +1,172 @@
+#include "TextureVariants.h"
+
+#include "AssetFiles.h"
+#include "ImageSource.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+namespace
+{
+    constexpr int kVariantSizes[] = { 128, 256, 512, 1024 };
+
+    bool ParseSize(const std::string& name, int& outWidth, int& outHeight)
+    {
+        const size_t x = name.find('x');
+        if (x == 0 || x == std::string::npos || x + 1 == name.size())
+            return false;
+
+        for (size_t i = 0; i < name.size(); ++i)
+        {
+            if (i != x && (name[i] < '0' || name[i] > '9'))
+                return false;
+        }
+
+        outWidth = std::stoi(name.substr(0, x));
+        outHeight = std::stoi(name.substr(x + 1));
+        return outWidth > 0 && outHeight > 0;
+    }
+
+    struct Candidate
+    {
+        int dirWidth;   // size directory
+        int dirHeight;
+        int width;      // image size it implies
+        int height;
+    };
+
+    // Directory size -> image size, in the proportion the TSX gives.
+    Candidate MakeCandidate(const TextureVariantPath& variant, int width, int height, int dirWidth, int dirHeight)
+    {
+        return Candidate{ dirWidth, dirHeight,
+            (int)((int64_t)dirWidth * width / variant.width),
+            (int)((int64_t)dirHeight * height / variant.height) };
+    }
+
+    Candidate MakeExactCandidate(const TextureVariantPath& variant, int width, int height, float scale)
+    {
+        const int targetWidth = std::max(1, (int)std::ceil((float)width * scale));
+        const int targetHeight = std::max(1, (int)std::ceil((float)height * scale));
+        return MakeCandidate(variant, width, height,
+            (int)std::ceil((double)targetWidth * variant.width / width),
+            (int)std::ceil((double)targetHeight * variant.height / height));
+    }
+}
+
+bool ParseTextureVariantPath(const std::string& path, TextureVariantPath& outPath)
+{
+    // Walk the directories from the file up; the innermost size directory wins.
+    size_t end = path.find_last_of('/');
+    while (end != std::string::npos && end > 0)
+    {
+        const size_t begin = path.find_last_of('/', end - 1);
+        const size_t nameStart = begin == std::string::npos ? 0 : begin + 1;
+
+        if (ParseSize(path.substr(nameStart, end - nameStart), outPath.width, outPath.height))
+        {
+            outPath.prefix = path.substr(0, nameStart);
+            outPath.suffix = path.substr(end);
+            return true;
+        }
+
+        if (begin == std::string::npos)
+            break;
+        end = begin;
+    }
+    return false;
+}
+
+std::string MakeTextureVariantPath(const TextureVariantPath& path, int width, int height)
+{
+    return path.prefix + std::to_string(width) + "x" + std::to_string(height) + path.suffix;
+}
+
+bool GetExactTextureVariant(const std::string& path, int width, int height, float scale,
+    std::string& outPath, int& outWidth, int& outHeight)
+{
+    TextureVariantPath variant;
+    if (width <= 0 || height <= 0 || scale <= 0.0f || !ParseTextureVariantPath(path, variant))
+        return false;
+
+    const Candidate exact = MakeExactCandidate(variant, width, height, scale);
+    outPath = MakeTextureVariantPath(variant, exact.dirWidth, exact.dirHeight);
+    outWidth = exact.width;
+    outHeight = exact.height;
+    return true;
+}
+
+std::string SelectTextureVariant(const std::string& path, int width, int height, float scale,
+    const ImageSource* images, int& outWidth, int& outHeight)
+{
+    outWidth = width;
+    outHeight = height;
+
+    TextureVariantPath variant;
+    if (width <= 0 || height <= 0 || scale <= 0.0f || !ParseTextureVariantPath(path, variant))
+        return path;
+
+    const int targetWidth = std::max(1, (int)std::ceil((float)width * scale));
+    const int targetHeight = std::max(1, (int)std::ceil((float)height * scale));
+
+    std::vector<Candidate> candidates;
+    candidates.push_back(MakeCandidate(variant, width, height, variant.width, variant.height));
+    candidates.push_back(MakeExactCandidate(variant, width, height, scale));
+    for (int size : kVariantSizes)
+    {
+        // Same aspect as the named directory only.
+        if ((int64_t)size * variant.height % variant.width == 0)
+            candidates.push_back(MakeCandidate(variant, width, height, size, (int)((int64_t)size * variant.height / variant.width)));
+    }
+
+    std::sort(candidates.begin(), candidates.end(), [](const Candidate& a, const Candidate& b)
+        {
+            return (int64_t)a.width * a.height < (int64_t)b.width * b.height;
+        });
+    candidates.erase(std::unique(candidates.begin(), candidates.end(), [](const Candidate& a, const Candidate& b)
+        {
+            return a.dirWidth == b.dirWidth && a.dirHeight == b.dirHeight;
+        }), candidates.end());
+
+    auto IsAvailable = [&](const Candidate& candidate, std::string& outPath)
+        {
+            // The TSX's own variant is taken as present; loading it reports otherwise.
+            outPath = MakeTextureVariantPath(variant, candidate.dirWidth, candidate.dirHeight);
+            if (candidate.dirWidth == variant.width && candidate.dirHeight == variant.height)
+                return true;
+
+            const uint8_t* rgba = nullptr;
+            int imageWidth = 0, imageHeight = 0;
+            if (images && images->FindImage(outPath, rgba, imageWidth, imageHeight))
+                return true;
+
+            return AssetFileExists(outPath);
+        };
+
+    std::string candidatePath;
+    for (const Candidate& candidate : candidates)
+    {
+        if (candidate.width < targetWidth || candidate.height < targetHeight)
+            continue;
+
+        if (IsAvailable(candidate, candidatePath))
+        {
+            outWidth = candidate.width;
+            outHeight = candidate.height;
+            return candidatePath;
+        }
+    }
+
+    // Nothing big enough: the largest there is.
+    for (auto it = candidates.rbegin(); it != candidates.rend(); ++it)
+    {
+        if (IsAvailable(*it, candidatePath))
+        {
+            outWidth = it->width;
+            outHeight = it->height;
+            return candidatePath;
+        }
+    }
+    return path;
+}
@@ -0,0 +1,45 @@
+#pragma once
+
+#include <string>
+
+class ImageSource;
+
+// An image path with a "<W>x<H>" size directory: prefix + "256x256" + suffix.
+struct TextureVariantPath
+{
+    std::string prefix; // up to and including the '/' before the size directory
+    std::string suffix; // from the '/' after it
+    int width = 0;
+    int height = 0;
+};
+
+bool ParseTextureVariantPath(const std::string& path, TextureVariantPath& outPath);
+std::string MakeTextureVariantPath(const TextureVariantPath& path, int width, int height);
+
+/*
+    Texture variants
+    ----------------
+    Art under assets/Tiles comes in several resolutions of the same image,
+    one directory per size (Tiles/Shadow/256x256/Tree01_0001.png,
+    Tiles/Shadow/1024x1024/Tree01_0001.png, ...). The TSX names one of
+    them, which is not necessarily the one worth loading.
+
+    SelectTextureVariant() returns the smallest variant that covers the
+    size the image is drawn at (TSX size * world-to-screen scale), so a
+    256 px quad samples a 256 px texture instead of a 1024 px one. The
+    candidates are the 128 / 256 / 512 / 1024 variants plus the exact
+    drawn size (which mon_cook downscales into a bundle when the art has
+    no such directory); `images`, when given, is checked before the disk.
+    With nothing at or above the drawn size, the largest available one.
+
+    Paths without a size directory, or with no other variant on disk,
+    come back unchanged with the TSX size. Stateless (a few archive lookups or stat() calls),
+    so the preloader thread can use it too.
+*/
+std::string SelectTextureVariant(const std::string& path, int width, int height, float scale,
+    const ImageSource* images, int& outWidth, int& outHeight);
+
+// The variant at exactly the drawn size, whether or not it exists yet
+// (what mon_cook writes when the art has no such directory).
+bool GetExactTextureVariant(const std::string& path, int width, int height, float scale,
+    std::string& outPath, int& outWidth, int& outHeight);
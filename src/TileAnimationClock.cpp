@@ -0,0 +1,67 @@
+#include "TileAnimationClock.h"
+
+#include <cmath>
+
+void TileAnimationClock::Clear()
+{
+    mTracks.clear();
+    mFrames.clear();
+    mFrameGids.clear();
+    mChanged.clear();
+}
+
+int TileAnimationClock::Register(const TileAnimation& animation, int firstGid)
+{
+    Track track{};
+    track.firstFrame = (int)mFrames.size();
+    track.frameCount = (int)animation.frames.size();
+    track.totalDurationMs = animation.totalDurationMs;
+    track.firstGid = firstGid;
+
+    mFrames.insert(mFrames.end(), animation.frames.begin(), animation.frames.end());
+    mTracks.push_back(track);
+
+    // Until the first Advance() the first frame is current.
+    const uint32_t firstFrameGid = track.frameCount > 0
+        ? static_cast<uint32_t>(firstGid + animation.frames.front().tileId)
+        : 0u;
+    mFrameGids.push_back(firstFrameGid);
+    mChanged.push_back(0);
+
+    return (int)mTracks.size() - 1;
+}
+
+void TileAnimationClock::Advance(float animationTimeMs)
+{
+    const int timeMs = static_cast<int>(std::floor(animationTimeMs));
+
+    for (size_t slot = 0; slot < mTracks.size(); ++slot)
+    {
+        const Track& track = mTracks[slot];
+        if (track.frameCount <= 0 || track.totalDurationMs <= 0)
+        {
+            mChanged[slot] = 0;
+            continue;
+        }
+
+        const int timeInCycle = timeMs % track.totalDurationMs;
+
+        const AnimationFrame* frames = &mFrames[track.firstFrame];
+        int frameTileId = frames[track.frameCount - 1].tileId;
+
+        int accumulated = 0;
+        for (int i = 0; i < track.frameCount; ++i)
+        {
+            accumulated += frames[i].durationMs;
+            if (timeInCycle < accumulated)
+            {
+                frameTileId = frames[i].tileId;
+                break;
+            }
+        }
+
+        const uint32_t frameGid = static_cast<uint32_t>(track.firstGid + frameTileId);
+        mChanged[slot] = frameGid != mFrameGids[slot] ? 1 : 0;
+        mFrameGids[slot] = frameGid;
+    }
+}
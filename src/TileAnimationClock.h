@@ -0,0 +1,48 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "TmxLoader.h"
+
+/*
+    TileAnimationClock
+    ------------------
+    Advances every registered TileAnimation once per frame and writes the
+    current frame (as a gid) into a flat table indexed by slot.
+
+    Readers (TileResolver, TileMap) then pay one array load per animated
+    tile instead of a hash lookup + modulo + frame scan per draw.
+*/
+class TileAnimationClock
+{
+public:
+    void Clear();
+
+    // Returns the slot that GetFrameGid / FrameChanged use for this animation.
+    int Register(const TileAnimation& animation, int firstGid);
+
+    void Advance(float animationTimeMs);
+
+    uint32_t GetFrameGid(int slot) const { return mFrameGids[slot]; }
+
+    // True when the slot switched frames during the last Advance().
+    bool FrameChanged(int slot) const { return mChanged[slot] != 0; }
+
+    int GetSlotCount() const { return (int)mTracks.size(); }
+
+private:
+    struct Track
+    {
+        int firstFrame = 0;      // into mFrames
+        int frameCount = 0;
+        int totalDurationMs = 0;
+        int firstGid = 0;
+    };
+
+    std::vector<Track> mTracks;
+    std::vector<AnimationFrame> mFrames;
+
+    std::vector<uint32_t> mFrameGids;
+    std::vector<uint8_t> mChanged;
+};
@@ -0,0 +1,345 @@
+#include "TileLayerData.h"
+
+#include "stb_image.h"
+#include "zstd.h"
+
+#include <cstring>
+#include <vector>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define MON_CSV_SSE2 1
+#include <emmintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+#else
+#define MON_CSV_SSE2 0
+#endif
+
+namespace
+{
+    constexpr int kMaxGidDigits = 10; // 4294967295
+
+    inline bool IsDigit(char c)
+    {
+        return static_cast<unsigned char>(c - '0') < 10;
+    }
+
+    inline bool IsSeparator(char c)
+    {
+        return c == ',' || c == ' ' || c == '\t' || c == '\r' || c == '\n';
+    }
+
+#if MON_CSV_SSE2
+    inline uint32_t CountTrailingZeros(uint32_t value)
+    {
+#if defined(_MSC_VER)
+        unsigned long index = 0;
+        _BitScanForward(&index, value);
+        return static_cast<uint32_t>(index);
+#else
+        return static_cast<uint32_t>(__builtin_ctz(value));
+#endif
+    }
+
+    // Bit i of outDigits / outSeparators is set when p[i] is a digit / separator.
+    inline void ClassifyBlock(const char* p, uint32_t& outDigits, uint32_t& outSeparators)
+    {
+        const __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+
+        // Unsigned (c - '0') <= 9, via min: bytes below '0' wrap to large values.
+        const __m128i offset = _mm_sub_epi8(bytes, _mm_set1_epi8('0'));
+        const __m128i digits = _mm_cmpeq_epi8(_mm_min_epu8(offset, _mm_set1_epi8(9)), offset);
+
+        __m128i separators = _mm_cmpeq_epi8(bytes, _mm_set1_epi8(','));
+        separators = _mm_or_si128(separators, _mm_cmpeq_epi8(bytes, _mm_set1_epi8(' ')));
+        separators = _mm_or_si128(separators, _mm_cmpeq_epi8(bytes, _mm_set1_epi8('\n')));
+        separators = _mm_or_si128(separators, _mm_cmpeq_epi8(bytes, _mm_set1_epi8('\r')));
+        separators = _mm_or_si128(separators, _mm_cmpeq_epi8(bytes, _mm_set1_epi8('\t')));
+
+        outDigits = static_cast<uint32_t>(_mm_movemask_epi8(digits));
+        outSeparators = static_cast<uint32_t>(_mm_movemask_epi8(separators));
+    }
+#endif
+
+    // Base64 alphabet -> 6-bit value; kBase64Skip for whitespace, kBase64Invalid otherwise.
+    constexpr uint8_t kBase64Invalid = 0xFF;
+    constexpr uint8_t kBase64Skip = 0xFE;
+
+    struct Base64Table
+    {
+        uint8_t values[256];
+
+        Base64Table()
+        {
+            std::memset(values, kBase64Invalid, sizeof(values));
+            const char* alphabet = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+            for (uint8_t i = 0; i < 64; ++i)
+                values[static_cast<unsigned char>(alphabet[i])] = i;
+            values[static_cast<unsigned char>(' ')] = kBase64Skip;
+            values[static_cast<unsigned char>('\t')] = kBase64Skip;
+            values[static_cast<unsigned char>('\r')] = kBase64Skip;
+            values[static_cast<unsigned char>('\n')] = kBase64Skip;
+        }
+    };
+
+    const Base64Table kBase64Table;
+
+    // Skips a gzip member header (RFC 1952) and returns the raw deflate stream.
+    bool SkipGzipHeader(const uint8_t*& data, size_t& size)
+    {
+        constexpr uint8_t kFlagHcrc = 0x02;
+        constexpr uint8_t kFlagExtra = 0x04;
+        constexpr uint8_t kFlagName = 0x08;
+        constexpr uint8_t kFlagComment = 0x10;
+
+        if (size < 18 || data[0] != 0x1F || data[1] != 0x8B || data[2] != 8)
+            return false;
+
+        const uint8_t flags = data[3];
+        size_t offset = 10;
+
+        if (flags & kFlagExtra)
+        {
+            if (offset + 2 > size)
+                return false;
+            offset += 2 + (static_cast<size_t>(data[offset]) | (static_cast<size_t>(data[offset + 1]) << 8));
+        }
+
+        for (const uint8_t flag : { kFlagName, kFlagComment })
+        {
+            if (!(flags & flag))
+                continue;
+            while (offset < size && data[offset] != 0)
+                ++offset;
+            ++offset;
+        }
+
+        if (flags & kFlagHcrc)
+            offset += 2;
+
+        // 8-byte CRC32 / size trailer.
+        if (offset + 8 > size)
+            return false;
+
+        data += offset;
+        size -= offset + 8;
+        return true;
+    }
+
+    // Rewrites little-endian gid bytes (already in outGids) as masked native gids.
+    void FinishLittleEndianGids(uint32_t* gids, size_t count)
+    {
+        uint8_t* bytes = reinterpret_cast<uint8_t*>(gids);
+        for (size_t i = 0; i < count; ++i)
+        {
+            const uint8_t* b = bytes + i * 4;
+            const uint32_t gid = static_cast<uint32_t>(b[0])
+                | (static_cast<uint32_t>(b[1]) << 8)
+                | (static_cast<uint32_t>(b[2]) << 16)
+                | (static_cast<uint32_t>(b[3]) << 24);
+            gids[i] = gid & kTmxGidMask;
+        }
+    }
+}
+
+bool ParseCsvGids(const char* text, size_t length, uint32_t* outGids, size_t capacity, size_t& outCount)
+{
+    outCount = 0;
+    if (!text)
+        return true;
+
+    const char* p = text;
+    const char* const end = text + length;
+
+    while (p < end)
+    {
+        // --- Skip separators up to the next cell
+#if MON_CSV_SSE2
+        while (end - p >= 16)
+        {
+            uint32_t digits = 0;
+            uint32_t separators = 0;
+            ClassifyBlock(p, digits, separators);
+
+            const uint32_t invalid = ~(digits | separators) & 0xFFFFu;
+            if (digits == 0)
+            {
+                if (invalid != 0)
+                    return false;
+                p += 16;
+                continue;
+            }
+
+            const uint32_t start = CountTrailingZeros(digits);
+            if ((invalid & ((1u << start) - 1u)) != 0)
+                return false;
+
+            p += start;
+            break;
+        }
+#endif
+        while (p < end && !IsDigit(*p))
+        {
+            if (!IsSeparator(*p))
+                return false;
+            ++p;
+        }
+
+        if (p == end)
+            break;
+
+        // --- One cell
+        const char* const cellBegin = p;
+        uint64_t value = 0;
+        while (p < end && IsDigit(*p))
+        {
+            value = value * 10u + static_cast<uint64_t>(*p - '0');
+            ++p;
+        }
+
+        if (p - cellBegin > kMaxGidDigits || value > 0xFFFFFFFFull)
+            return false;
+
+        if (p < end && !IsSeparator(*p))
+            return false;
+
+        if (outCount == capacity)
+            return false;
+
+        outGids[outCount++] = static_cast<uint32_t>(value) & kTmxGidMask;
+    }
+
+    return true;
+}
+
+bool ParseTileLayerFormat(const char* encoding, const char* compression, TileLayerFormat& outFormat)
+{
+    if (!encoding)
+        return false; // XML <tile> elements
+
+    if (std::strcmp(encoding, "csv") == 0)
+    {
+        outFormat.encoding = TileLayerEncoding::Csv;
+        outFormat.compression = TileLayerCompression::None;
+        return !compression || compression[0] == '\0';
+    }
+
+    if (std::strcmp(encoding, "base64") != 0)
+        return false;
+
+    outFormat.encoding = TileLayerEncoding::Base64;
+    if (!compression || compression[0] == '\0')
+        outFormat.compression = TileLayerCompression::None;
+    else if (std::strcmp(compression, "zlib") == 0)
+        outFormat.compression = TileLayerCompression::Zlib;
+    else if (std::strcmp(compression, "gzip") == 0)
+        outFormat.compression = TileLayerCompression::Gzip;
+    else if (std::strcmp(compression, "zstd") == 0)
+        outFormat.compression = TileLayerCompression::Zstd;
+    else
+        return false;
+
+    return true;
+}
+
+bool DecodeBase64(const char* text, size_t length, uint8_t* outBytes, size_t capacity, size_t& outSize)
+{
+    outSize = 0;
+    if (!text)
+        return true;
+
+    uint32_t accumulator = 0;
+    int bits = 0;
+
+    for (size_t i = 0; i < length; ++i)
+    {
+        const char c = text[i];
+        if (c == '=')
+            break;
+
+        const uint8_t value = kBase64Table.values[static_cast<unsigned char>(c)];
+        if (value == kBase64Skip)
+            continue;
+        if (value == kBase64Invalid)
+            return false;
+
+        accumulator = (accumulator << 6) | value;
+        bits += 6;
+        if (bits >= 8)
+        {
+            bits -= 8;
+            if (outSize == capacity)
+                return false;
+            outBytes[outSize++] = static_cast<uint8_t>(accumulator >> bits);
+        }
+    }
+
+    return true;
+}
+
+bool DecodeTileLayerGids(const TileLayerFormat& format, const char* text, size_t length,
+    uint32_t* outGids, size_t capacity, size_t& outCount)
+{
+    outCount = 0;
+
+    if (format.encoding == TileLayerEncoding::Csv)
+        return ParseCsvGids(text, length, outGids, capacity, outCount);
+
+    const size_t gidBytes = capacity * sizeof(uint32_t);
+    size_t decodedBytes = 0;
+
+    if (format.compression == TileLayerCompression::None)
+    {
+        if (!DecodeBase64(text, length, reinterpret_cast<uint8_t*>(outGids), gidBytes, decodedBytes))
+            return false;
+    }
+    else
+    {
+        std::vector<uint8_t> compressed(length / 4 * 3 + 3);
+        size_t compressedSize = 0;
+        if (!DecodeBase64(text, length, compressed.data(), compressed.size(), compressedSize))
+            return false;
+
+        char* dst = reinterpret_cast<char*>(outGids);
+        const uint8_t* src = compressed.data();
+
+        switch (format.compression)
+        {
+        case TileLayerCompression::Zlib:
+        case TileLayerCompression::Gzip:
+        {
+            const bool gzip = format.compression == TileLayerCompression::Gzip;
+            if (gzip && !SkipGzipHeader(src, compressedSize))
+                return false;
+
+            const int inflated = gzip
+                ? stbi_zlib_decode_noheader_buffer(dst, static_cast<int>(gidBytes),
+                    reinterpret_cast<const char*>(src), static_cast<int>(compressedSize))
+                : stbi_zlib_decode_buffer(dst, static_cast<int>(gidBytes),
+                    reinterpret_cast<const char*>(src), static_cast<int>(compressedSize));
+            if (inflated < 0)
+                return false;
+            decodedBytes = static_cast<size_t>(inflated);
+            break;
+        }
+        case TileLayerCompression::Zstd:
+        {
+            const size_t result = ZSTD_decompress(dst, gidBytes, src, compressedSize);
+            if (ZSTD_isError(result))
+                return false;
+            decodedBytes = result;
+            break;
+        }
+        case TileLayerCompression::None:
+            break;
+        }
+    }
+
+    if (decodedBytes % sizeof(uint32_t) != 0)
+        return false;
+
+    outCount = decodedBytes / sizeof(uint32_t);
+    FinishLittleEndianGids(outGids, outCount);
+    return true;
+}
@@ -6,6 +6,8 @@
 #include "TileResolver.h"
 #include "TileMath.h"
 
+#include <algorithm>
+#include <cmath>
 
 namespace
 {
@@ -17,6 +19,20 @@ glm::vec2 ComputeTileTopLeftWorldPos(int tileX, int tileY, float tileWidthPx, fl
     float isoY = (float)(tileX + tileY) * halfH;
     return glm::vec2(isoX, isoY) + mapOrigin;
 }
+
+// Inverse of ComputeTileTopLeftWorldPos in diagonal form:
+// returns (x - y, x + y) for a tile top-left world position.
+glm::vec2 ComputeTileDiagonalsFromWorldPos(const glm::vec2& worldPos, float tileWidthPx, float tileHeightPx, const glm::vec2& mapOrigin)
+{
+    const glm::vec2 iso = worldPos - mapOrigin;
+    return glm::vec2(iso.x / (tileWidthPx * 0.5f), iso.y / (tileHeightPx * 0.5f));
+}
+}
+
+void TileRange::GetRowSpan(int y, int& outX0, int& outX1) const
+{
+    outX0 = std::max({ 0, y + minDiff, minSum - y });
+    outX1 = std::min({ mapWidth - 1, y + maxDiff, maxSum - y });
 }
 
 TileMap::TileMap(int width, int height, int tileWidthPx, int tileHeightPx)
@@ -25,48 +41,406 @@ TileMap::TileMap(int width, int height, int tileWidthPx, int tileHeightPx)
     , mTileWidthPx(tileWidthPx)
     , mTileHeightPx(tileHeightPx)
 {
+    if (mWidth > 0 && mHeight > 0)
+    {
+        mChunksX = (mWidth + kChunkSize - 1) / kChunkSize;
+        mChunksY = (mHeight + kChunkSize - 1) / kChunkSize;
+        mChunks.resize((size_t)mChunksX * mChunksY);
+    }
 }
 
-void TileMap::AddLayer(const std::string& name, const std::vector<uint32_t>& tiles, bool visible, bool renderable)
+void TileMap::AddLayer(const std::string& name, ArrayView<uint32_t> tiles, LayerPass pass, bool visible)
 {
-    if ((int)tiles.size() != mWidth * mHeight)
+    if (mChunks.empty() || (int)tiles.size() != mWidth * mHeight)
         return;
 
     TileLayer layer{};
     layer.name = name;
-    layer.tiles = tiles;
+    layer.pass = pass;
     layer.visible = visible;
-    layer.renderable = renderable;
 
     mLayers.push_back(std::move(layer));
+
+    const size_t layerCount = mLayers.size();
+    for (Chunk& chunk : mChunks)
+    {
+        chunk.gids.resize(layerCount * kChunkCells, 0);
+        chunk.meshes.resize(layerCount);
+    }
+
+    CopyLayerCells(layerCount - 1, tiles, 0, tiles.size());
 }
 
-uint32_t TileMap::GetLayerTile(const TileLayer& layer, int x, int y) const
+void TileMap::CopyLayerCells(size_t layer, ArrayView<uint32_t> tiles, size_t begin, size_t end)
+{
+    // Row segments: a source row is contiguous within each chunk it crosses.
+    size_t cell = begin;
+    while (cell < end)
+    {
+        const int x = (int)(cell % (size_t)mWidth);
+        const int y = (int)(cell / (size_t)mWidth);
+        const int runEnd = std::min(mWidth, (x / kChunkSize + 1) * kChunkSize);
+        const size_t count = std::min((size_t)(runEnd - x), end - cell);
+
+        Chunk& chunk = mChunks[ChunkIndex(x, y)];
+        std::copy(tiles.data() + cell, tiles.data() + cell + count,
+            chunk.gids.begin() + layer * kChunkCells + LocalIndex(x, y));
+        cell += count;
+    }
+}
+
+glm::vec2 TileMap::GetMapOrigin(const glm::ivec2& viewportSizePx) const
+{
+    // Shifting the origin by the offset's iso position moves every cell (and chunk mesh) with it.
+    const glm::vec2 viewportOrigin(viewportSizePx.x * 0.5f, 60.0f);
+    return ComputeTileTopLeftWorldPos(mCellOffset.x, mCellOffset.y, (float)mTileWidthPx, (float)mTileHeightPx, viewportOrigin);
+}
+
+uint32_t TileMap::GetLayerTile(size_t layer, int x, int y) const
 {
     if (x < 0 || x >= mWidth || y < 0 || y >= mHeight)
         return 0;
 
-    return layer.tiles[Index(x, y)];
+    return mChunks[ChunkIndex(x, y)].gids[layer * kChunkCells + LocalIndex(x, y)];
 }
 
-void TileMap::DrawGround(SpriteRenderer& renderer,
+void TileMap::ComputeTileRect(int x, int y, const ResolvedTile& resolved, const glm::vec2& mapOrigin,
+    glm::vec2& outPos, glm::vec2& outSize) const
+{
+    const glm::vec2 baseSize((float)mTileWidthPx, (float)mTileHeightPx);
+
+    outSize = resolved.sizePx;
+    if (outSize.x <= 0.0f)
+        outSize.x = baseSize.x;
+    if (outSize.y <= 0.0f)
+        outSize.y = baseSize.y;
+
+    // Tiles taller than a cell grow upwards from the cell's bottom edge.
+    outPos = ComputeTileTopLeftWorldPos(x, y, baseSize.x, baseSize.y, mapOrigin);
+    outPos.y -= (outSize.y - baseSize.y);
+
+    // Cooked tiles only cover their opaque part of that rect.
+    ApplyTileTrim(resolved, outPos, outSize);
+}
+
+bool TileMap::IsCellSized(const glm::vec2& size) const
+{
+    return size.x <= (float)mTileWidthPx && size.y <= (float)mTileHeightPx;
+}
+
+void TileMap::BuildChunkMeshes(SpriteRenderer& renderer, const TileResolver& resolver)
+{
+    ChunkScratch scratch;
+    for (int cy = 0; cy < mChunksY; ++cy)
+    {
+        for (int cx = 0; cx < mChunksX; ++cx)
+            BuildChunk(cx, cy, renderer, resolver, scratch);
+    }
+
+    mMeshesBuilt = !mChunks.empty();
+}
+
+size_t TileMap::RebuildChunkMeshes(SpriteRenderer& renderer, const TileResolver& resolver, const MapData& mapData,
+    const std::vector<uint32_t>& cells)
+{
+    if (mChunks.empty() || mapData.width != mWidth || mapData.height != mHeight)
+        return 0;
+
+    const size_t cellCount = (size_t)mWidth * mHeight;
+
+    std::vector<uint32_t> chunkIndices;
+    chunkIndices.reserve(cells.size());
+    for (uint32_t index : cells)
+    {
+        const size_t layer = index / cellCount;
+        const size_t cell = index % cellCount;
+        const ArrayView<uint32_t> tiles = mapData.GetLayerGids(layer);
+        if (layer >= mLayers.size() || tiles.size() != cellCount)
+            continue;
+
+        CopyLayerCells(layer, tiles, cell, cell + 1);
+
+        if (IsMeshLayer(mLayers[layer]))
+            chunkIndices.push_back((uint32_t)ChunkIndex((int)(cell % mWidth), (int)(cell / mWidth)));
+    }
+
+    if (!mMeshesBuilt)
+        return 0;
+
+    std::sort(chunkIndices.begin(), chunkIndices.end());
+    chunkIndices.erase(std::unique(chunkIndices.begin(), chunkIndices.end()), chunkIndices.end());
+
+    ChunkScratch scratch;
+    for (uint32_t index : chunkIndices)
+        BuildChunk((int)index % mChunksX, (int)index / mChunksX, renderer, resolver, scratch);
+
+    return chunkIndices.size();
+}
+
+void TileMap::BuildChunk(int cx, int cy, SpriteRenderer& renderer, const TileResolver& resolver, ChunkScratch& scratch)
+{
+    // Chunk vertices are map-local; the map origin is applied when drawing.
+    const glm::vec2 localOrigin(0.0f);
+
+    Chunk& chunk = mChunks[(size_t)cy * mChunksX + cx];
+    chunk.looseTiles.clear();
+    chunk.animated.clear();
+
+    const int x0 = cx * kChunkSize;
+    const int y0 = cy * kChunkSize;
+    const int x1 = std::min(mWidth, x0 + kChunkSize);
+    const int y1 = std::min(mHeight, y0 + kChunkSize);
+
+    std::vector<SpriteQuad>& quads = scratch.quads;
+    std::vector<AnimatedQuad>& animated = scratch.animated;
+
+    for (size_t layerIndex = 0; layerIndex < mLayers.size(); ++layerIndex)
+    {
+        quads.clear();
+        animated.clear();
+
+        if (IsMeshLayer(mLayers[layerIndex]))
+        {
+            const uint32_t* gids = chunk.gids.data() + layerIndex * kChunkCells;
+
+            for (int y = y0; y < y1; ++y)
+            {
+                for (int x = x0; x < x1; ++x)
+                {
+                    const uint32_t gid = gids[LocalIndex(x, y)];
+                    if (gid == 0)
+                        continue;
+
+                    ResolvedTile resolved{};
+                    if (!resolver.Resolve(gid, resolved))
+                        continue;
+
+                    SpriteQuad quad{};
+                    quad.texture = resolved.textureId;
+                    quad.uvMin = resolved.uvMin;
+                    quad.uvMax = resolved.uvMax;
+                    ComputeTileRect(x, y, resolved, localOrigin, quad.posPx, quad.sizePx);
+
+                    if (!IsCellSized(quad.sizePx))
+                    {
+                        chunk.looseTiles.push_back({ x, y, (int)layerIndex, gid });
+                        continue;
+                    }
+
+                    const int animSlot = resolver.GetAnimationSlot(gid);
+                    if (animSlot >= 0)
+                    {
+                        AnimatedQuad anim{};
+                        anim.meshQuad = (int)quads.size(); // remapped after BuildMesh
+                        anim.animSlot = animSlot;
+                        anim.gid = gid;
+                        anim.frameGid = resolver.GetAnimationClock().GetFrameGid(animSlot);
+                        anim.texture = resolved.textureId;
+                        anim.x = x;
+                        anim.y = y;
+                        anim.layer = (int)layerIndex;
+                        animated.push_back(anim);
+                    }
+
+                    quads.push_back(quad);
+                }
+            }
+        }
+
+        // Also releases the mesh of a layer that is no longer drawn.
+        renderer.BuildMesh(chunk.meshes[layerIndex], quads, scratch.quadIndices);
+
+        for (AnimatedQuad& anim : animated)
+        {
+            anim.meshQuad = scratch.quadIndices[anim.meshQuad];
+            chunk.animated.push_back(anim);
+        }
+    }
+}
+
+void TileMap::UpdateChunkAnimations(Chunk& chunk, SpriteRenderer& renderer, const TileResolver& resolver) const
+{
+    const TileAnimationClock& clock = resolver.GetAnimationClock();
+
+    for (size_t i = 0; i < chunk.animated.size();)
+    {
+        AnimatedQuad& anim = chunk.animated[i];
+
+        const uint32_t frameGid = clock.GetFrameGid(anim.animSlot);
+        if (frameGid == anim.frameGid)
+        {
+            ++i;
+            continue;
+        }
+        anim.frameGid = frameGid;
+
+        ResolvedTile resolved{};
+        const bool ok = resolver.Resolve(anim.gid, resolved);
+
+        SpriteQuad quad{};
+        quad.texture = resolved.textureId;
+        quad.uvMin = resolved.uvMin;
+        quad.uvMax = resolved.uvMax;
+        if (ok)
+            ComputeTileRect(anim.x, anim.y, resolved, glm::vec2(0.0f), quad.posPx, quad.sizePx);
+
+        if (ok && resolved.textureId == anim.texture && IsCellSized(quad.sizePx))
+        {
+            renderer.UpdateMeshQuad(chunk.meshes[anim.layer], anim.meshQuad, quad);
+            ++i;
+            continue;
+        }
+
+        // Frame lives on another texture (or changed size): collapse the mesh
+        // quad and draw this tile through the per-sprite path from now on.
+        renderer.UpdateMeshQuad(chunk.meshes[anim.layer], anim.meshQuad, SpriteQuad{});
+        chunk.looseTiles.push_back({ anim.x, anim.y, anim.layer, anim.gid });
+
+        chunk.animated[i] = chunk.animated.back();
+        chunk.animated.pop_back();
+    }
+}
+
+void TileMap::CullVisible(SpriteRenderer& renderer,
     const TileResolver& resolver,
     const Camera2D& camera,
-    const glm::ivec2& viewportSizePx,
-    float animationTimeMs) const
+    const glm::ivec2& viewportSizePx)
 {
-    const glm::vec2 mapOrigin(viewportSizePx.x * 0.5f, 60.0f);
-    glm::vec2 baseSize((float)mTileWidthPx, (float)mTileHeightPx);
+    mVisibleChunks.clear();
+    mVisibleLooseTiles.resize(mLayers.size());
+    for (std::vector<LooseTile>& tiles : mVisibleLooseTiles)
+        tiles.clear();
 
-    for (int y = 0; y < mHeight; ++y)
+    mVisibleRange = GetVisibleTileRange(camera, viewportSizePx, resolver.GetMaxTileSizePx());
+    const TileRange& range = mVisibleRange;
+    if (range.IsEmpty() || !mMeshesBuilt)
+        return;
+
+    for (int cy = range.minY / kChunkSize; cy <= range.maxY / kChunkSize; ++cy)
     {
-        for (int x = 0; x < mWidth; ++x)
+        // Union of the visible row spans inside this chunk row.
+        int minX = mWidth;
+        int maxX = -1;
+        const int rowBegin = std::max(range.minY, cy * kChunkSize);
+        const int rowEnd = std::min(range.maxY, cy * kChunkSize + kChunkSize - 1);
+        for (int y = rowBegin; y <= rowEnd; ++y)
+        {
+            int x0 = 0;
+            int x1 = -1;
+            range.GetRowSpan(y, x0, x1);
+            if (x0 > x1)
+                continue;
+            minX = std::min(minX, x0);
+            maxX = std::max(maxX, x1);
+        }
+
+        if (maxX < minX)
+            continue;
+
+        for (int cx = minX / kChunkSize; cx <= maxX / kChunkSize; ++cx)
         {
-            glm::vec2 worldPos = ComputeTileTopLeftWorldPos(x, y, (float)mTileWidthPx, (float)mTileHeightPx, mapOrigin);
+            const uint32_t chunkIndex = (uint32_t)cy * mChunksX + cx;
+            Chunk& chunk = mChunks[chunkIndex];
+
+            UpdateChunkAnimations(chunk, renderer, resolver);
+            mVisibleChunks.push_back(chunkIndex);
 
-            for (const TileLayer& layer : mLayers)
+            for (const LooseTile& tile : chunk.looseTiles)
             {
-                if (!layer.visible || !layer.renderable)
+                int x0 = 0;
+                int x1 = -1;
+                if (tile.y >= range.minY && tile.y <= range.maxY)
+                    range.GetRowSpan(tile.y, x0, x1);
+                if (tile.x >= x0 && tile.x <= x1)
+                    mVisibleLooseTiles[tile.layer].push_back(tile);
+            }
+        }
+    }
+
+    // Oversized tiles keep the row-major order of the per-cell path.
+    for (std::vector<LooseTile>& tiles : mVisibleLooseTiles)
+    {
+        std::sort(tiles.begin(), tiles.end(),
+            [](const LooseTile& a, const LooseTile& b)
+            {
+                if (a.y != b.y) return a.y < b.y;
+                return a.x < b.x;
+            });
+    }
+}
+
+void TileMap::DrawPass(LayerPass pass,
+    SpriteRenderer& renderer,
+    const TileResolver& resolver,
+    const Camera2D& camera,
+    const glm::ivec2& viewportSizePx) const
+{
+    // Layer-major: a later layer covers an earlier one across chunk borders too.
+    for (size_t layer = 0; layer < mLayers.size(); ++layer)
+    {
+        if (mLayers[layer].pass != pass)
+            continue;
+
+        DrawLayerMeshes(layer, renderer, camera, viewportSizePx);
+        DrawLayerLooseTiles(layer, renderer, resolver, camera, viewportSizePx);
+    }
+}
+
+void TileMap::DrawLayerMeshes(size_t layer,
+    SpriteRenderer& renderer,
+    const Camera2D& camera,
+    const glm::ivec2& viewportSizePx) const
+{
+    if (!mMeshesBuilt || layer >= mLayers.size())
+        return;
+
+    const glm::vec2 meshOffset = GetMapOrigin(viewportSizePx) - camera.GetPosition();
+    for (uint32_t chunkIndex : mVisibleChunks)
+        renderer.DrawMesh(mChunks[chunkIndex].meshes[layer], meshOffset);
+}
+
+void TileMap::DrawLayerLooseTiles(size_t layer,
+    SpriteRenderer& renderer,
+    const TileResolver& resolver,
+    const Camera2D& camera,
+    const glm::ivec2& viewportSizePx) const
+{
+    if (!mMeshesBuilt || layer >= mVisibleLooseTiles.size())
+        return;
+
+    const glm::vec2 mapOrigin = GetMapOrigin(viewportSizePx);
+    for (const LooseTile& tile : mVisibleLooseTiles[layer])
+    {
+        ResolvedTile resolved{};
+        if (!resolver.Resolve(tile.gid, resolved))
+            continue;
+
+        glm::vec2 drawPos, drawSize;
+        ComputeTileRect(tile.x, tile.y, resolved, mapOrigin, drawPos, drawSize);
+        renderer.Draw(resolved.textureId, drawPos, drawSize, camera, resolved.uvMin, resolved.uvMax);
+    }
+}
+
+void TileMap::DrawPassCells(LayerPass pass,
+    SpriteRenderer& renderer,
+    const TileResolver& resolver,
+    const Camera2D& camera,
+    const glm::ivec2& viewportSizePx) const
+{
+    const glm::vec2 mapOrigin = GetMapOrigin(viewportSizePx);
+    const TileRange& range = mVisibleRange;
+
+    for (int y = range.minY; y <= range.maxY; ++y)
+    {
+        int x0 = 0;
+        int x1 = -1;
+        range.GetRowSpan(y, x0, x1);
+
+        for (int x = x0; x <= x1; ++x)
+        {
+            for (size_t layer = 0; layer < mLayers.size(); ++layer)
+            {
+                if (!mLayers[layer].visible || mLayers[layer].pass != pass)
                     continue;
 
                 uint32_t gid = GetLayerTile(layer, x, y);
@@ -74,17 +448,11 @@ void TileMap::DrawGround(SpriteRenderer& renderer,
                     continue;
 
                 ResolvedTile resolved{};
-                if (!resolver.Resolve(gid, animationTimeMs, resolved))
+                if (!resolver.Resolve(gid, resolved))
                     continue;
 
-                glm::vec2 drawSize = resolved.sizePx;
-                if (drawSize.x <= 0.0f)
-                    drawSize.x = baseSize.x;
-                if (drawSize.y <= 0.0f)
-                    drawSize.y = baseSize.y;
-
-                glm::vec2 drawPos = worldPos;
-                drawPos.y -= (drawSize.y - baseSize.y);
+                glm::vec2 drawPos, drawSize;
+                ComputeTileRect(x, y, resolved, mapOrigin, drawPos, drawSize);
 
                 renderer.Draw(resolved.textureId, drawPos, drawSize, camera, resolved.uvMin, resolved.uvMax);
             }
@@ -92,43 +460,127 @@ void TileMap::DrawGround(SpriteRenderer& renderer,
     }
 }
 
-void TileMap::AppendOccluders(RenderQueue& queue,
+TileRange TileMap::GetVisibleTileRange(const Camera2D& camera,
+    const glm::ivec2& viewportSizePx,
+    const glm::vec2& maxTileSizePx) const
+{
+    TileRange range{};
+    range.mapWidth = mWidth;
+
+    if (mWidth <= 0 || mHeight <= 0 || mTileWidthPx <= 0 || mTileHeightPx <= 0)
+        return range;
+
+    const glm::vec2 mapOrigin = GetMapOrigin(viewportSizePx);
+    const glm::vec2 baseSize((float)mTileWidthPx, (float)mTileHeightPx);
+    const glm::vec2 maxSize = glm::max(maxTileSizePx, baseSize);
+
+    // A tile is drawn at (topLeft.x, topLeft.y - (h - tileH)) with size (w, h),
+    // so its top-left can sit up to maxSize.x left of the view and up to
+    // (maxSize.y - tileH) below it and still be visible.
+    const glm::vec2 viewMin = camera.GetPosition();
+    const glm::vec2 viewMax = viewMin + glm::vec2(viewportSizePx);
+
+    const glm::vec2 cornerMin = ComputeTileDiagonalsFromWorldPos(
+        glm::vec2(viewMin.x - maxSize.x, viewMin.y - baseSize.y),
+        baseSize.x, baseSize.y, mapOrigin);
+    const glm::vec2 cornerMax = ComputeTileDiagonalsFromWorldPos(
+        glm::vec2(viewMax.x, viewMax.y + (maxSize.y - baseSize.y)),
+        baseSize.x, baseSize.y, mapOrigin);
+
+    range.minDiff = (int)std::floor(cornerMin.x);
+    range.maxDiff = (int)std::ceil(cornerMax.x);
+    range.minSum = (int)std::floor(cornerMin.y);
+    range.maxSum = (int)std::ceil(cornerMax.y);
+
+    // Rows touched by the diamond: y = ((x + y) - (x - y)) / 2
+    range.minY = std::max(0, (int)std::floor((range.minSum - range.maxDiff) * 0.5f));
+    range.maxY = std::min(mHeight - 1, (int)std::ceil((range.maxSum - range.minDiff) * 0.5f));
+
+    return range;
+}
+
+void TileMap::DrawGround(SpriteRenderer& renderer,
     const TileResolver& resolver,
     const Camera2D& camera,
+    const glm::ivec2& viewportSizePx) const
+{
+    if (mMeshesBuilt)
+        DrawPass(LayerPass::Ground, renderer, resolver, camera, viewportSizePx);
+    else
+        DrawPassCells(LayerPass::Ground, renderer, resolver, camera, viewportSizePx);
+}
+
+void TileMap::AppendStaticOccluders(RenderQueue& queue,
+    const TileResolver& resolver,
+    const glm::ivec2& viewportSizePx)
+{
+    std::vector<RenderCmd> cmds;
+    BuildStaticOccluderCmds(resolver, viewportSizePx, cmds);
+
+    mStaticIndices.clear();
+    for (const RenderCmd& cmd : cmds)
+        mStaticIndices.push_back(queue.PushStatic(cmd));
+
+    for (StaticOccluder& occluder : mStaticAnimated)
+        occluder.queueIndex = mStaticIndices[occluder.queueIndex];
+}
+
+void TileMap::InsertStaticOccluders(RenderQueue& queue,
+    const TileResolver& resolver,
+    const glm::ivec2& viewportSizePx)
+{
+    std::vector<RenderCmd> cmds;
+    BuildStaticOccluderCmds(resolver, viewportSizePx, cmds);
+
+    queue.InsertStatic(cmds, mStaticIndices);
+
+    for (StaticOccluder& occluder : mStaticAnimated)
+        occluder.queueIndex = mStaticIndices[occluder.queueIndex];
+}
+
+void TileMap::RemoveStaticOccluders(RenderQueue& queue)
+{
+    queue.RemoveStatic(mStaticIndices);
+    mStaticIndices.clear();
+    mStaticAnimated.clear();
+}
+
+void TileMap::BuildStaticOccluderCmds(const TileResolver& resolver,
     const glm::ivec2& viewportSizePx,
-    float animationTimeMs) const
+    std::vector<RenderCmd>& cmds)
 {
-    (void)camera;
-    const glm::vec2 mapOrigin(viewportSizePx.x * 0.5f, 60.0f);
-    glm::vec2 baseSize((float)mTileWidthPx, (float)mTileHeightPx);
+    const glm::vec2 mapOrigin = GetMapOrigin(viewportSizePx);
+
+    cmds.clear();
+    mStaticAnimated.clear();
+
+    std::vector<size_t> occluderLayers;
+    for (size_t layer = 0; layer < mLayers.size(); ++layer)
+    {
+        if (mLayers[layer].visible && mLayers[layer].pass == LayerPass::Occluder)
+            occluderLayers.push_back(layer);
+    }
 
+    if (occluderLayers.empty())
+        return;
+
+    // Row-major order keeps the old tie order (the static sort is stable).
     for (int y = 0; y < mHeight; ++y)
     {
         for (int x = 0; x < mWidth; ++x)
         {
-            glm::vec2 worldPos = ComputeTileTopLeftWorldPos(x, y, (float)mTileWidthPx, (float)mTileHeightPx, mapOrigin);
-
-            for (const TileLayer& layer : mLayers)
+            for (size_t layer : occluderLayers)
             {
-                if (!layer.visible || !layer.renderable)
-                    continue;
-
                 uint32_t gid = GetLayerTile(layer, x, y);
                 if (gid == 0)
                     continue;
 
                 ResolvedTile resolved{};
-                if (!resolver.Resolve(gid, animationTimeMs, resolved))
+                if (!resolver.Resolve(gid, resolved))
                     continue;
 
-                glm::vec2 drawSize = resolved.sizePx;
-                if (drawSize.x <= 0.0f)
-                    drawSize.x = baseSize.x;
-                if (drawSize.y <= 0.0f)
-                    drawSize.y = baseSize.y;
-
-                glm::vec2 drawPos = worldPos;
-                drawPos.y -= (drawSize.y - baseSize.y);
+                glm::vec2 drawPos, drawSize;
+                ComputeTileRect(x, y, resolved, mapOrigin, drawPos, drawSize);
 
                 RenderCmd cmd{};
                 cmd.texture = resolved.textureId;
@@ -137,20 +589,56 @@ void TileMap::AppendOccluders(RenderQueue& queue,
                 cmd.uvMin = resolved.uvMin;
                 cmd.uvMax = resolved.uvMax;
 
-                glm::vec2 feetWorld = cmd.posPx + glm::vec2(cmd.sizePx.x * 0.5f, cmd.sizePx.y);
-                cmd.depthKey = DepthFromFeetWorldY(feetWorld.y);
+                // Tiles grow upwards from the cell bottom, so the feet (and the
+                // depth) stay put when an animation frame changes size or trim.
+                const float feetWorldY = ComputeTileTopLeftWorldPos(x, y, (float)mTileWidthPx, (float)mTileHeightPx, mapOrigin).y
+                    + (float)mTileHeightPx;
+                cmd.depthKey = DepthFromFeetWorldY(feetWorldY);
 
-                queue.Push(cmd);
+                const uint32_t cmdIndex = static_cast<uint32_t>(cmds.size());
+                cmds.push_back(cmd);
+
+                const int animSlot = resolver.GetAnimationSlot(gid);
+                if (animSlot >= 0)
+                    mStaticAnimated.push_back({ cmdIndex, animSlot, gid, x, y });
             }
         }
     }
 }
 
+void TileMap::UpdateStaticOccluders(RenderQueue& queue,
+    const TileResolver& resolver,
+    const glm::ivec2& viewportSizePx) const
+{
+    const glm::vec2 mapOrigin = GetMapOrigin(viewportSizePx);
+    const TileAnimationClock& clock = resolver.GetAnimationClock();
+
+    for (const StaticOccluder& occluder : mStaticAnimated)
+    {
+        if (!clock.FrameChanged(occluder.animSlot))
+            continue;
+
+        ResolvedTile resolved{};
+        if (!resolver.Resolve(occluder.gid, resolved))
+            continue;
+
+        RenderCmd cmd = queue.GetStatic(occluder.queueIndex);
+        cmd.texture = resolved.textureId;
+        cmd.uvMin = resolved.uvMin;
+        cmd.uvMax = resolved.uvMax;
+        ComputeTileRect(occluder.x, occluder.y, resolved, mapOrigin, cmd.posPx, cmd.sizePx);
+
+        queue.UpdateStatic(occluder.queueIndex, cmd);
+    }
+}
+
 void TileMap::DrawOverhead(SpriteRenderer& renderer,
     const TileResolver& resolver,
     const Camera2D& camera,
-    const glm::ivec2& viewportSizePx,
-    float animationTimeMs) const
+    const glm::ivec2& viewportSizePx) const
 {
-    DrawGround(renderer, resolver, camera, viewportSizePx, animationTimeMs);
+    if (mMeshesBuilt)
+        DrawPass(LayerPass::Overhead, renderer, resolver, camera, viewportSizePx);
+    else
+        DrawPassCells(LayerPass::Overhead, renderer, resolver, camera, viewportSizePx);
 }
@@ -7,31 +7,84 @@
 #include <string>
 #include <vector>
 
+#include "ArrayView.h"
 #include "RenderQueue.h"
+#include "SpriteRenderer.h"
+#include "TmxLoader.h"
 
-class SpriteRenderer;
 class Camera2D;
 class TileResolver;
+struct ResolvedTile;
 
+// A layer's gids live in the TileMap's chunks only (see AddLayer).
 struct TileLayer
 {
     std::string name;
-    std::vector<uint32_t> tiles;
+    LayerPass pass = LayerPass::Ground;
     bool visible = true;
-    bool renderable = true;
+};
+
+/*
+    TileRange
+    ---------
+    Cells visible through the viewport. The screen rectangle maps to a
+    diamond in grid space, so besides the bounding rows we keep the
+    diagonal bounds:
+        (x - y) in [minDiff, maxDiff]   (screen X)
+        (x + y) in [minSum,  maxSum]    (screen Y)
+*/
+struct TileRange
+{
+    int minY = 0;
+    int maxY = -1;
+
+    int minDiff = 0;
+    int maxDiff = -1;
+    int minSum = 0;
+    int maxSum = -1;
+
+    int mapWidth = 0;
+
+    bool IsEmpty() const { return maxY < minY; }
+
+    // Inclusive x span of row y; outX1 < outX0 when the row is empty.
+    void GetRowSpan(int y, int& outX0, int& outX1) const;
 };
 
 /*
     TileMap
     -------
-    Stores raw TMX gids in multiple 2D layers and draws them using a TileResolver.
+    Every tile layer of a map (or of one streamed chunk), drawn through a
+    TileResolver. Gids are stored per kChunkSize x kChunkSize chunk as
+    structure-of-arrays: one contiguous run of cells per layer, so a chunk's
+    layers sit next to each other in memory.
+
+    A layer's pass (LayerPass) decides where its tiles go:
+      - Ground / Overhead: BuildChunkMeshes() bakes each layer of each chunk
+        into a static mesh of GPU quads (grouped by texture; one mesh per
+        layer, drawn layer by layer across the visible chunks, keeps the
+        layer stacking at chunk borders). Animated quads are patched in place
+        when their frame changes. Tiles bigger than a grid cell stay on the
+        per-sprite path so their painter order is unchanged.
+      - Occluder: AppendStaticOccluders() pushes them into a RenderQueue's
+        static partition, depth sorted with the actors.
+
+    Each frame CullVisible() finds the visible range and walks the visible
+    chunks once for both mesh passes; DrawGround / DrawOverhead only submit
+    what it collected.
 */
 class TileMap
 {
 public:
     TileMap(int width, int height, int tileWidthPx, int tileHeightPx);
 
-    void AddLayer(const std::string& name, const std::vector<uint32_t>& tiles, bool visible, bool renderable);
+    // Layers that aren't exactly width * height are ignored (e.g. absent in the TMX).
+    // The gids are copied into the chunks; tiles isn't kept. For a cooked
+    // map that copy reads (and makes resident) every page of the layer.
+    void AddLayer(const std::string& name, ArrayView<uint32_t> tiles, LayerPass pass, bool visible);
+
+    size_t GetLayerCount() const { return mLayers.size(); }
+    const TileLayer& GetLayer(size_t layer) const { return mLayers[layer]; }
 
     int GetWidth() const { return mWidth; }
     int GetHeight() const { return mHeight; }
@@ -39,28 +92,175 @@ public:
     int GetTileWidthPx() const { return mTileWidthPx; }
     int GetTileHeightPx() const { return mTileHeightPx; }
 
-    void DrawGround(SpriteRenderer& renderer,
+    // Cell (x, y) is drawn at map cell (x + offset.x, y + offset.y); used by
+    // the per-chunk TileMaps of infinite maps. Set before building meshes.
+    void SetCellOffset(const glm::ivec2& offset) { mCellOffset = offset; }
+
+    static constexpr int kChunkSize = 32;
+    static constexpr int kChunkCells = kChunkSize * kChunkSize;
+
+    // Call after all layers are added and the resolver is rebuilt.
+    void BuildChunkMeshes(SpriteRenderer& renderer, const TileResolver& resolver);
+
+    // After ApplyMapDiff() edited mapData (hot reload): copy the edited cells
+    // in from its layers and rebuild only the chunk meshes holding them.
+    // cells index the layers back to back (layer * width * height + y * width + x,
+    // as MapDiff::layerCells). Occluder cells are copied but rebuild nothing:
+    // re-run AppendStaticOccluders for those. Returns the number of chunks
+    // rebuilt (0 before BuildChunkMeshes()).
+    size_t RebuildChunkMeshes(SpriteRenderer& renderer, const TileResolver& resolver, const MapData& mapData,
+        const std::vector<uint32_t>& cells);
+
+    // Cells whose tiles can touch the viewport. maxTileSizePx pads the range
+    // for tiles taller / wider than the map grid (see TileResolver).
+    TileRange GetVisibleTileRange(const Camera2D& camera,
+        const glm::ivec2& viewportSizePx,
+        const glm::vec2& maxTileSizePx) const;
+
+    // Once per frame, before DrawGround / DrawOverhead: the visibility pass
+    // for both. Also advances the animated quads of the visible chunks.
+    void CullVisible(SpriteRenderer& renderer,
         const TileResolver& resolver,
         const Camera2D& camera,
-        const glm::ivec2& viewportSizePx,
-        float animationTimeMs) const;
+        const glm::ivec2& viewportSizePx);
 
-    void AppendOccluders(RenderQueue& queue,
+    // Ground layers of what CullVisible() found.
+    void DrawGround(SpriteRenderer& renderer,
         const TileResolver& resolver,
         const Camera2D& camera,
-        const glm::ivec2& viewportSizePx,
-        float animationTimeMs) const;
+        const glm::ivec2& viewportSizePx) const;
+
+    // Push every occluder tile into the queue's static partition (call SortStatic after).
+    // Positions depend on the viewport width (map origin), so rebuild on resize.
+    void AppendStaticOccluders(RenderQueue& queue,
+        const TileResolver& resolver,
+        const glm::ivec2& viewportSizePx);
 
+    // Same tiles, merged into an already sorted static partition (streamed
+    // chunks activated mid-game); RemoveStaticOccluders takes them out again.
+    void InsertStaticOccluders(RenderQueue& queue,
+        const TileResolver& resolver,
+        const glm::ivec2& viewportSizePx);
+
+    void RemoveStaticOccluders(RenderQueue& queue);
+
+    // Rewrite the static commands of animated tiles whose frame changed.
+    void UpdateStaticOccluders(RenderQueue& queue,
+        const TileResolver& resolver,
+        const glm::ivec2& viewportSizePx) const;
+
+    // Overhead layers of what CullVisible() found.
     void DrawOverhead(SpriteRenderer& renderer,
         const TileResolver& resolver,
         const Camera2D& camera,
-        const glm::ivec2& viewportSizePx,
-        float animationTimeMs) const;
+        const glm::ivec2& viewportSizePx) const;
+
+    // One layer of what CullVisible() found, for several TileMaps sharing
+    // the layer list (streamed chunks): draw the layer's meshes of every map,
+    // then its loose tiles of every map, so tiles overlapping a neighbour map
+    // stack as they would inside one. Nothing before BuildChunkMeshes().
+    void DrawLayerMeshes(size_t layer,
+        SpriteRenderer& renderer,
+        const Camera2D& camera,
+        const glm::ivec2& viewportSizePx) const;
+
+    void DrawLayerLooseTiles(size_t layer,
+        SpriteRenderer& renderer,
+        const TileResolver& resolver,
+        const Camera2D& camera,
+        const glm::ivec2& viewportSizePx) const;
 
 private:
-    int Index(int x, int y) const { return y * mWidth + x; }
+    // Animated quad baked into a chunk mesh.
+    struct AnimatedQuad
+    {
+        int meshQuad = -1;
+        int animSlot = -1;
+        uint32_t gid = 0;
+        uint32_t frameGid = 0;
+        GLuint texture = 0;
+        int x = 0;
+        int y = 0;
+        int layer = 0;
+    };
+
+    // Tile drawn through SpriteRenderer::Draw (not part of a chunk mesh).
+    struct LooseTile
+    {
+        int x = 0;
+        int y = 0;
+        int layer = 0;
+        uint32_t gid = 0;
+    };
+
+    // Animated tile living in a RenderQueue's static partition.
+    struct StaticOccluder
+    {
+        uint32_t queueIndex = 0;
+        int animSlot = -1;
+        uint32_t gid = 0;
+        int x = 0;
+        int y = 0;
+    };
+
+    struct Chunk
+    {
+        // Layer-major: layer l's cell (x, y) is gids[l * kChunkCells + localY * kChunkSize + localX].
+        std::vector<uint32_t> gids;
+
+        std::vector<SpriteMesh> meshes; // one per layer, empty for occluder / hidden layers
+        std::vector<AnimatedQuad> animated;
+        std::vector<LooseTile> looseTiles;
+    };
+
+    // Per-build scratch, reused across chunks.
+    struct ChunkScratch
+    {
+        std::vector<SpriteQuad> quads;
+        std::vector<AnimatedQuad> animated;
+        std::vector<int> quadIndices;
+    };
+
+    size_t ChunkIndex(int x, int y) const { return (size_t)(y / kChunkSize) * mChunksX + x / kChunkSize; }
+    static int LocalIndex(int x, int y) { return (y % kChunkSize) * kChunkSize + x % kChunkSize; }
+
+    bool IsMeshLayer(const TileLayer& layer) const
+    {
+        return layer.visible && (layer.pass == LayerPass::Ground || layer.pass == LayerPass::Overhead);
+    }
+
+    // Viewport map origin shifted by the cell offset.
+    glm::vec2 GetMapOrigin(const glm::ivec2& viewportSizePx) const;
+
+    uint32_t GetLayerTile(size_t layer, int x, int y) const;
+
+    // Copies tiles (one whole layer) into the chunks, cells [begin, end) (y * width + x).
+    void CopyLayerCells(size_t layer, ArrayView<uint32_t> tiles, size_t begin, size_t end);
+
+    // Tile quad for a resolved gid at cell (x, y); mapOrigin is added to the position.
+    void ComputeTileRect(int x, int y, const ResolvedTile& resolved, const glm::vec2& mapOrigin,
+        glm::vec2& outPos, glm::vec2& outSize) const;
 
-    uint32_t GetLayerTile(const TileLayer& layer, int x, int y) const;
+    bool IsCellSized(const glm::vec2& size) const;
+
+    // Layer by layer (the TMX order) for the layers of one pass: the layer's
+    // mesh in every visible chunk, then its visible loose tiles.
+    void DrawPass(LayerPass pass,
+        SpriteRenderer& renderer,
+        const TileResolver& resolver,
+        const Camera2D& camera,
+        const glm::ivec2& viewportSizePx) const;
+
+    // Per-sprite path for maps without chunk meshes.
+    void DrawPassCells(LayerPass pass,
+        SpriteRenderer& renderer,
+        const TileResolver& resolver,
+        const Camera2D& camera,
+        const glm::ivec2& viewportSizePx) const;
+
+    void BuildChunk(int cx, int cy, SpriteRenderer& renderer, const TileResolver& resolver, ChunkScratch& scratch);
+
+    void UpdateChunkAnimations(Chunk& chunk, SpriteRenderer& renderer, const TileResolver& resolver) const;
 
 private:
     int mWidth = 0;
@@ -69,5 +269,27 @@ private:
     int mTileWidthPx = 0;
     int mTileHeightPx = 0;
 
+    glm::ivec2 mCellOffset{ 0, 0 };
+
     std::vector<TileLayer> mLayers;
+
+    int mChunksX = 0;
+    int mChunksY = 0;
+
+    std::vector<Chunk> mChunks;
+    bool mMeshesBuilt = false;
+
+    // CullVisible() results, read by DrawGround / DrawOverhead.
+    TileRange mVisibleRange;
+    std::vector<uint32_t> mVisibleChunks;
+    std::vector<std::vector<LooseTile>> mVisibleLooseTiles; // per layer, sorted by cell
+
+    // Occluder commands with queueIndex = index into cmds; the callers map
+    // them to queue indices.
+    void BuildStaticOccluderCmds(const TileResolver& resolver,
+        const glm::ivec2& viewportSizePx,
+        std::vector<RenderCmd>& cmds);
+
+    std::vector<StaticOccluder> mStaticAnimated;
+    std::vector<uint32_t> mStaticIndices; // every command this map put in the queue
 };
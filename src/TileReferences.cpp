@@ -0,0 +1,104 @@
+#include "TileReferences.h"
+
+#include "ArrayView.h"
+#include "MapBundle.h"
+#include "TileLayerData.h"
+
+#include <algorithm>
+
+namespace
+{
+    // One past the highest gid any tileset defines.
+    uint32_t GetGidLimit(const MapData& mapData)
+    {
+        uint32_t limit = 1;
+        for (const TilesetDef& def : mapData.tilesets)
+        {
+            int count = def.tileCount;
+            if (count <= 0 && def.tileW > 0 && def.tileH > 0)
+                count = (def.imageW / def.tileW) * (def.imageH / def.tileH);
+            for (const auto& entry : def.tileImages)
+                count = std::max(count, entry.first + 1);
+
+            if (def.firstGid > 0 && count > 0)
+                limit = std::max(limit, static_cast<uint32_t>(def.firstGid + count));
+        }
+        return limit;
+    }
+
+    void MarkGids(const uint32_t* gids, size_t count, std::vector<uint8_t>& referenced)
+    {
+        const size_t limit = referenced.size();
+        for (size_t i = 0; i < count; ++i)
+        {
+            const uint32_t gid = gids[i] & kTmxGidMask;
+            if (gid < limit)
+                referenced[gid] = 1;
+        }
+    }
+
+    void MarkLayer(ArrayView<uint32_t> gids, std::vector<uint8_t>& referenced)
+    {
+        MarkGids(gids.data(), gids.size(), referenced);
+    }
+
+    void MarkChunkLayer(const MapChunkLayer& layer, size_t cellCount, std::vector<uint32_t>& scratch,
+        std::vector<uint8_t>& referenced)
+    {
+        if (layer.data.empty())
+            return;
+
+        scratch.resize(cellCount);
+        size_t count = 0;
+        if (DecodeTileLayerGids(layer.format, layer.data.data(), layer.data.size(), scratch.data(), scratch.size(), count))
+            MarkGids(scratch.data(), count, referenced);
+    }
+}
+
+void CollectReferencedGids(const MapData& mapData, const MapBundle* bundle, std::vector<uint8_t>& outReferenced)
+{
+    outReferenced.assign(GetGidLimit(mapData), 0);
+
+    if (bundle && bundle->IsOpen())
+    {
+        MarkLayer(bundle->GetLayerGids(), outReferenced);
+    }
+    else
+    {
+        MarkLayer(mapData.layerGids, outReferenced);
+    }
+
+    // Infinite maps: every chunk, not just the ones around the spawn.
+    std::vector<uint32_t> scratch;
+    for (const auto& entry : mapData.chunks)
+    {
+        const MapChunkDef& chunk = entry.second;
+        const size_t cellCount = static_cast<size_t>(std::max(0, chunk.width)) * static_cast<size_t>(std::max(0, chunk.height));
+        for (const MapChunkLayer& layer : chunk.layers)
+            MarkChunkLayer(layer, cellCount, scratch, outReferenced);
+    }
+
+    for (const MapObjectInstance& instance : mapData.objectInstances)
+    {
+        const uint32_t gid = instance.tileIndex & kTmxGidMask;
+        if (gid < outReferenced.size())
+            outReferenced[gid] = 1;
+    }
+
+    // Frames of animations the map starts (Tiled frames are never animated themselves).
+    for (const TilesetDef& def : mapData.tilesets)
+    {
+        for (const auto& [tileId, animation] : def.animations)
+        {
+            if (!IsGidReferenced(outReferenced, static_cast<uint32_t>(def.firstGid + tileId)))
+                continue;
+
+            for (const AnimationFrame& frame : animation.frames)
+            {
+                const uint32_t gid = static_cast<uint32_t>(def.firstGid + frame.tileId);
+                if (gid < outReferenced.size())
+                    outReferenced[gid] = 1;
+            }
+        }
+    }
+}
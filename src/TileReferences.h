@@ -0,0 +1,27 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "TmxLoader.h"
+
+class MapBundle;
+
+/*
+    Referenced gids
+    ---------------
+    The gids a map can draw: every cell of the ground / walls / overhead
+    layers (the bundle's arrays when it is open, every encoded chunk of an
+    infinite map), every tile object, and every frame of the animations
+    those start. Indexed by gid, flip flags masked off: out[gid] != 0.
+
+    TilesetRegistry loads only these tiles of an image collection; the
+    rest of the collection waits for its first resolve (TileResolver's
+    deferred gids). One pass over the layers, no allocation per cell.
+*/
+void CollectReferencedGids(const MapData& mapData, const MapBundle* bundle, std::vector<uint8_t>& outReferenced);
+
+inline bool IsGidReferenced(const std::vector<uint8_t>& referenced, uint32_t gid)
+{
+    return gid < referenced.size() && referenced[gid] != 0;
+}
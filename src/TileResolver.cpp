@@ -2,9 +2,107 @@
 
 #include <algorithm>
 
+namespace
+{
+    // Trim rect of an image-collection tile as fractions of its image, and
+    // the region's UVs narrowed to it.
+    void ComputeTrim(const TileImageDef& image, const TileImageRegion& region,
+        glm::vec2& outTrimMin, glm::vec2& outTrimMax, glm::vec2& outUvMin, glm::vec2& outUvMax)
+    {
+        outTrimMin = glm::vec2(0.0f);
+        outTrimMax = glm::vec2(1.0f);
+        if (image.trimW > 0 && image.trimH > 0 && image.w > 0 && image.h > 0)
+        {
+            const glm::vec2 size(static_cast<float>(image.w), static_cast<float>(image.h));
+            outTrimMin = glm::vec2(static_cast<float>(image.trimX), static_cast<float>(image.trimY)) / size;
+            outTrimMax = glm::vec2(static_cast<float>(image.trimX + image.trimW),
+                static_cast<float>(image.trimY + image.trimH)) / size;
+        }
+
+        outUvMin = glm::mix(region.uvMin, region.uvMax, outTrimMin);
+        outUvMax = glm::mix(region.uvMin, region.uvMax, outTrimMax);
+    }
+}
+
 TileResolver::TileResolver(const std::vector<TilesetRuntime>& tilesets)
     : mTilesets(tilesets)
 {
+    Rebuild();
+}
+
+void TileResolver::Rebuild()
+{
+    mGidTable.clear();
+    mDeferredGids.clear();
+    mAnimationClock.Clear();
+    mMaxTileSizePx = glm::vec2(0.0f);
+
+    // Image collections already store their largest image in tileW / tileH.
+    uint32_t maxGid = 0;
+    for (const TilesetRuntime& runtime : mTilesets)
+    {
+        const TilesetDef& def = runtime.def;
+        mMaxTileSizePx.x = std::max(mMaxTileSizePx.x, static_cast<float>(def.tileW));
+        mMaxTileSizePx.y = std::max(mMaxTileSizePx.y, static_cast<float>(def.tileH));
+
+        const int tileCount = def.tileCount > 0 ? def.tileCount : runtime.tileset.GetGridTileCount();
+        if (def.firstGid > 0 && tileCount > 0)
+            maxGid = std::max(maxGid, static_cast<uint32_t>(def.firstGid + tileCount - 1));
+    }
+
+    mGidTable.resize(static_cast<size_t>(maxGid) + 1);
+
+    for (size_t i = 0; i < mTilesets.size(); ++i)
+    {
+        const TilesetRuntime& runtime = mTilesets[i];
+        const TilesetDef& def = runtime.def;
+
+        const int tileCount = def.tileCount > 0 ? def.tileCount : runtime.tileset.GetGridTileCount();
+        for (int localId = 0; localId < tileCount; ++localId)
+        {
+            const uint32_t gid = static_cast<uint32_t>(def.firstGid + localId);
+
+            // Overlapping ranges belong to the tileset with the highest firstGid.
+            if (FindTilesetIndex(gid) != static_cast<int>(i))
+                break;
+
+            GidEntry& entry = mGidTable[gid];
+            entry.tilesetIndex = static_cast<int>(i);
+            entry.localId = localId;
+            entry.sizePx = glm::vec2(static_cast<float>(def.tileW), static_cast<float>(def.tileH));
+
+            if (def.isImageCollection)
+            {
+                const auto imageIt = def.tileImages.find(localId);
+                const auto textureIt = runtime.tileTextures.find(localId);
+                if (imageIt != def.tileImages.end() && textureIt == runtime.tileTextures.end())
+                {
+                    // Not referenced by the map: loaded on first resolve.
+                    entry.deferred = true;
+                }
+                else if (imageIt != def.tileImages.end() && textureIt->second.textureId != 0)
+                {
+                    const TileImageRegion& region = textureIt->second;
+                    entry.textureId = region.textureId;
+                    ComputeTrim(imageIt->second, region, entry.trimMin, entry.trimMax, entry.uvMin, entry.uvMax);
+                    entry.sizePx = glm::vec2(static_cast<float>(imageIt->second.w),
+                        static_cast<float>(imageIt->second.h));
+                    entry.isFullTexture = entry.uvMin == glm::vec2(0.0f) && entry.uvMax == glm::vec2(1.0f);
+                    entry.valid = true;
+                }
+            }
+            else
+            {
+                entry.textureId = runtime.textureId;
+                runtime.tileset.GetUV(localId, entry.uvMin, entry.uvMax);
+                entry.valid = true;
+            }
+
+            const auto animIt = def.animations.find(localId);
+            if (animIt != def.animations.end())
+                entry.animIndex = mAnimationClock.Register(animIt->second, def.firstGid);
+        }
+    }
 }
 
 int TileResolver::FindTilesetIndex(uint32_t gid) const
@@ -25,7 +123,56 @@ int TileResolver::FindTilesetIndex(uint32_t gid) const
     return bestIndex;
 }
 
-bool TileResolver::Resolve(uint32_t gid, float animationTimeMs, ResolvedTile& outResolved) const
+bool TileResolver::Resolve(uint32_t gid, ResolvedTile& outResolved) const
+{
+    if (gid == 0 || gid >= mGidTable.size())
+        return false;
+
+    const GidEntry* entry = &mGidTable[gid];
+    if (entry->animIndex >= 0)
+    {
+        const uint32_t frameGid = mAnimationClock.GetFrameGid(entry->animIndex);
+        if (frameGid == 0 || frameGid >= mGidTable.size())
+            return false;
+
+        entry = &mGidTable[frameGid];
+    }
+
+    if (!entry->valid)
+    {
+        if (entry->deferred)
+            RequestDeferred(*entry);
+        return false;
+    }
+
+    outResolved.textureId = entry->textureId;
+    outResolved.uvMin = entry->uvMin;
+    outResolved.uvMax = entry->uvMax;
+    outResolved.sizePx = entry->sizePx;
+    outResolved.trimMin = entry->trimMin;
+    outResolved.trimMax = entry->trimMax;
+    outResolved.isFullTexture = entry->isFullTexture;
+    outResolved.tilesetIndex = entry->tilesetIndex;
+    outResolved.localId = entry->localId;
+    return true;
+}
+
+void TileResolver::RequestDeferred(const GidEntry& entry) const
+{
+    if (entry.requested)
+        return;
+
+    entry.requested = true;
+    mDeferredGids.push_back(static_cast<uint32_t>(&entry - mGidTable.data()));
+}
+
+void TileResolver::TakeDeferredGids(std::vector<uint32_t>& outGids)
+{
+    outGids.clear();
+    outGids.swap(mDeferredGids);
+}
+
+bool TileResolver::ResolveByScan(uint32_t gid, float animationTimeMs, ResolvedTile& outResolved) const
 {
     if (gid == 0)
         return false;
@@ -50,6 +197,8 @@ bool TileResolver::Resolve(uint32_t gid, float animationTimeMs, ResolvedTile& ou
     outResolved.localId = resolvedId;
     outResolved.isFullTexture = false;
     outResolved.sizePx = glm::vec2(static_cast<float>(def.tileW), static_cast<float>(def.tileH));
+    outResolved.trimMin = glm::vec2(0.0f);
+    outResolved.trimMax = glm::vec2(1.0f);
 
     if (def.isImageCollection)
     {
@@ -58,16 +207,16 @@ bool TileResolver::Resolve(uint32_t gid, float animationTimeMs, ResolvedTile& ou
             return false;
 
         const auto textureIt = runtime.tileTextures.find(resolvedId);
-        if (textureIt == runtime.tileTextures.end())
+        if (textureIt == runtime.tileTextures.end() || textureIt->second.textureId == 0)
             return false;
 
-        outResolved.textureId = textureIt->second;
+        const TileImageRegion& region = textureIt->second;
+        outResolved.textureId = region.textureId;
         outResolved.sizePx = glm::vec2(static_cast<float>(imageIt->second.w),
             static_cast<float>(imageIt->second.h));
 
-        outResolved.uvMin = glm::vec2(0.0f, 0.0f);
-        outResolved.uvMax = glm::vec2(1.0f, 1.0f);
-        outResolved.isFullTexture = true;
+        ComputeTrim(imageIt->second, region, outResolved.trimMin, outResolved.trimMax, outResolved.uvMin, outResolved.uvMax);
+        outResolved.isFullTexture = outResolved.uvMin == glm::vec2(0.0f) && outResolved.uvMax == glm::vec2(1.0f);
     }
     else
     {
@@ -4,40 +4,126 @@
 #include <glad/glad.h>
 
 #include <cstdint>
+#include <string>
 #include <unordered_map>
 #include <vector>
 
+#include "TileAnimationClock.h"
 #include "TileSet.h"
 #include "TmxLoader.h"
 
 struct ResolvedTile
 {
     GLuint textureId = 0;
-    glm::vec2 uvMin{ 0.0f, 0.0f };
+    glm::vec2 uvMin{ 0.0f, 0.0f };   // already narrowed to the trim rect
     glm::vec2 uvMax{ 1.0f, 1.0f };
-    glm::vec2 sizePx{ 0.0f, 0.0f };
+    glm::vec2 sizePx{ 0.0f, 0.0f };  // untrimmed: placement and depth use this
+    glm::vec2 trimMin{ 0.0f, 0.0f }; // drawn part of sizePx, as fractions
+    glm::vec2 trimMax{ 1.0f, 1.0f };
     bool isFullTexture = false;
     int tilesetIndex = -1;
     int localId = -1;
 };
 
+// Narrow a tile's untrimmed rect to the part that has opaque texels.
+inline void ApplyTileTrim(const ResolvedTile& tile, glm::vec2& posPx, glm::vec2& sizePx)
+{
+    posPx += sizePx * tile.trimMin;
+    sizePx *= tile.trimMax - tile.trimMin;
+}
+
+// Image-collection tile: its own texture (full UVs) or a region of an atlas page.
+// textureId 0 = the image failed to load; the tile is not drawn.
+struct TileImageRegion
+{
+    GLuint textureId = 0;
+    glm::vec2 uvMin{ 0.0f, 0.0f };
+    glm::vec2 uvMax{ 1.0f, 1.0f };
+};
+
 struct TilesetRuntime
 {
     TilesetDef def;
     TileSet tileset;
     GLuint textureId = 0;
-    std::unordered_map<int, GLuint> tileTextures;
+    std::unordered_map<int, TileImageRegion> tileTextures; // loaded tiles only (see TilesetRegistry)
+    std::string registryKey; // TilesetRegistry entry holding the textures
 };
 
+/*
+    TileResolver
+    ------------
+    gid -> texture / UV rect / size.
+
+    Rebuild() flattens every tileset into a dense gid-indexed table, so a
+    static tile resolves with a single array load. Animated gids hold a
+    TileAnimationClock slot; the clock is advanced once per frame and the
+    current frame gid re-enters the table.
+
+    Call Rebuild() whenever the TilesetRuntime vector changes (map load),
+    and AdvanceAnimations() once per frame before resolving.
+
+    Image-collection tiles the map doesn't reference have no texture yet.
+    Resolving one fails and queues its gid (once per Rebuild); the owner
+    loads what TakeDeferredGids() returns and calls Rebuild() again. The
+    queue is the only state Resolve() writes: main thread only.
+*/
 class TileResolver
 {
 public:
     explicit TileResolver(const std::vector<TilesetRuntime>& tilesets);
 
-    bool Resolve(uint32_t gid, float animationTimeMs, ResolvedTile& outResolved) const;
+    void Rebuild();
+
+    void AdvanceAnimations(float animationTimeMs) { mAnimationClock.Advance(animationTimeMs); }
+
+    const TileAnimationClock& GetAnimationClock() const { return mAnimationClock; }
+
+    // Clock slot of an animated gid, -1 for static (or unknown) gids.
+    int GetAnimationSlot(uint32_t gid) const
+    {
+        return gid < mGidTable.size() ? mGidTable[gid].animIndex : -1;
+    }
+
+    bool Resolve(uint32_t gid, ResolvedTile& outResolved) const;
+
+    // Gids Resolve() failed on because their image isn't loaded yet.
+    bool HasDeferredGids() const { return !mDeferredGids.empty(); }
+    void TakeDeferredGids(std::vector<uint32_t>& outGids);
+
+    // Reference path: linear tileset scan + per-call hash lookups / UV math.
+    // Kept for the resolver benchmark and to validate the table.
+    bool ResolveByScan(uint32_t gid, float animationTimeMs, ResolvedTile& outResolved) const;
+
+    // Largest tile drawn by any tileset (used to pad viewport culling).
+    glm::vec2 GetMaxTileSizePx() const { return mMaxTileSizePx; }
 
 private:
+    struct GidEntry
+    {
+        GLuint textureId = 0;
+        glm::vec2 uvMin{ 0.0f, 0.0f };
+        glm::vec2 uvMax{ 1.0f, 1.0f };
+        glm::vec2 sizePx{ 0.0f, 0.0f };
+        glm::vec2 trimMin{ 0.0f, 0.0f };
+        glm::vec2 trimMax{ 1.0f, 1.0f };
+        int animIndex = -1; // TileAnimationClock slot, -1 when static
+        int tilesetIndex = -1;
+        bool isFullTexture = false;
+        bool valid = false;
+        bool deferred = false;          // collection tile whose image isn't loaded yet
+        mutable bool requested = false; // already in mDeferredGids
+        int localId = -1;
+    };
+
     int FindTilesetIndex(uint32_t gid) const;
+    void RequestDeferred(const GidEntry& entry) const;
 
     const std::vector<TilesetRuntime>& mTilesets;
+
+    std::vector<GidEntry> mGidTable;
+    TileAnimationClock mAnimationClock;
+    glm::vec2 mMaxTileSizePx{ 0.0f, 0.0f };
+
+    mutable std::vector<uint32_t> mDeferredGids;
 };
@@ -27,6 +27,9 @@ public:
     // Resolve an animated tile to the correct frame based on accumulated time (ms).
     int ResolveTileId(int tileId, float animationTimeMs) const;
 
+    // Number of cells in the atlas grid (0 when the atlas size is unknown).
+    int GetGridTileCount() const { return mCols * mRows; }
+
     // tileId: 0-based index into atlas grid (left->right, top->bottom)
     void GetUV(int tileId, glm::vec2& outUvMin, glm::vec2& outUvMax) const;
 
@@ -0,0 +1,58 @@
+#include "TileTrim.h"
+
+#include <algorithm>
+#include <cmath>
+
+bool ComputeAlphaBounds(const uint8_t* rgba, int width, int height, AlphaBounds& outBounds)
+{
+    int minX = width, minY = height, maxX = -1, maxY = -1;
+
+    for (int y = 0; y < height; ++y)
+    {
+        const uint8_t* row = rgba + (size_t)y * width * 4;
+
+        int first = 0;
+        while (first < width && row[first * 4 + 3] == 0)
+            ++first;
+        if (first == width)
+            continue;
+
+        int last = width - 1;
+        while (row[last * 4 + 3] == 0)
+            --last;
+
+        minX = std::min(minX, first);
+        maxX = std::max(maxX, last);
+        minY = std::min(minY, y);
+        maxY = y;
+    }
+
+    if (maxX < 0)
+        return false;
+
+    outBounds = AlphaBounds{ minX, minY, maxX - minX + 1, maxY - minY + 1 };
+    return true;
+}
+
+bool SetTileTrim(TileImageDef& tile, const AlphaBounds& bounds, int imageWidth, int imageHeight)
+{
+    if (tile.w <= 0 || tile.h <= 0 || imageWidth <= 0 || imageHeight <= 0 || bounds.width <= 0 || bounds.height <= 0)
+        return false;
+
+    const double scaleX = (double)tile.w / imageWidth;
+    const double scaleY = (double)tile.h / imageHeight;
+
+    const int x0 = std::max(0, (int)std::floor(bounds.x * scaleX));
+    const int y0 = std::max(0, (int)std::floor(bounds.y * scaleY));
+    const int x1 = std::min(tile.w, (int)std::ceil((bounds.x + bounds.width) * scaleX));
+    const int y1 = std::min(tile.h, (int)std::ceil((bounds.y + bounds.height) * scaleY));
+
+    if (x0 == 0 && y0 == 0 && x1 == tile.w && y1 == tile.h)
+        return false;
+
+    tile.trimX = x0;
+    tile.trimY = y0;
+    tile.trimW = x1 - x0;
+    tile.trimH = y1 - y0;
+    return true;
+}
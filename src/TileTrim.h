@@ -0,0 +1,35 @@
+#pragma once
+
+#include <cstdint>
+
+#include "TmxLoader.h"
+
+// Texel rect inside an image.
+struct AlphaBounds
+{
+    int x = 0;
+    int y = 0;
+    int width = 0;
+    int height = 0;
+};
+
+/*
+    Tile trimming
+    -------------
+    Tree and object frames are mostly transparent padding, and a quad
+    costs fill rate and blending over its whole area whether or not a
+    texel is visible. mon_cook stores each image-collection tile's opaque
+    rect on its TileImageDef; TileResolver narrows the UVs to it and
+    ApplyTileTrim() narrows the quad, so the untrimmed rect still decides
+    the placement (bottom-centre pivot) and the depth.
+*/
+
+// Tight bounds of the texels with non-zero alpha. False when the image
+// is fully transparent.
+bool ComputeAlphaBounds(const uint8_t* rgba, int width, int height, AlphaBounds& outBounds);
+
+// Store bounds measured on an imageWidth x imageHeight image (which may
+// be another resolution variant than the TSX names) on the tile, in TSX
+// pixels rounded outwards. Leaves the tile untouched and returns false
+// when there's nothing to trim.
+bool SetTileTrim(TileImageDef& tile, const AlphaBounds& bounds, int imageWidth, int imageHeight);
@@ -0,0 +1,330 @@
+#include "TilesetRegistry.h"
+
+#include "TextureVariants.h"
+#include "TileReferences.h"
+
+#include <algorithm>
+#include <iostream>
+
+TilesetRegistry::TilesetRegistry(TextureRegistry& textures, bool useTextureAtlas, float textureScale)
+    : mTextures(textures)
+    , mUseTextureAtlas(useTextureAtlas)
+    , mTextureScale(textureScale)
+{
+}
+
+TilesetRegistry::~TilesetRegistry()
+{
+    for (const auto& [key, entry] : mEntries)
+        ReleaseTextures(entry);
+}
+
+std::string TilesetRegistry::SelectImage(const TileImageDef& image, const ImageSource* images,
+    int& outWidth, int& outHeight) const
+{
+    return SelectTextureVariant(image.path, image.w, image.h, mTextureScale, images, outWidth, outHeight);
+}
+
+std::string TilesetRegistry::MakeKey(const TilesetDef& def, const ImageSource* images) const
+{
+    std::string key = std::to_string(def.tileW) + "x" + std::to_string(def.tileH);
+
+    if (!def.isImageCollection)
+        return key + "|sheet|" + TextureRegistry::CanonicalPath(def.imagePath);
+
+    std::vector<std::pair<int, const TileImageDef*>> tiles;
+    tiles.reserve(def.tileImages.size());
+    for (const auto& entry : def.tileImages)
+        tiles.emplace_back(entry.first, &entry.second);
+    std::sort(tiles.begin(), tiles.end(), [](const auto& a, const auto& b) { return a.first < b.first; });
+
+    key += "|collection";
+    for (const auto& [tileId, image] : tiles)
+    {
+        int width = 0, height = 0;
+        key += "|" + std::to_string(tileId) + "=" + TextureRegistry::CanonicalPath(SelectImage(*image, images, width, height));
+    }
+    return key;
+}
+
+void TilesetRegistry::ReleaseTextures(const Entry& entry)
+{
+    for (GLuint texture : entry.textures)
+        mTextures.Release(texture);
+    for (const AtlasRegion& region : entry.atlasRegions)
+        mTextures.ReleaseAtlasRegion(region);
+}
+
+bool TilesetRegistry::BuildSheet(const TilesetDef& def, const ImageSource* images, Entry& outEntry)
+{
+    // Important: your renderer/shader UVs expect "normal" orientation.
+    const bool tilesetFlipY = false;
+
+    // Sheet-based tileset: one atlas texture.
+    outEntry.sheet = mTextures.Acquire(def.imagePath, tilesetFlipY, images, def.imageW, def.imageH);
+    if (!outEntry.sheet.id)
+    {
+        std::cerr << "Failed to load tileset image: " << def.imagePath << "\n";
+        return false;
+    }
+
+    outEntry.textures.push_back(outEntry.sheet.id);
+    outEntry.imagePaths.push_back(TextureRegistry::CanonicalPath(def.imagePath));
+    return true;
+}
+
+bool TilesetRegistry::LoadTiles(const TilesetDef& def, const ImageSource* images, const std::vector<int>& tileIds,
+    bool strict, Entry& entry)
+{
+    const bool tilesetFlipY = false;
+
+    // Image collection: each tileId is its own texture or atlas region,
+    // at the variant that covers its drawn size (the quad keeps the TSX size).
+    struct Tile
+    {
+        int tileId;
+        std::string path;
+        int width;
+        int height;
+    };
+
+    std::vector<Tile> tiles;
+    tiles.reserve(tileIds.size());
+    for (int tileId : tileIds)
+    {
+        const auto imageIt = def.tileImages.find(tileId);
+        if (imageIt == def.tileImages.end() || entry.tileTextures.count(tileId))
+            continue;
+
+        Tile tile{ tileId, std::string(), 0, 0 };
+        tile.path = SelectImage(imageIt->second, images, tile.width, tile.height);
+        tiles.push_back(std::move(tile));
+    }
+
+    // Pack tallest first so shelves stay tight.
+    std::sort(tiles.begin(), tiles.end(),
+        [](const Tile& a, const Tile& b)
+        {
+            if (a.height != b.height)
+                return a.height > b.height;
+            return a.tileId < b.tileId;
+        });
+
+    for (const Tile& tile : tiles)
+    {
+        AtlasRegion region{};
+        if (mUseTextureAtlas && mTextures.AcquireAtlasRegion(tile.path, images, tile.width, tile.height, region))
+        {
+            entry.atlasRegions.push_back(region);
+            entry.imagePaths.push_back(TextureRegistry::CanonicalPath(tile.path));
+            entry.tileTextures.emplace(tile.tileId, TileImageRegion{ region.texture, region.uvMin, region.uvMax });
+            continue;
+        }
+
+        // Too big for a page (or unreadable): its own texture.
+        const Texture2D texture = mTextures.Acquire(tile.path, tilesetFlipY, images, tile.width, tile.height);
+        if (!texture.id)
+        {
+            std::cerr << "Failed to load tileset tile image: " << tile.path << "\n";
+            if (strict)
+                return false;
+
+            entry.tileTextures.emplace(tile.tileId, TileImageRegion{});
+            continue;
+        }
+
+        entry.textures.push_back(texture.id);
+        entry.imagePaths.push_back(TextureRegistry::CanonicalPath(tile.path));
+        entry.tileTextures.emplace(tile.tileId, TileImageRegion{ texture.id });
+    }
+
+    return true;
+}
+
+bool TilesetRegistry::Acquire(const std::vector<TilesetDef>& defs, const ImageSource* images,
+    const std::vector<uint8_t>* referencedGids, std::vector<TilesetRuntime>& outRuntimes)
+{
+    std::vector<TilesetRuntime> runtimes;
+    runtimes.reserve(defs.size());
+
+    size_t deferredTiles = 0;
+    size_t deferredBytes = 0;
+
+    for (const TilesetDef& def : defs)
+    {
+        const std::string key = MakeKey(def, images);
+
+        auto it = mEntries.find(key);
+        if (it != mEntries.end())
+        {
+            ++mHits;
+        }
+        else
+        {
+            Entry entry;
+            if (!def.isImageCollection && !BuildSheet(def, images, entry))
+            {
+                Release(runtimes);
+                return false;
+            }
+
+            ++mMisses;
+            it = mEntries.emplace(key, std::move(entry)).first;
+        }
+
+        Entry& entry = it->second;
+
+        if (def.isImageCollection)
+        {
+            // The tiles the map references (and the entry doesn't hold yet).
+            std::vector<int> tileIds;
+            for (const auto& [tileId, image] : def.tileImages)
+            {
+                if (entry.tileTextures.count(tileId))
+                    continue;
+
+                if (referencedGids && !IsGidReferenced(*referencedGids, static_cast<uint32_t>(def.firstGid + tileId)))
+                {
+                    int width = 0, height = 0;
+                    SelectImage(image, images, width, height);
+                    ++deferredTiles;
+                    deferredBytes += (size_t)std::max(0, width) * (size_t)std::max(0, height) * 4;
+                    continue;
+                }
+
+                tileIds.push_back(tileId);
+            }
+
+            if (!LoadTiles(def, images, tileIds, true, entry))
+            {
+                // A fresh entry goes away again; a shared one keeps what it loaded.
+                if (entry.refs == 0)
+                {
+                    ReleaseTextures(entry);
+                    mEntries.erase(it);
+                }
+                Release(runtimes);
+                return false;
+            }
+        }
+
+        ++entry.refs;
+
+        // The def (firstGid, animations, flags) always comes from the new map.
+        TileSet tileset(entry.sheet.width, entry.sheet.height, def.tileW, def.tileH);
+        tileset.SetAnimations(def.animations);
+
+        runtimes.push_back(TilesetRuntime{ def, tileset, entry.sheet.id, entry.tileTextures, key });
+    }
+
+    mDeferredTiles = deferredTiles;
+    mDeferredBytes = deferredBytes;
+    outRuntimes = std::move(runtimes);
+    return true;
+}
+
+size_t TilesetRegistry::LoadDeferred(std::vector<TilesetRuntime>& runtimes, const std::vector<uint32_t>& gids,
+    const ImageSource* images)
+{
+    // gid -> the runtime whose range holds it (highest firstGid wins, as in the resolver).
+    std::vector<std::vector<int>> tileIds(runtimes.size());
+    for (uint32_t gid : gids)
+    {
+        int best = -1;
+        for (size_t i = 0; i < runtimes.size(); ++i)
+        {
+            const int firstGid = runtimes[i].def.firstGid;
+            if (firstGid <= static_cast<int>(gid) && (best < 0 || firstGid > runtimes[best].def.firstGid))
+                best = static_cast<int>(i);
+        }
+
+        if (best >= 0 && runtimes[best].def.isImageCollection)
+            tileIds[best].push_back(static_cast<int>(gid) - runtimes[best].def.firstGid);
+    }
+
+    size_t loaded = 0;
+    for (size_t i = 0; i < runtimes.size(); ++i)
+    {
+        if (tileIds[i].empty())
+            continue;
+
+        TilesetRuntime& runtime = runtimes[i];
+        auto it = mEntries.find(runtime.registryKey);
+        if (it == mEntries.end())
+            continue;
+
+        Entry& entry = it->second;
+        LoadTiles(runtime.def, images, tileIds[i], false, entry);
+
+        for (int tileId : tileIds[i])
+        {
+            const auto regionIt = entry.tileTextures.find(tileId);
+            if (regionIt == entry.tileTextures.end() || runtime.tileTextures.count(tileId))
+                continue;
+
+            runtime.tileTextures.emplace(tileId, regionIt->second);
+            if (regionIt->second.textureId != 0)
+                ++loaded;
+        }
+    }
+
+    mLateLoads += loaded;
+    return loaded;
+}
+
+size_t TilesetRegistry::Retire(const std::string& imagePath, std::vector<TilesetRuntime>& runtimes)
+{
+    const std::string canonical = TextureRegistry::CanonicalPath(imagePath);
+
+    std::vector<std::string> keys;
+    for (const auto& [key, entry] : mEntries)
+    {
+        if (std::find(entry.imagePaths.begin(), entry.imagePaths.end(), canonical) != entry.imagePaths.end())
+            keys.push_back(key);
+    }
+
+    for (const std::string& key : keys)
+    {
+        const std::string retiredKey = key + "|retired" + std::to_string(++mRetired);
+
+        auto node = mEntries.extract(key);
+        node.key() = retiredKey;
+        mEntries.insert(std::move(node));
+
+        for (TilesetRuntime& runtime : runtimes)
+        {
+            if (runtime.registryKey == key)
+                runtime.registryKey = retiredKey;
+        }
+    }
+
+    return keys.size();
+}
+
+void TilesetRegistry::Release(const std::vector<TilesetRuntime>& runtimes)
+{
+    for (const TilesetRuntime& runtime : runtimes)
+    {
+        auto it = mEntries.find(runtime.registryKey);
+        if (it == mEntries.end())
+            continue;
+
+        if (--it->second.refs > 0)
+            continue;
+
+        ReleaseTextures(it->second);
+        mEntries.erase(it);
+    }
+}
+
+TilesetRegistryStats TilesetRegistry::GetStats() const
+{
+    TilesetRegistryStats stats{};
+    stats.hits = mHits;
+    stats.misses = mMisses;
+    stats.live = mEntries.size();
+    stats.deferredTiles = mDeferredTiles;
+    stats.deferredBytes = mDeferredBytes;
+    stats.lateLoads = mLateLoads;
+    return stats;
+}
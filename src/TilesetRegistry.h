@@ -0,0 +1,114 @@
+#pragma once
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "TextureRegistry.h"
+#include "TileResolver.h"
+
+struct TilesetRegistryStats
+{
+    size_t hits = 0;    // tileset already live when a map asked for it
+    size_t misses = 0;  // built (textures may still come from the texture registry)
+    size_t live = 0;
+
+    // Image-collection tiles the current map doesn't reference, left unloaded
+    // at its Acquire(), and the bytes their selected variants would take.
+    size_t deferredTiles = 0;
+    size_t deferredBytes = 0;
+    size_t lateLoads = 0; // deferred tiles loaded since by LoadDeferred()
+};
+
+/*
+    TilesetRegistry
+    ---------------
+    Tileset textures shared across maps. A tileset is keyed by what its
+    textures depend on: the canonical image path(s) and the tile size, so
+    the same .tsx used by two maps (at different firstGids) is one entry.
+
+    Acquire() builds one TilesetRuntime per def of the new map, taking a
+    reference on each entry; entries still referenced by the current map
+    are reused as they are. Release() drops the references of a previous
+    map's runtimes. Acquire the new map before releasing the old one, so
+    shared tilesets never go unreferenced in between.
+
+    An entry dies with its last reference and hands its textures back to
+    the TextureRegistry, which keeps them for its grace period.
+
+    Image-collection tiles load the resolution variant that covers their
+    drawn size (SelectTextureVariant, TSX size * textureScale); the key
+    holds the selected paths, so a different scale is a different entry.
+
+    Given the map's referenced gids (CollectReferencedGids), Acquire()
+    loads only those tiles of a collection. The key still covers the whole
+    collection, so an entry shared by two maps gains the tiles the second
+    one needs. Anything else is loaded by LoadDeferred() once the resolver
+    asks for it; a tile that fails there is stored with texture 0 and
+    never retried.
+*/
+class TilesetRegistry
+{
+public:
+    // textureScale: screen pixels per world pixel the tiles are drawn at.
+    TilesetRegistry(TextureRegistry& textures, bool useTextureAtlas, float textureScale = 1.0f);
+    ~TilesetRegistry();
+
+    TilesetRegistry(const TilesetRegistry&) = delete;
+    TilesetRegistry& operator=(const TilesetRegistry&) = delete;
+
+    // False (nothing acquired) when an image can't be loaded.
+    // referencedGids: nullptr = load every collection tile.
+    bool Acquire(const std::vector<TilesetDef>& defs, const ImageSource* images,
+        const std::vector<uint8_t>* referencedGids, std::vector<TilesetRuntime>& outRuntimes);
+    void Release(const std::vector<TilesetRuntime>& runtimes);
+
+    // Loads the collection tiles behind gids (TileResolver::TakeDeferredGids)
+    // into runtimes; Rebuild() the resolver afterwards. Returns the number loaded.
+    size_t LoadDeferred(std::vector<TilesetRuntime>& runtimes, const std::vector<uint32_t>& gids, const ImageSource* images);
+
+    // Hot reload, after TextureRegistry::ReloadImage split imagePath off a
+    // shared image: the entries using it are renamed (and runtimes pointed
+    // at the new names), so the next Acquire() builds them again from the
+    // file while Release(runtimes) still finds the old ones. Returns the
+    // number of entries retired.
+    size_t Retire(const std::string& imagePath, std::vector<TilesetRuntime>& runtimes);
+
+    TilesetRegistryStats GetStats() const;
+
+private:
+    struct Entry
+    {
+        Texture2D sheet;                                        // sheet-based tilesets
+        std::unordered_map<int, TileImageRegion> tileTextures;  // image collections
+        std::vector<GLuint> textures;                           // references held on mTextures
+        std::vector<AtlasRegion> atlasRegions;
+        std::vector<std::string> imagePaths;                    // canonical, for Retire()
+        int refs = 0;
+    };
+
+    std::string MakeKey(const TilesetDef& def, const ImageSource* images) const;
+
+    // The resolution variant to load for a collection tile, and its size.
+    std::string SelectImage(const TileImageDef& image, const ImageSource* images, int& outWidth, int& outHeight) const;
+
+    bool BuildSheet(const TilesetDef& def, const ImageSource* images, Entry& outEntry);
+
+    // Collection tiles into entry. strict: the first failure fails the call;
+    // otherwise the tile is stored with texture 0.
+    bool LoadTiles(const TilesetDef& def, const ImageSource* images, const std::vector<int>& tileIds,
+        bool strict, Entry& entry);
+    void ReleaseTextures(const Entry& entry);
+
+    TextureRegistry& mTextures;
+    bool mUseTextureAtlas = true;
+    float mTextureScale = 1.0f;
+
+    std::unordered_map<std::string, Entry> mEntries;
+    size_t mHits = 0;
+    size_t mMisses = 0;
+    size_t mDeferredTiles = 0;
+    size_t mDeferredBytes = 0;
+    size_t mLateLoads = 0;
+    size_t mRetired = 0;
+};
@@ -8,28 +8,35 @@
 //  - No stray references (door/spawn/mapObject) inside ParseNode
 
 #include "TmxLoader.h"
+#include "AssetFiles.h"
+#include "TileLayerData.h"
 
 #include "tinyxml2.h"
 
 #include <algorithm>
+#include <atomic>
 #include <cctype>
 #include <cstdint>
 #include <cstdlib>
+#include <cstring>
 #include <filesystem>
 #include <functional>
+#include <future>
 #include <iostream>
-#include <sstream>
+#include <thread>
 #include <unordered_map>
 #include <vector>
 
 namespace
 {
-    constexpr uint32_t TMX_FLIPPED_HORIZONTALLY_FLAG = 0x80000000u;
-    constexpr uint32_t TMX_FLIPPED_VERTICALLY_FLAG = 0x40000000u;
-    constexpr uint32_t TMX_FLIPPED_DIAGONALLY_FLAG = 0x20000000u;
-
-    constexpr uint32_t TMX_GID_MASK =
-        ~(TMX_FLIPPED_HORIZONTALLY_FLAG | TMX_FLIPPED_VERTICALLY_FLAG | TMX_FLIPPED_DIAGONALLY_FLAG);
+    // TMX / TSX through the asset archive when one is mounted.
+    tinyxml2::XMLError LoadXmlAsset(tinyxml2::XMLDocument& doc, const std::string& path)
+    {
+        AssetFile file;
+        if (!file.Load(path))
+            return doc.LoadFile(path.c_str()); // sets the error text
+        return doc.Parse(reinterpret_cast<const char*>(file.Data()), file.Size());
+    }
 
     std::string ToLower(std::string value)
     {
@@ -39,32 +46,6 @@ namespace
         return value;
     }
 
-    std::vector<int> ParseCsvTiles(const char* csvText, int expectedCount)
-    {
-        std::vector<int> tiles;
-        tiles.reserve(expectedCount);
-
-        if (!csvText)
-            return tiles;
-
-        std::stringstream ss(csvText);
-        std::string cell;
-
-        while (std::getline(ss, cell, ','))
-        {
-            const auto begin = cell.find_first_not_of(" \t\r\n");
-            if (begin == std::string::npos)
-                continue;
-
-            const auto end = cell.find_last_not_of(" \t\r\n");
-            const std::string trimmed = cell.substr(begin, end - begin + 1);
-
-            tiles.push_back(std::stoi(trimmed));
-        }
-
-        return tiles;
-    }
-
     std::unordered_map<std::string, std::string> ParseProperties(tinyxml2::XMLElement* propertiesElement)
     {
         std::unordered_map<std::string, std::string> props;
@@ -125,6 +106,28 @@ namespace
         return value == "true" || value == "1" || value == "yes";
     }
 
+    // "pass" layer property, else the name convention of the original three layers.
+    LayerPass GetLayerPass(tinyxml2::XMLElement* layer, const std::string& layerName)
+    {
+        const std::string value = ToLower(GetStringProp(layer->FirstChildElement("properties"), "pass"));
+        if (value == "ground")
+            return LayerPass::Ground;
+        if (value == "occluder" || value == "walls")
+            return LayerPass::Occluder;
+        if (value == "overhead")
+            return LayerPass::Overhead;
+
+        if (!value.empty())
+            std::cerr << "Layer '" << layerName << "' has unknown pass '" << value << "', using the default\n";
+
+        const std::string lowerName = ToLower(layerName);
+        if (lowerName == "walls")
+            return LayerPass::Occluder;
+        if (lowerName == "overhead")
+            return LayerPass::Overhead;
+        return LayerPass::Ground;
+    }
+
     bool GetBoolAttribute(tinyxml2::XMLElement* element, const char* name, bool defaultValue)
     {
         const char* attr = element->Attribute(name);
@@ -310,7 +313,7 @@ namespace
         using namespace tinyxml2;
 
         XMLDocument tsxDoc;
-        const XMLError tsxErr = tsxDoc.LoadFile(tsxPath.string().c_str());
+        const XMLError tsxErr = LoadXmlAsset(tsxDoc, tsxPath.string());
         if (tsxErr != XML_SUCCESS)
         {
             std::cerr << "Failed to load TSX: " << tsxPath << " error=" << tsxDoc.ErrorStr() << "\n";
@@ -329,6 +332,17 @@ namespace
     }
 } // namespace
 
+const char* GetLayerPassName(LayerPass pass)
+{
+    switch (pass)
+    {
+    case LayerPass::Ground: return "ground";
+    case LayerPass::Occluder: return "occluder";
+    case LayerPass::Overhead: return "overhead";
+    default: return "?";
+    }
+}
+
 glm::vec2 ObjectPixelsToGrid(const glm::vec2& objectPosPx, int tileWidth, int tileHeight)
 {
     const float halfW = tileWidth * 0.5f;
@@ -353,7 +367,7 @@ bool LoadTmxMap(const std::string& tmxPath, LoadedMap& outMap)
     outMap = LoadedMap{};
 
     XMLDocument doc;
-    const XMLError err = doc.LoadFile(tmxPath.c_str());
+    const XMLError err = LoadXmlAsset(doc, tmxPath);
     if (err != XML_SUCCESS)
     {
         std::cerr << "Failed to load TMX: " << tmxPath << " error=" << doc.ErrorStr() << "\n";
@@ -372,6 +386,14 @@ bool LoadTmxMap(const std::string& tmxPath, LoadedMap& outMap)
     mapData.height = map->IntAttribute("height");
     mapData.tileW = map->IntAttribute("tilewidth");
     mapData.tileH = map->IntAttribute("tileheight");
+    mapData.infinite = map->IntAttribute("infinite", 0) != 0;
+
+    // Infinite maps have no dense extent; their layers live in mapData.chunks.
+    if (mapData.infinite)
+    {
+        mapData.width = 0;
+        mapData.height = 0;
+    }
 
     const int expectedCount = mapData.width * mapData.height;
 
@@ -392,6 +414,7 @@ bool LoadTmxMap(const std::string& tmxPath, LoadedMap& outMap)
             const std::filesystem::path tsxPath = (tmxDir / tsxSource).lexically_normal();
             if (!LoadTilesetFromTsx(tsxPath, firstGid, mapData.tileW, mapData.tileH, tilesetDef))
                 return false;
+            tilesetDef.sourcePath = tsxPath.generic_string();
         }
         else
         {
@@ -412,17 +435,70 @@ bool LoadTmxMap(const std::string& tmxPath, LoadedMap& outMap)
         [](const TilesetDef& a, const TilesetDef& b) { return a.firstGid < b.firstGid; });
 
     // --- Tile layers
+    // Collected in document order while walking the tree, decoded afterwards
+    // (in parallel on large maps) straight into mapData.layerGids.
+    struct PendingLayer
+    {
+        std::string name;
+        int layerIndex = -1; // into mapData.layers; -1 = the collision layer
+        TileLayerFormat format;
+        const char* text = nullptr;
+        size_t length = 0;
+
+        uint32_t* tiles = nullptr;
+        size_t decodedCount = 0;
+        bool decoded = false;
+    };
+
+    std::vector<PendingLayer> pendingLayers;
+    std::vector<uint32_t> collisionGids;
     std::vector<uint8_t> collisionTiles(expectedCount, 0);
     bool hasCollisionLayer = false;
 
+    // Infinite maps: keep each <chunk>'s encoded text, decoded later by ChunkStreamer.
+    auto ParseChunks = [&](XMLElement* data, const std::string& layerName, int layerIndex, const TileLayerFormat& format)
+        {
+            for (XMLElement* chunk = data->FirstChildElement("chunk"); chunk; chunk = chunk->NextSiblingElement("chunk"))
+            {
+                const int x = chunk->IntAttribute("x");
+                const int y = chunk->IntAttribute("y");
+                const int w = chunk->IntAttribute("width");
+                const int h = chunk->IntAttribute("height");
+
+                if (mapData.chunkW == 0 && w > 0 && h > 0)
+                {
+                    mapData.chunkW = w;
+                    mapData.chunkH = h;
+                }
+
+                if (w <= 0 || h <= 0 || w != mapData.chunkW || h != mapData.chunkH || x % w != 0 || y % h != 0)
+                {
+                    std::cerr << "Layer '" << layerName << "' chunk at (" << x << "," << y << ") size "
+                        << w << "x" << h << " is not on the " << mapData.chunkW << "x" << mapData.chunkH
+                        << " chunk grid, skipped\n";
+                    continue;
+                }
+
+                MapChunkDef& def = mapData.chunks[MakeChunkKey(FloorDiv(x, w), FloorDiv(y, h))];
+                def.x = x;
+                def.y = y;
+                def.width = w;
+                def.height = h;
+
+                if (layerIndex >= 0 && (int)def.layers.size() <= layerIndex)
+                    def.layers.resize((size_t)layerIndex + 1);
+
+                MapChunkLayer& chunkLayer = layerIndex >= 0 ? def.layers[(size_t)layerIndex] : def.collision;
+                chunkLayer.format = format;
+                const char* text = chunk->GetText();
+                chunkLayer.data.assign(text ? text : "");
+            }
+        };
+
     auto ParseLayer = [&](XMLElement* layer)
         {
             const char* name = layer->Attribute("name");
             const std::string layerName = name ? name : "";
-            const bool visible = GetBoolAttribute(layer, "visible", true);
-
-            const std::string lowerName = ToLower(layerName);
-            const bool isCollision = (lowerName == "collision");
 
             XMLElement* data = layer->FirstChildElement("data");
             if (!data)
@@ -432,46 +508,132 @@ bool LoadTmxMap(const std::string& tmxPath, LoadedMap& outMap)
             }
 
             const char* encoding = data->Attribute("encoding");
-            if (!encoding || std::string(encoding) != "csv")
+            const char* compression = data->Attribute("compression");
+
+            PendingLayer pending;
+            if (!ParseTileLayerFormat(encoding, compression, pending.format))
             {
-                std::cerr << "Layer '" << layerName << "' is not CSV encoded\n";
+                std::cerr << "Layer '" << layerName << "' has unsupported encoding '"
+                    << (encoding ? encoding : "xml") << "'"
+                    << (compression ? std::string(" / compression '") + compression + "'" : std::string())
+                    << " (expected csv or base64 with zlib, gzip or zstd)\n";
                 return;
             }
 
-            std::vector<int> rawGids = ParseCsvTiles(data->GetText(), expectedCount);
-            if ((int)rawGids.size() != expectedCount)
+            if (ToLower(layerName) == "collision")
+            {
+                if (hasCollisionLayer)
+                {
+                    std::cerr << "Layer '" << layerName << "': only the first collision layer is used, skipped\n";
+                    return;
+                }
+                hasCollisionLayer = true;
+            }
+            else
             {
-                std::cerr << "Layer '" << layerName << "' size mismatch. Expected "
-                    << expectedCount << " entries but got " << rawGids.size() << "\n";
+                MapLayerDef def;
+                def.name = layerName;
+                def.pass = GetLayerPass(layer, layerName);
+                def.visible = GetBoolAttribute(layer, "visible", true);
+                pending.layerIndex = (int)mapData.layers.size();
+                mapData.layers.push_back(std::move(def));
+            }
+
+            if (mapData.infinite)
+            {
+                ParseChunks(data, layerName, pending.layerIndex, pending.format);
                 return;
             }
 
-            if (isCollision)
+            // GetText() normalizes the node lazily, so it must run here, not on the decode threads.
+            pending.name = layerName;
+            pending.text = data->GetText();
+            pending.length = pending.text ? std::strlen(pending.text) : 0;
+            pendingLayers.push_back(std::move(pending));
+        };
+
+    auto DecodePendingLayers = [&]()
+        {
+            constexpr size_t kParallelDecodeMinBytes = 64 * 1024;
+
+            // Every layer gets its slice up front, so the decode threads never reallocate.
+            mapData.layerGids.assign(mapData.layers.size() * (size_t)expectedCount, 0);
+            if (hasCollisionLayer)
+                collisionGids.assign(expectedCount, 0);
+
+            for (PendingLayer& layer : pendingLayers)
             {
-                hasCollisionLayer = true;
-                for (int i = 0; i < expectedCount; ++i)
+                layer.tiles = layer.layerIndex >= 0
+                    ? mapData.layerGids.data() + (size_t)layer.layerIndex * expectedCount
+                    : collisionGids.data();
+            }
+
+            auto DecodeLayer = [expectedCount](PendingLayer& layer)
                 {
-                    const uint32_t gid = static_cast<uint32_t>(rawGids[i]) & TMX_GID_MASK;
-                    collisionTiles[i] = gid == 0 ? 0 : 1;
-                }
+                    // Decoded straight into the layer storage, flip flags already masked.
+                    layer.decoded = DecodeTileLayerGids(layer.format, layer.text, layer.length,
+                        layer.tiles, (size_t)expectedCount, layer.decodedCount);
+                };
+
+            size_t totalBytes = 0;
+            for (const PendingLayer& layer : pendingLayers)
+                totalBytes += layer.length;
+
+            if (pendingLayers.size() < 2 || totalBytes < kParallelDecodeMinBytes)
+            {
+                for (PendingLayer& layer : pendingLayers)
+                    DecodeLayer(layer);
                 return;
             }
 
-            std::vector<uint32_t> tiles(expectedCount, 0);
-            for (int i = 0; i < expectedCount; ++i)
+            // One worker per core at most (this thread included), each
+            // taking the next undecoded layer until none are left.
+            std::atomic<size_t> nextLayer{ 0 };
+            auto DecodeLayers = [&]()
+                {
+                    for (size_t i = nextLayer++; i < pendingLayers.size(); i = nextLayer++)
+                        DecodeLayer(pendingLayers[i]);
+                };
+
+            const size_t workerCount = std::min<size_t>(pendingLayers.size(),
+                std::max(1u, std::thread::hardware_concurrency()));
+
+            std::vector<std::future<void>> tasks;
+            tasks.reserve(workerCount - 1);
+            for (size_t i = 1; i < workerCount; ++i)
+                tasks.push_back(std::async(std::launch::async, DecodeLayers));
+
+            DecodeLayers();
+            for (std::future<void>& task : tasks)
+                task.get();
+        };
+
+    // A layer that fails to decode stays in place, empty, so layer indices hold.
+    auto ApplyLayer = [&](PendingLayer& layer)
+        {
+            bool valid = layer.decoded && (int)layer.decodedCount == expectedCount;
+            if (!layer.decoded)
+            {
+                std::cerr << "Layer '" << layer.name << "' has malformed data (or more than "
+                    << expectedCount << " entries)\n";
+            }
+            else if (!valid)
             {
-                const uint32_t gid = static_cast<uint32_t>(rawGids[i]) & TMX_GID_MASK;
-                tiles[i] = gid;
+                std::cerr << "Layer '" << layer.name << "' size mismatch. Expected "
+                    << expectedCount << " entries but got " << layer.decodedCount << "\n";
             }
 
-            if (lowerName == "ground")
-                mapData.groundGids = std::move(tiles);
-            else if (lowerName == "walls")
-                mapData.wallsGids = std::move(tiles);
-            else if (lowerName == "overhead")
-                mapData.overheadGids = std::move(tiles);
+            if (!valid)
+            {
+                std::fill(layer.tiles, layer.tiles + expectedCount, 0u);
+                return;
+            }
 
-            (void)visible;
+            if (layer.layerIndex < 0)
+            {
+                for (int i = 0; i < expectedCount; ++i)
+                    collisionTiles[i] = layer.tiles[i] == 0 ? 0 : 1;
+            }
         };
 
     // --- Object groups (with group offsets)
@@ -492,7 +654,7 @@ bool LoadTmxMap(const std::string& tmxPath, LoadedMap& outMap)
                 if (const char* gidStr = object->Attribute("gid"))
                     rawGid = static_cast<uint32_t>(std::strtoul(gidStr, nullptr, 10));
 
-                const uint32_t gid = rawGid & TMX_GID_MASK;
+                const uint32_t gid = rawGid & kTmxGidMask;
                 if (gid != 0)
                 {
                     MapObjectInstance inst{};
@@ -583,6 +745,10 @@ bool LoadTmxMap(const std::string& tmxPath, LoadedMap& outMap)
     for (XMLElement* node = map->FirstChildElement(); node; node = node->NextSiblingElement())
         ParseNode(node, glm::vec2(0.0f));
 
+    DecodePendingLayers();
+    for (PendingLayer& layer : pendingLayers)
+        ApplyLayer(layer);
+
     if (hasCollisionLayer)
         mapData.collision = std::move(collisionTiles);
     else
@@ -610,27 +776,31 @@ bool LoadTmxMap(const std::string& tmxPath, LoadedMap& outMap)
             flags.slow = flags.slow || flagIt->second.slow;
         };
 
-    for (int i = 0; i < expectedCount; ++i)
+    for (size_t layer = 0; layer < mapData.layers.size(); ++layer)
     {
-        if ((int)mapData.groundGids.size() == expectedCount)
-            AccumulateTileFlags(i, mapData.groundGids[i]);
-        if ((int)mapData.wallsGids.size() == expectedCount)
-            AccumulateTileFlags(i, mapData.wallsGids[i]);
-        if ((int)mapData.overheadGids.size() == expectedCount)
-            AccumulateTileFlags(i, mapData.overheadGids[i]);
+        const uint32_t* gids = mapData.layerGids.data() + layer * (size_t)expectedCount;
+        for (int i = 0; i < expectedCount; ++i)
+            AccumulateTileFlags(i, gids[i]);
+    }
 
+    for (int i = 0; i < expectedCount; ++i)
+    {
         if (mapData.tileFlags[i].blocking)
             mapData.collision[i] = 1;
     }
 
     std::cout << "TMX loaded: " << tmxPath << "\n";
-    std::cout << "  map size: " << mapData.width << " x " << mapData.height << " tiles\n";
+    if (mapData.infinite)
+        std::cout << "  map size: infinite, " << mapData.chunks.size() << " chunks of "
+            << mapData.chunkW << " x " << mapData.chunkH << " tiles\n";
+    else
+        std::cout << "  map size: " << mapData.width << " x " << mapData.height << " tiles\n";
     std::cout << "  tile size: " << mapData.tileW << " x " << mapData.tileH << " px\n";
     std::cout << "  tilesets: " << mapData.tilesets.size() << "\n";
-    std::cout << "  layers: ground=" << (mapData.HasGround() ? "yes" : "no")
-        << " walls=" << (mapData.HasWalls() ? "yes" : "no")
-        << " overhead=" << (mapData.HasOverhead() ? "yes" : "no")
-        << " collision=" << (hasCollisionLayer ? "yes" : "no") << "\n";
+    std::cout << "  layers:";
+    for (const MapLayerDef& layer : mapData.layers)
+        std::cout << " " << layer.name << "(" << GetLayerPassName(layer.pass) << (layer.visible ? "" : ", hidden") << ")";
+    std::cout << " collision=" << (hasCollisionLayer ? "yes" : "no") << "\n";
     std::cout << "  objects: " << mapData.objects.size() << "\n";
     std::cout << "  tile objects: " << mapData.objectInstances.size() << "\n";
 
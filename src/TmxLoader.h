@@ -7,7 +7,9 @@
 #include <unordered_map>
 #include <vector>
 
+#include "ArrayView.h"
 #include "MapObjects.h"
+#include "TileLayerData.h"
 
 struct AnimationFrame
 {
@@ -52,6 +54,13 @@ struct TileImageDef
     std::string path;
     int w = 0;
     int h = 0;
+
+    // Opaque part of the image in TSX pixels, set by mon_cook (TileTrim.h);
+    // trimW == 0 = draw the whole image.
+    int trimX = 0;
+    int trimY = 0;
+    int trimW = 0;
+    int trimH = 0;
 };
 
 struct TilesetDef
@@ -68,8 +77,77 @@ struct TilesetDef
     std::unordered_map<int, TileImageDef> tileImages;
     std::unordered_map<int, TileAnimation> animations;
     std::unordered_map<int, TilePropertyFlags> tileFlags;
+    std::string sourcePath; // external .tsx it came from; "" when embedded (or cooked)
+};
+
+/*
+    Tile layers
+    -----------
+    Every TMX tile layer except "collision" is kept, in document order.
+    Its pass says where its tiles are drawn:
+      - Ground:   baked into chunk meshes, drawn before the actors
+      - Occluder: depth sorted with the actors (RenderQueue static partition)
+      - Overhead: baked into chunk meshes, drawn after the actors
+    Set with a "pass" layer property (ground / occluder / overhead); without
+    one, a layer named "walls" is an occluder, "overhead" is overhead and
+    everything else is ground.
+*/
+enum class LayerPass : uint8_t
+{
+    Ground,
+    Occluder,
+    Overhead,
+
+    Count
+};
+
+struct MapLayerDef
+{
+    std::string name;
+    LayerPass pass = LayerPass::Ground;
+    bool visible = true;
+};
+
+/*
+    Infinite maps
+    -------------
+    Tiled writes infinite maps as <chunk x y width height> blocks instead of
+    one dense array per layer. The loader keeps every chunk in its encoded
+    form (a base64+zlib chunk is a few hundred bytes), in a sparse table
+    keyed by chunk coordinate; ChunkStreamer decodes the ones around the
+    player on demand. Empty data = layer absent in that chunk.
+
+    MapChunkDef::layers is parallel to MapData::layers (shorter when the
+    trailing layers have no data in that chunk).
+*/
+struct MapChunkLayer
+{
+    TileLayerFormat format;
+    std::string data;
+};
+
+struct MapChunkDef
+{
+    int x = 0;      // first cell, Tiled tile coordinates (may be negative)
+    int y = 0;
+    int width = 0;
+    int height = 0;
+
+    std::vector<MapChunkLayer> layers;
+    MapChunkLayer collision;
 };
 
+inline int FloorDiv(int value, int divisor)
+{
+    const int q = value / divisor;
+    return (value % divisor != 0 && ((value < 0) != (divisor < 0))) ? q - 1 : q;
+}
+
+inline uint64_t MakeChunkKey(int chunkX, int chunkY)
+{
+    return (static_cast<uint64_t>(static_cast<uint32_t>(chunkX)) << 32) | static_cast<uint32_t>(chunkY);
+}
+
 struct MapData
 {
     int width = 0;
@@ -79,9 +157,9 @@ struct MapData
 
     std::vector<TilesetDef> tilesets;
 
-    std::vector<uint32_t> groundGids;
-    std::vector<uint32_t> wallsGids;
-    std::vector<uint32_t> overheadGids;
+    // Layer-major: layers[i] owns layerGids[i * width * height, (i + 1) * width * height).
+    std::vector<MapLayerDef> layers;
+    std::vector<uint32_t> layerGids;
 
     std::vector<uint8_t> collision;
     std::vector<MapObject> objects;
@@ -90,12 +168,28 @@ struct MapData
     std::vector<DoorDef> doors;
     std::vector<SpawnDef> spawns;
 
-    bool HasGround() const { return (int)groundGids.size() == width * height; }
-    bool HasWalls() const { return (int)wallsGids.size() == width * height; }
-    bool HasOverhead() const { return (int)overheadGids.size() == width * height; }
-    bool HasCollision() const { return (int)collision.size() == width * height; }
+    // infinite="1": width / height are 0 and the dense layers stay empty.
+    bool infinite = false;
+    int chunkW = 0;
+    int chunkH = 0;
+    std::unordered_map<uint64_t, MapChunkDef> chunks; // MakeChunkKey(chunk x, chunk y)
+
+    size_t GetCellCount() const { return (size_t)width * (size_t)height; }
+
+    // Empty view for an infinite map (its gids live in chunks).
+    ArrayView<uint32_t> GetLayerGids(size_t layer) const
+    {
+        const size_t cells = GetCellCount();
+        if (cells == 0 || (layer + 1) * cells > layerGids.size())
+            return {};
+        return ArrayView<uint32_t>(layerGids.data() + layer * cells, cells);
+    }
+
+    bool HasCollision() const { return width * height > 0 && (int)collision.size() == width * height; }
 };
 
+const char* GetLayerPassName(LayerPass pass);
+
 struct LoadedMap
 {
     MapData mapData;
@@ -13,6 +13,7 @@
 #include <sstream>
 #include <string>
 #include <unordered_map>
+#include <unordered_set>
 #include <vector>
 
 #include "tinyxml2.h"
@@ -29,24 +30,17 @@
 #include "PlayerController.h"
 #include "SpriteSheet.h"
 #include "TmxLoader.h"
-
-// stb_image (ONLY define implementation in ONE .cpp file — main.cpp is a good choice)
-#define STB_IMAGE_IMPLEMENTATION
-#include "stb_image.h"
-
-/*
-    Texture2D
-    ---------
-    Small helper so we can keep:
-      - OpenGL texture ID
-      - the original image width/height (needed for atlas UV calculations)
-*/
-struct Texture2D
-{
-    GLuint id = 0;
-    int width = 0;
-    int height = 0;
-};
+#include "TextureRegistry.h"
+#include "TilesetRegistry.h"
+#include "TileReferences.h"
+#include "GameSystems.h"
+#include "MapBundle.h"
+#include "MapView.h"
+#include "ChunkStreamer.h"
+#include "MapPreloader.h"
+#include "AssetFiles.h"
+#include "FileWatcher.h"
+#include "MapDiff.h"
 
 /*
     ============================================
@@ -86,6 +80,60 @@ void main()
 }
 )";
 
+// Instanced sprite path (SpriteRenderMode::Instanced).
+// Per-instance: rect (pos, size) in screen pixels, UV rect and texture slot.
+static const char* instancedVertexShaderSrc = R"(
+#version 330 core
+
+layout (location = 0) in vec2 aPos;
+layout (location = 2) in vec4 aRect;
+layout (location = 3) in vec4 aUvRect;
+layout (location = 4) in float aSlot;
+
+out vec2 TexCoord;
+flat out int TexSlot;
+
+uniform mat4 uProjection;
+
+void main()
+{
+    vec2 screenPos = aRect.xy + aPos * aRect.zw;
+    gl_Position = uProjection * vec4(screenPos, 0.0, 1.0);
+    TexCoord = mix(aUvRect.xy, aUvRect.zw, aPos);
+    TexSlot = int(aSlot + 0.5);
+}
+)";
+
+// GLSL 3.30 only allows constant sampler array indices, hence the branch chain.
+static const char* instancedFragmentShaderSrc = R"(
+#version 330 core
+
+out vec4 FragColor;
+in vec2 TexCoord;
+flat in int TexSlot;
+
+uniform sampler2D uTextures[8];
+
+void main()
+{
+    if      (TexSlot == 0) FragColor = texture(uTextures[0], TexCoord);
+    else if (TexSlot == 1) FragColor = texture(uTextures[1], TexCoord);
+    else if (TexSlot == 2) FragColor = texture(uTextures[2], TexCoord);
+    else if (TexSlot == 3) FragColor = texture(uTextures[3], TexCoord);
+    else if (TexSlot == 4) FragColor = texture(uTextures[4], TexCoord);
+    else if (TexSlot == 5) FragColor = texture(uTextures[5], TexCoord);
+    else if (TexSlot == 6) FragColor = texture(uTextures[6], TexCoord);
+    else                   FragColor = texture(uTextures[7], TexCoord);
+}
+)";
+
+// Debug builds watch the current map's files and apply saved edits in place.
+#ifdef NDEBUG
+static constexpr bool kHotReload = false;
+#else
+static constexpr bool kHotReload = true;
+#endif
+
 /*
     ============================================
     GLFW callbacks
@@ -175,6 +223,17 @@ static glm::vec2 SpawnPixelToGrid_Ortho(const glm::vec2& posPx, int tileW, int t
     return glm::vec2(posPx.x / tileW, posPx.y / tileH);
 }
 
+static const char* RenderModeName(SpriteRenderMode mode)
+{
+    switch (mode)
+    {
+    case SpriteRenderMode::Immediate: return "immediate";
+    case SpriteRenderMode::Batched: return "batched";
+    case SpriteRenderMode::Instanced: return "instanced";
+    }
+    return "unknown";
+}
+
 static bool PointInRect(const glm::vec2& p, const glm::vec2& rPos, const glm::vec2& rSize)
 {
     return (p.x >= rPos.x && p.x <= rPos.x + rSize.x &&
@@ -227,41 +286,6 @@ static unsigned int CreateProgram(const char* vsSrc, const char* fsSrc)
     return program;
 }
 
-/*
-    ============================================
-    Texture loading
-    ============================================
-*/
-static Texture2D LoadTextureRGBA(const char* path, bool flipY)
-{
-    Texture2D tex{};
-
-    stbi_set_flip_vertically_on_load(flipY);
-
-    glGenTextures(1, &tex.id);
-    glBindTexture(GL_TEXTURE_2D, tex.id);
-
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
-
-    int channels = 0;
-    unsigned char* data = stbi_load(path, &tex.width, &tex.height, &channels, 4);
-    if (!data)
-    {
-        std::cerr << "Failed to load texture '" << path << "': " << stbi_failure_reason() << "\n";
-        tex.id = 0;
-        return tex;
-    }
-
-    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, tex.width, tex.height, 0, GL_RGBA, GL_UNSIGNED_BYTE, data);
-    glGenerateMipmap(GL_TEXTURE_2D);
-    stbi_image_free(data);
-
-    return tex;
-}
-
 int main()
 {
     /*
@@ -304,13 +328,52 @@ int main()
 
     std::cout << "Working directory: " << std::filesystem::current_path() << "\n";
 
+    // Packed assets (mon_pack) when present: TMX / TSX / PNG reads come out
+    // of one mapping instead of an open + read each; loose files otherwise.
+    // Hot reload watches and re-reads the loose files, so it leaves the
+    // archive unmounted: every read has to see the edits.
+    const std::string assetArchivePath = "assets.mona";
+    std::error_code archiveEc;
+    if (std::filesystem::exists(assetArchivePath, archiveEc))
+    {
+        if (kHotReload)
+            std::cout << "Hot reload: not mounting '" << assetArchivePath << "', reading loose files\n";
+        else
+            MountAssetArchive(assetArchivePath);
+    }
+
+    // Cooked bundle (mon_cook) when present: mapped once, textures come
+    // straight from its pre-decoded pixels.
+    std::string currentMapPath = "assets/maps/StarterZone.tmx";
     LoadedMap loadedMap;
-    if (!LoadTmxMap("assets/maps/StarterZone.tmx", loadedMap))
+    MapBundle mapBundle;
+    if (!LoadMapPreferBundle(currentMapPath, loadedMap, mapBundle))
     {
         glfwTerminate();
         return -1;
     }
 
+    // Infinite (chunked) maps: chunks are decoded around the player on a
+    // worker thread and turned into per-chunk TileMaps a few per frame.
+    constexpr int kChunkLoadRadius = 3;          // chunks kept decoded around the player
+    constexpr int kChunkPrimeRadius = 1;         // decoded synchronously at map load
+    constexpr int kChunkActivationsPerFrame = 2; // chunk mesh builds per frame
+
+    ChunkStreamer chunkStreamer;
+    chunkStreamer.Start(loadedMap.mapData, kChunkLoadRadius);
+
+    // Per-cell layers (gids, collision): zero-copy views into the bundle
+    // mapping, or into loadedMap's vectors on the TMX path; infinite maps
+    // answer cell queries from the streamer's resident chunks.
+    auto MakeMapView = [&]()
+        {
+            if (loadedMap.mapData.infinite)
+                return MapView(loadedMap.mapData, chunkStreamer);
+            return mapBundle.IsOpen() ? MapView(mapBundle) : MapView(loadedMap.mapData);
+        };
+
+    MapView mapView = MakeMapView();
+
     int tileW = loadedMap.mapData.tileW;
     int tileH = loadedMap.mapData.tileH;
     int mapW = loadedMap.mapData.width;
@@ -341,91 +404,51 @@ int main()
     Load tilesets + build resolver
     ============================================
     */
-    std::vector<Texture2D> tilesetTextures;          // sheet-based textures (optional debug)
+    // Textures and tilesets outlive the map: a door into a map that shares
+    // tilesets only uploads what is new, and textures no map uses any more
+    // are deleted after a grace period (Collect() in the main loop).
+    mon::RenderingConfig renderingConfig;
+    TextureRegistry textureRegistry;
+    textureRegistry.GetResidency().SetBudgetBytes((size_t)renderingConfig.textureBudgetMiB * 1024u * 1024u);
+    textureRegistry.SetReloadSource(&mapBundle); // evicted textures come back from cooked pixels when it's open
+    TilesetRegistry tilesetRegistry(textureRegistry, renderingConfig.useTextureAtlas, renderingConfig.textureScale);
+
     std::vector<TilesetRuntime> tilesetRuntimes;     // runtime tileset defs + texture ids
 
-    auto LoadTilesetsForMap = [&](const LoadedMap& mapData) -> bool
+    auto LogTextureStats = [&]()
         {
-            tilesetTextures.clear();
-            tilesetRuntimes.clear();
-
-            tilesetTextures.reserve(mapData.mapData.tilesets.size());
-            tilesetRuntimes.reserve(mapData.mapData.tilesets.size());
-
-            std::unordered_map<std::string, Texture2D> textureCache;
-
-            auto LoadCachedTexture = [&](const std::string& path, bool flipY) -> Texture2D
-                {
-                    const std::string cacheKey = path + (flipY ? "|flip" : "|noflip");
-                    auto it = textureCache.find(cacheKey);
-                    if (it != textureCache.end())
-                        return it->second;
-
-                    Texture2D texture = LoadTextureRGBA(path.c_str(), flipY);
-                    if (texture.id)
-                        textureCache.emplace(cacheKey, texture);
-
-                    return texture;
-                };
-
-            // Important: your renderer/shader UVs expect "normal" orientation.
-            const bool tilesetFlipY = false;
-
-            for (const TilesetDef& tilesetDef : mapData.mapData.tilesets)
-            {
-                if (tilesetDef.isImageCollection)
-                {
-                    // Image collection: each tileId is its own texture.
-                    TileSet tileset(0, 0, tilesetDef.tileW, tilesetDef.tileH);
-                    tileset.SetAnimations(tilesetDef.animations);
-
-                    TilesetRuntime runtime{ tilesetDef, tileset, 0 };
-
-                    for (const auto& entry : tilesetDef.tileImages)
-                    {
-                        const int tileId = entry.first;
-                        const std::string& imagePath = entry.second.path;
-
-                        Texture2D texture = LoadCachedTexture(imagePath, tilesetFlipY);
-                        if (!texture.id)
-                        {
-                            std::cerr << "Failed to load tileset tile image: " << imagePath << "\n";
-                            return false;
-                        }
-
-                        runtime.tileTextures.emplace(tileId, texture.id);
-                    }
-
-                    tilesetRuntimes.push_back(std::move(runtime));
-                }
-                else
-                {
-                    // Sheet-based tileset: one atlas texture.
-                    Texture2D texture = LoadCachedTexture(tilesetDef.imagePath, tilesetFlipY);
-                    if (!texture.id)
-                    {
-                        std::cerr << "Failed to load tileset image: " << tilesetDef.imagePath << "\n";
-                        return false;
-                    }
-
-                    tilesetTextures.push_back(texture);
-
-                    TileSet tileset(texture.width, texture.height, tilesetDef.tileW, tilesetDef.tileH);
-                    tileset.SetAnimations(tilesetDef.animations);
-
-                    TilesetRuntime runtime{ tilesetDef, tileset, texture.id };
-                    tilesetRuntimes.push_back(std::move(runtime));
-                }
-            }
-
-            return true;
+            const TextureRegistryStats textures = textureRegistry.GetStats();
+            const TilesetRegistryStats tilesets = tilesetRegistry.GetStats();
+            std::cout << "Textures: " << textures.residentTextures << " + " << textures.atlasImages
+                << " atlas images in " << textures.atlasPages << " page(s), "
+                << textures.residentBytes / 1024 << " KiB resident, "
+                << textures.hits << " hits / " << textures.misses << " misses, "
+                << textures.uploadedBytes / 1024 << " KiB uploaded, "
+                << textures.unreferenced << " unreferenced, " << textures.pendingUploads << " streaming, "
+                << textures.dedupedImages << " identical image(s) shared (" << textures.dedupedBytes / 1024
+                << " KiB not uploaded), "
+                << textures.evictedTextures << " evicted (" << textures.evictions << " evictions / "
+                << textures.reloads << " reloads, budget " << textures.budgetBytes / (1024 * 1024) << " MiB); tilesets: "
+                << tilesets.live << " live, " << tilesets.hits << " reused / " << tilesets.misses << " built, "
+                << tilesets.deferredTiles << " unreferenced tile(s) not loaded (" << tilesets.deferredBytes / 1024
+                << " KiB), " << tilesets.lateLoads << " loaded late\n";
+
+            const AssetFileStats files = GetAssetFileStats();
+            std::cout << "Asset reads: " << files.archiveReads << " from the archive ("
+                << files.archiveEntries << " files), " << files.looseReads << " loose\n";
         };
 
-    if (!LoadTilesetsForMap(loadedMap))
+    // Only the image-collection tiles the map draws are loaded up front;
+    // the resolver asks for the rest on first use.
+    std::vector<uint8_t> referencedGids;
+    CollectReferencedGids(loadedMap.mapData, &mapBundle, referencedGids);
+
+    if (!tilesetRegistry.Acquire(loadedMap.mapData.tilesets, &mapBundle, &referencedGids, tilesetRuntimes))
     {
         glfwTerminate();
         return -1;
     }
+    LogTextureStats();
 
     TileResolver tileResolver(tilesetRuntimes);
 
@@ -434,7 +457,7 @@ int main()
     Load player sprite sheet texture
     ============================================
     */
-    Texture2D playerSheetTex = LoadTextureRGBA("assets/Playersprite/player_sheet.png", false);
+    Texture2D playerSheetTex = textureRegistry.Acquire("assets/Playersprite/player_sheet.png", false);
     if (!playerSheetTex.id)
     {
         std::cerr << "Failed to load assets/Playersprite/player_sheet.png\n";
@@ -460,6 +483,13 @@ int main()
     glfwGetFramebufferSize(window, &fbW, &fbH);
 
     SpriteRenderer renderer(shaderProgram, fbW, fbH);
+    renderer.SetTextureResidency(&textureRegistry.GetResidency());
+
+    GLuint instancedShaderProgram = CreateProgram(instancedVertexShaderSrc, instancedFragmentShaderSrc);
+    if (instancedShaderProgram)
+        renderer.SetInstancedShader(instancedShaderProgram);
+    if (!renderingConfig.spriteBatching)
+        renderer.SetMode(SpriteRenderMode::Immediate);
     Camera2D camera({ 0.0f, 0.0f });
 
     /*
@@ -474,12 +504,14 @@ int main()
 
     PlayerController playerController(player);
 
-    /*
-    ============================================
-    Collision grid
-    ============================================
-    */
-    std::vector<int> collisionGrid(loadedMap.mapData.collision.begin(), loadedMap.mapData.collision.end());
+    // Infinite maps have no extent to clamp to.
+    auto ClampToMap = [&](glm::vec2& grid)
+        {
+            if (mapW <= 0 || mapH <= 0)
+                return;
+            grid.x = std::clamp(grid.x, 0.0f, (float)(mapW - 1));
+            grid.y = std::clamp(grid.y, 0.0f, (float)(mapH - 1));
+        };
 
     auto SpawnPlayerFromMap = [&](const LoadedMap& mapData, const std::string& spawnName) -> bool
         {
@@ -494,8 +526,7 @@ int main()
                         // use ObjectPixelsToGrid(...) instead (you already have that in TmxLoader).
                         glm::vec2 spawnGrid = SpawnPixelToGrid_Ortho(spawn.posPx, tileW, tileH);
 
-                        spawnGrid.x = std::clamp(spawnGrid.x, 0.0f, (float)(mapW - 1));
-                        spawnGrid.y = std::clamp(spawnGrid.y, 0.0f, (float)(mapH - 1));
+                        ClampToMap(spawnGrid);
                         player.SetGridPos(spawnGrid);
 
                         std::cout << "Player spawn from named spawn '" << spawn.name
@@ -522,8 +553,7 @@ int main()
                     // This uses your iso-aware helper from TmxLoader.cpp
                     glm::vec2 spawnGrid = ObjectPixelsToGrid(object.positionPx, tileW, tileH);
 
-                    spawnGrid.x = std::clamp(spawnGrid.x, 0.0f, (float)(mapW - 1));
-                    spawnGrid.y = std::clamp(spawnGrid.y, 0.0f, (float)(mapH - 1));
+                    ClampToMap(spawnGrid);
                     player.SetGridPos(spawnGrid);
 
                     std::cout << "Player spawn from object id=" << object.id
@@ -537,23 +567,38 @@ int main()
 
     SpawnPlayerFromMap(loadedMap, "");
 
-    auto IsBlockedAt = [&](int tx, int ty) -> bool
+    auto PlayerCell = [&]()
         {
-            if (tx < 0 || tx >= mapW || ty < 0 || ty >= mapH) return true;
-            return collisionGrid[ty * mapW + tx] != 0;
+            return glm::ivec2((int)std::floor(player.GetGridPos().x), (int)std::floor(player.GetGridPos().y));
         };
 
+    // Chunks under the spawn are decoded before the first frame (meshes are built below).
+    std::vector<uint64_t> activatedChunks;
+    std::vector<uint64_t> evictedChunks;
+    chunkStreamer.Prime(PlayerCell(), kChunkPrimeRadius, activatedChunks);
+
     {
         int spX = (int)std::floor(player.GetGridPos().x);
         int spY = (int)std::floor(player.GetGridPos().y);
-        std::cout << "Spawn tile = (" << spX << "," << spY << ") collision=" << (IsBlockedAt(spX, spY) ? 1 : 0) << "\n";
+        std::cout << "Spawn tile = (" << spX << "," << spY << ") collision=" << (mapView.IsBlocked(spX, spY) ? 1 : 0) << "\n";
     }
 
     auto FindFirstWalkable = [&]() -> glm::vec2
         {
+            if (!mapView.IsBounded())
+            {
+                // Search the primed chunks around the player.
+                const glm::ivec2 cell = PlayerCell();
+                const int reach = (kChunkPrimeRadius + 1) * std::max(loadedMap.mapData.chunkW, loadedMap.mapData.chunkH);
+                for (int y = cell.y - reach; y <= cell.y + reach; ++y)
+                    for (int x = cell.x - reach; x <= cell.x + reach; ++x)
+                        if (!mapView.IsBlocked(x, y))
+                            return glm::vec2((float)x + 0.5f, (float)y + 0.5f);
+            }
+
             for (int y = 0; y < mapH; ++y)
                 for (int x = 0; x < mapW; ++x)
-                    if (collisionGrid[y * mapW + x] == 0)
+                    if (!mapView.IsBlocked(x, y))
                         return glm::vec2((float)x + 0.5f, (float)y + 0.5f);
 
             return glm::vec2(1.0f, 1.0f);
@@ -564,7 +609,7 @@ int main()
         int sx = (int)std::floor(start.x);
         int sy = (int)std::floor(start.y);
 
-        if (sx < 0 || sx >= mapW || sy < 0 || sy >= mapH || collisionGrid[sy * mapW + sx] != 0)
+        if (mapView.IsBlocked(sx, sy))
         {
             glm::vec2 newPos = FindFirstWalkable();
             std::cout << "Spawn blocked, moving player to walkable tile at " << newPos.x << "," << newPos.y << "\n";
@@ -574,61 +619,449 @@ int main()
 
     /*
     ============================================
-    Create TileMaps (layers)
+    Create the TileMap
+    Every TMX tile layer in one TileMap; each layer's pass (TMX "pass"
+    property) sends it to the ground meshes, the occluder queue or the
+    overhead meshes.
     ============================================
     */
-    auto MakeTileLayer = [&](const std::vector<uint32_t>& tiles)
+    auto AddMapLayers = [&](TileMap& map, auto GetLayerGids)
         {
-            if ((int)tiles.size() == mapW * mapH) return tiles;
-            return std::vector<uint32_t>(mapW * mapH, 0);
+            const std::vector<MapLayerDef>& layers = loadedMap.mapData.layers;
+            for (size_t i = 0; i < layers.size(); ++i)
+                map.AddLayer(layers[i].name, GetLayerGids(i), layers[i].pass, layers[i].visible);
         };
 
-    TileMap groundMap(mapW, mapH, tileW, tileH);
-    TileMap wallsMap(mapW, mapH, tileW, tileH);
-    TileMap overheadMap(mapW, mapH, tileW, tileH);
+    TileMap tileMap(mapW, mapH, tileW, tileH);
+    AddMapLayers(tileMap, [&](size_t layer) { return mapView.GetLayerGids(layer); });
 
-    groundMap.AddLayer("Ground", MakeTileLayer(loadedMap.mapData.groundGids), true, true);
-    wallsMap.AddLayer("Walls", MakeTileLayer(loadedMap.mapData.wallsGids), true, true);
-    overheadMap.AddLayer("Overhead", MakeTileLayer(loadedMap.mapData.overheadGids), true, true);
+    // Ground / overhead never move: bake them into cached chunk meshes
+    tileMap.BuildChunkMeshes(renderer, tileResolver);
 
     /*
     ============================================
-    Map changing
+    Streamed chunks (infinite maps)
+    One TileMap per resident chunk, offset to the chunk's cells and reading
+    the streamer's decoded arrays. Built when ChunkStreamer activates a
+    chunk, dropped when it evicts it.
+    Kept in iso order (chunkX + chunkY, then chunkX) and drawn in that
+    order, so tiles overlapping into a neighbour chunk stack like the cells.
     ============================================
     */
-    auto ChangeMap = [&](const std::string& path, const std::string& spawnName) -> bool
+    struct StreamedChunk
+    {
+        uint64_t key = 0;
+        int chunkX = 0;
+        int chunkY = 0;
+        TileMap map;
+    };
+
+    std::vector<StreamedChunk> streamedChunks;
+
+    auto FindStreamedChunk = [&](uint64_t key)
+        {
+            return std::find_if(streamedChunks.begin(), streamedChunks.end(),
+                [key](const StreamedChunk& chunk) { return chunk.key == key; });
+        };
+
+    // Layer by layer across every resident chunk (all share the map's layer
+    // list): the layer's meshes, then its loose tiles, so a tile reaching
+    // into a chunk later in iso order isn't covered by that chunk's meshes.
+    auto DrawStreamedPass = [&](LayerPass pass, const glm::ivec2& viewportSizePx)
+        {
+            if (streamedChunks.empty())
+                return;
+
+            const TileMap& layout = streamedChunks.front().map;
+            for (size_t layer = 0; layer < layout.GetLayerCount(); ++layer)
+            {
+                if (layout.GetLayer(layer).pass != pass)
+                    continue;
+
+                for (const StreamedChunk& chunk : streamedChunks)
+                    chunk.map.DrawLayerMeshes(layer, renderer, camera, viewportSizePx);
+                for (const StreamedChunk& chunk : streamedChunks)
+                    chunk.map.DrawLayerLooseTiles(layer, renderer, tileResolver, camera, viewportSizePx);
+            }
+        };
+
+    auto ActivateStreamedChunks = [&](const std::vector<uint64_t>& keys)
+        {
+            for (uint64_t key : keys)
+            {
+                const MapChunkCells* cells = chunkStreamer.GetChunk(key);
+                if (!cells)
+                    continue;
+
+                TileMap map(cells->width, cells->height, tileW, tileH);
+                map.SetCellOffset(glm::ivec2(cells->originX, cells->originY));
+                AddMapLayers(map, [&](size_t layer) { return cells->GetLayerGids(layer); });
+                map.BuildChunkMeshes(renderer, tileResolver);
+
+                auto existing = FindStreamedChunk(key);
+                if (existing != streamedChunks.end())
+                {
+                    existing->map = std::move(map);
+                    continue;
+                }
+
+                const int isoRow = cells->chunkX + cells->chunkY;
+                auto at = std::lower_bound(streamedChunks.begin(), streamedChunks.end(), std::make_pair(isoRow, cells->chunkX),
+                    [](const StreamedChunk& chunk, const std::pair<int, int>& order)
+                    {
+                        return std::make_pair(chunk.chunkX + chunk.chunkY, chunk.chunkX) < order;
+                    });
+                streamedChunks.insert(at, StreamedChunk{ key, cells->chunkX, cells->chunkY, std::move(map) });
+            }
+        };
+
+    ActivateStreamedChunks(activatedChunks);
+
+    /*
+    ============================================
+    Static occluders (walls + TMX tile objects)
+    Built and depth-sorted once per map load (and on resize, since the map
+    origin follows the viewport width). Each frame only the dynamic
+    partition (player) is sorted and merged in.
+    ============================================
+    */
+    struct AnimatedObject
+    {
+        uint32_t queueIndex = 0;
+        size_t instanceIndex = 0;
+        int animSlot = -1;
+    };
+
+    RenderQueue occluderQueue;
+    std::vector<AnimatedObject> animatedObjects;
+    int occluderViewportW = -1;
+
+    // Tile objects from TMX (image collection trees, etc.)
+    // Convert TMX object pixels -> grid -> iso, exactly like tiles.
+    auto MakeObjectCmd = [&](const MapObjectInstance& instance, const glm::vec2& mapOrigin, RenderCmd& outCmd) -> bool
         {
-            LoadedMap newMap;
-            if (!LoadTmxMap(path, newMap))
+            ResolvedTile resolved{};
+            if (!tileResolver.Resolve(instance.tileIndex, resolved))
                 return false;
 
-            if (!LoadTilesetsForMap(newMap))
+            glm::vec2 drawSize = instance.size;
+            if (drawSize.x <= 0.0f || drawSize.y <= 0.0f)
+                drawSize = resolved.sizePx;
+            if (drawSize.x <= 0.0f || drawSize.y <= 0.0f)
                 return false;
 
+            glm::vec2 grid = TiledShiftedIsoPixelsToGrid_BottomCenter(
+                instance.worldPos,
+                loadedMap.mapData.height,
+                tileW,
+                tileH);
+
+            glm::vec2 gridSnapped(std::round(grid.x), std::round(grid.y));
+
+            glm::vec2 tileTopLeftWorld = GridToWorld_TileTopLeft(
+                gridSnapped,
+                loadedMap.mapData.height,
+                tileW,
+                tileH,
+                mapOrigin);
+
+            glm::vec2 bottomCenterWorld = tileTopLeftWorld + glm::vec2(tileW * 0.5f, (float)tileH);
+
+            // Debug (keep this): inspect TMX object pixels -> grid -> world conversion.
+            static int printed = 0;
+            if (printed < 12)
+            {
+                const float halfWObj = tileW * 0.5f;
+                std::cout
+                    << "OBJ gid=" << instance.tileIndex
+                    << " tmxPx=(" << instance.worldPos.x << "," << instance.worldPos.y << ")"
+                    << " grid=(" << grid.x << "," << grid.y << ")"
+                    << " snapped=(" << gridSnapped.x << "," << gridSnapped.y << ")\n"
+                    << "  mapOrigin=(" << mapOrigin.x << "," << mapOrigin.y << ")"
+                    << " unshiftX=(" << (instance.worldPos.x - (loadedMap.mapData.height - 1) * halfWObj) << ")"
+                    << " tileTopLeftWorld=(" << tileTopLeftWorld.x << "," << tileTopLeftWorld.y << ")"
+                    << " bottomCenterWorld=(" << bottomCenterWorld.x << "," << bottomCenterWorld.y << ")"
+                    << " size=(" << drawSize.x << "," << drawSize.y << ")\n";
+                printed++;
+            }
+
+            RenderCmd& cmd = outCmd;
+            cmd.texture = resolved.textureId;
+            cmd.sizePx = drawSize;
+            cmd.uvMin = resolved.uvMin;
+            cmd.uvMax = resolved.uvMax;
+
+            // bottom-center → top-left
+            cmd.posPx = bottomCenterWorld - glm::vec2(drawSize.x * 0.5f, drawSize.y);
+
+            // Cooked frames only cover their opaque part; the pivot above stays
+            ApplyTileTrim(resolved, cmd.posPx, cmd.sizePx);
+
+            // Depth from feet
+            cmd.depthKey = DepthFromFeetWorldY(bottomCenterWorld.y);
+
+            return true;
+        };
+
+    auto BuildStaticOccluders = [&](const glm::ivec2& viewportSizePx)
+        {
+            occluderQueue.ClearStatic();
+            animatedObjects.clear();
+
+            tileMap.AppendStaticOccluders(occluderQueue, tileResolver, viewportSizePx);
+            for (StreamedChunk& chunk : streamedChunks)
+                chunk.map.AppendStaticOccluders(occluderQueue, tileResolver, viewportSizePx);
+
+            const glm::vec2 mapOrigin = ComputeMapOrigin(viewportSizePx.x);
+            const std::vector<MapObjectInstance>& instances = loadedMap.mapData.objectInstances;
+            for (size_t i = 0; i < instances.size(); ++i)
+            {
+                RenderCmd cmd{};
+                if (!MakeObjectCmd(instances[i], mapOrigin, cmd))
+                    continue;
+
+                const uint32_t queueIndex = occluderQueue.PushStatic(cmd);
+
+                const int animSlot = tileResolver.GetAnimationSlot(instances[i].tileIndex);
+                if (animSlot >= 0)
+                    animatedObjects.push_back({ queueIndex, i, animSlot });
+            }
+
+            occluderQueue.SortStatic();
+            occluderViewportW = viewportSizePx.x;
+        };
+
+    auto UpdateAnimatedObjects = [&](const glm::vec2& mapOrigin)
+        {
+            const TileAnimationClock& clock = tileResolver.GetAnimationClock();
+            for (const AnimatedObject& object : animatedObjects)
+            {
+                if (!clock.FrameChanged(object.animSlot))
+                    continue;
+
+                RenderCmd cmd{};
+                if (MakeObjectCmd(loadedMap.mapData.objectInstances[object.instanceIndex], mapOrigin, cmd))
+                    occluderQueue.UpdateStatic(object.queueIndex, cmd);
+            }
+        };
+
+    BuildStaticOccluders({ fbW, fbH });
+
+    /*
+    ============================================
+    Map changing
+    ============================================
+    */
+    // Door targets of the current map are parsed and decoded on a worker
+    // thread, so pressing E only swaps the map in and uploads textures.
+    constexpr size_t kPreloadBudgetBytes = 128u * 1024u * 1024u;
+    constexpr float kDoorPreloadRangeTiles = 4.0f;
+
+    MapPreloader mapPreloader(kPreloadBudgetBytes, renderingConfig.textureScale);
+
+    auto PreloadDoorTargets = [&]()
+        {
+            std::vector<std::string> targets;
+            for (const DoorDef& door : loadedMap.mapData.doors)
+            {
+                if (door.targetMap != currentMapPath
+                    && std::find(targets.begin(), targets.end(), door.targetMap) == targets.end())
+                    targets.push_back(door.targetMap);
+            }
+
+            mapPreloader.Retain(targets);
+            if (targets.empty())
+                return;
+
+            const std::unordered_set<std::string> residentImages = textureRegistry.GetResidentPaths();
+            for (const std::string& target : targets)
+                mapPreloader.Request(target, false, residentImages);
+        };
+
+    PreloadDoorTargets();
+
+    /*
+    ============================================
+    Hot reload (debug builds)
+    The directories of the current map, its TSX files and every resident
+    image are watched. A saved TMX / TSX is re-parsed and diffed against
+    the live map (MapDiff), so only the chunks holding edited cells are
+    rebuilt; a saved image is re-uploaded into the textures holding it.
+    ============================================
+    */
+    FileWatcher fileWatcher;
+    if (kHotReload && fileWatcher.Start())
+        std::cout << "Hot reload: watching the current map's files\n";
+
+    auto WatchMapFiles = [&]()
+        {
+            if (!fileWatcher.IsActive())
+                return;
+
+            fileWatcher.WatchDirectoryOf(currentMapPath);
+            for (const TilesetDef& def : loadedMap.mapData.tilesets)
+                fileWatcher.WatchDirectoryOf(def.sourcePath);
+            for (const std::string& image : textureRegistry.GetResidentPaths())
+                fileWatcher.WatchDirectoryOf(image);
+        };
+
+    WatchMapFiles();
+
+    bool lastChangePreloaded = false;
+    double transitionStartTime = -1.0; // glfwGetTime() of the E press, until the new map's first frame
+    std::string transitionTarget;
+
+    // Swap staged in as the current map: tilesets, streamer, view and TileMap.
+    auto InstallMap = [&](StagedMap& staged, const std::string& path) -> bool
+        {
+            LoadedMap& newMap = staged.map;
+
+            std::vector<TilesetRuntime> newRuntimes;
+            if (!tilesetRegistry.Acquire(newMap.mapData.tilesets, staged.GetImages(), &staged.referencedGids, newRuntimes))
+                return false;
+
+            // Released after the acquire, so tilesets both maps use stay live.
+            tilesetRegistry.Release(tilesetRuntimes);
+            tilesetRuntimes = std::move(newRuntimes);
+            tileResolver.Rebuild();
+
+            // The streamer's worker reads the old map's chunks: stop it before replacing them.
+            chunkStreamer.Stop();
+            streamedChunks.clear();
+
             loadedMap = std::move(newMap);
+            mapBundle = std::move(staged.bundle);
+            currentMapPath = path;
+            chunkStreamer.Start(loadedMap.mapData, kChunkLoadRadius);
+            mapView = MakeMapView();
 
             tileW = loadedMap.mapData.tileW;
             tileH = loadedMap.mapData.tileH;
             mapW = loadedMap.mapData.width;
             mapH = loadedMap.mapData.height;
 
-            collisionGrid.assign(loadedMap.mapData.collision.begin(), loadedMap.mapData.collision.end());
+            tileMap = TileMap(mapW, mapH, tileW, tileH);
+            AddMapLayers(tileMap, [&](size_t layer) { return mapView.GetLayerGids(layer); });
+            tileMap.BuildChunkMeshes(renderer, tileResolver);
+            return true;
+        };
 
-            groundMap = TileMap(mapW, mapH, tileW, tileH);
-            wallsMap = TileMap(mapW, mapH, tileW, tileH);
-            overheadMap = TileMap(mapW, mapH, tileW, tileH);
+    auto ChangeMap = [&](const std::string& path, const std::string& spawnName) -> bool
+        {
+            StagedMap staged;
+            lastChangePreloaded = mapPreloader.Take(path, staged);
+            if (!lastChangePreloaded)
+            {
+                if (!LoadMapPreferBundle(path, staged.map, staged.bundle))
+                    return false;
+                CollectReferencedGids(staged.map.mapData, &staged.bundle, staged.referencedGids);
+            }
 
-            groundMap.AddLayer("Ground", MakeTileLayer(loadedMap.mapData.groundGids), true, true);
-            wallsMap.AddLayer("Walls", MakeTileLayer(loadedMap.mapData.wallsGids), true, true);
-            overheadMap.AddLayer("Overhead", MakeTileLayer(loadedMap.mapData.overheadGids), true, true);
+            if (!InstallMap(staged, path))
+                return false;
 
             if (!SpawnPlayerFromMap(loadedMap, spawnName))
                 player.SetGridPos({ 5.0f, 5.0f });
 
+            chunkStreamer.Prime(PlayerCell(), kChunkPrimeRadius, activatedChunks);
+            ActivateStreamedChunks(activatedChunks);
+            BuildStaticOccluders({ fbW, fbH });
+
             camera.SetPosition({ 0.0f, 0.0f });
+            LogTextureStats();
+            PreloadDoorTargets();
+            WatchMapFiles();
+            return true;
+        };
+
+    // Tilesets again from the files (not the bundle's cooked pixels): after
+    // an edit, textures whose images didn't change are reused.
+    auto ReacquireTilesets = [&](const MapData& mapData)
+        {
+            std::vector<uint8_t> gids;
+            CollectReferencedGids(mapData, nullptr, gids);
+
+            std::vector<TilesetRuntime> newRuntimes;
+            if (!tilesetRegistry.Acquire(mapData.tilesets, nullptr, &gids, newRuntimes))
+                return false;
+
+            tilesetRegistry.Release(tilesetRuntimes);
+            tilesetRuntimes = std::move(newRuntimes);
+            tileResolver.Rebuild();
             return true;
         };
 
+    // The current map's TMX (or one of its TSX files) was saved.
+    auto HotReloadMap = [&]()
+        {
+            const double start = glfwGetTime();
+
+            LoadedMap edited;
+            if (!LoadTmxMap(currentMapPath, edited))
+                return; // half-written or broken: the next save tries again
+
+            // A cooked map's arrays are read-only: the first edit switches to the TMX's.
+            MapDiff diff;
+            if (mapBundle.IsOpen())
+                diff.layoutChanged = true;
+            else
+                DiffMaps(loadedMap.mapData, edited.mapData, diff);
+
+            if (diff.IsEmpty())
+                return;
+
+            if (diff.layoutChanged)
+            {
+                StagedMap staged;
+                staged.map = std::move(edited);
+                CollectReferencedGids(staged.map.mapData, nullptr, staged.referencedGids);
+                if (!InstallMap(staged, currentMapPath))
+                    return;
+
+                chunkStreamer.Prime(PlayerCell(), kChunkPrimeRadius, activatedChunks);
+                ActivateStreamedChunks(activatedChunks);
+                BuildStaticOccluders({ fbW, fbH });
+                PreloadDoorTargets();
+                WatchMapFiles();
+
+                std::cout << "Hot reload " << currentMapPath << ": full reload, "
+                    << (glfwGetTime() - start) * 1000.0 << " ms\n";
+                return;
+            }
+
+            // Defs come from the edit
+            if (diff.tilesetsChanged && !ReacquireTilesets(edited.mapData))
+                return;
+
+            ApplyMapDiff(loadedMap.mapData, edited.mapData, diff);
+
+            // Copies the edited cells into the TileMap's chunks (and rebuilds their meshes).
+            const size_t chunks = tileMap.RebuildChunkMeshes(renderer, tileResolver, loadedMap.mapData, diff.layerCells);
+            if (diff.tilesetsChanged)
+            {
+                // Any tile may resolve differently now.
+                tileMap.BuildChunkMeshes(renderer, tileResolver);
+                WatchMapFiles();
+            }
+
+            const size_t cellCount = loadedMap.mapData.GetCellCount();
+            const bool occludersChanged = std::any_of(diff.layerCells.begin(), diff.layerCells.end(),
+                [&](uint32_t cell) { return loadedMap.mapData.layers[cell / cellCount].pass == LayerPass::Occluder; });
+
+            if (diff.tilesetsChanged || diff.objectsChanged || occludersChanged)
+                BuildStaticOccluders({ fbW, fbH });
+            if (diff.objectsChanged)
+                PreloadDoorTargets();
+
+            std::cout << "Hot reload " << currentMapPath << ": " << diff.layerCells.size() << " layer cell(s), ";
+            if (diff.tilesetsChanged)
+                std::cout << "tilesets changed (all chunks rebuilt)";
+            else
+                std::cout << chunks << " chunk mesh(es) rebuilt";
+            std::cout << (diff.collisionChanged ? ", collision" : "") << (diff.objectsChanged ? ", objects" : "")
+                << ", " << (glfwGetTime() - start) * 1000.0 << " ms\n";
+        };
+
     /*
     ============================================
     Main loop
@@ -648,16 +1081,121 @@ int main()
         static float animationTimeMs = 0.0f;
         animationTimeMs += deltaTime * 1000.0f;
 
+        // Advance every tile animation once; draws read the current frame table
+        tileResolver.AdvanceAnimations(animationTimeMs);
+
+        // Collection tiles the map doesn't reference but something resolved
+        // anyway (last frame): load them, then re-resolve everything cached.
+        if (tileResolver.HasDeferredGids())
+        {
+            static std::vector<uint32_t> deferredGids;
+            tileResolver.TakeDeferredGids(deferredGids);
+
+            const size_t loaded = tilesetRegistry.LoadDeferred(tilesetRuntimes, deferredGids, &mapBundle);
+            tileResolver.Rebuild();
+
+            tileMap.BuildChunkMeshes(renderer, tileResolver);
+            for (StreamedChunk& chunk : streamedChunks)
+                chunk.map.BuildChunkMeshes(renderer, tileResolver);
+            BuildStaticOccluders({ fbW, fbH });
+
+            std::cout << "Loaded " << loaded << " of " << deferredGids.size() << " unreferenced tile(s) on first use\n";
+        }
+
+        // Saved edits to the map, its tilesets or a resident image (debug builds)
+        static std::vector<std::string> changedFiles;
+        if (fileWatcher.Poll(changedFiles))
+        {
+            const std::string mapKey = TextureRegistry::CanonicalPath(currentMapPath);
+            bool mapChanged = false;
+            size_t updatedTextures = 0;
+            size_t retiredTilesets = 0;
+            const double start = glfwGetTime();
+
+            for (const std::string& file : changedFiles)
+            {
+                std::string extension = std::filesystem::path(file).extension().string();
+                std::transform(extension.begin(), extension.end(), extension.begin(),
+                    [](unsigned char c) { return (char)std::tolower(c); });
+
+                // Any TSX / CSV may be one of ours: the diff finds out.
+                if (extension == ".tsx" || extension == ".csv"
+                    || (extension == ".tmx" && TextureRegistry::CanonicalPath(file) == mapKey))
+                    mapChanged = true;
+                else if (extension == ".png")
+                {
+                    // A deduplicated image can't be written in place: its tilesets get their own copy.
+                    bool split = false;
+                    updatedTextures += textureRegistry.ReloadImage(file, split);
+                    if (split)
+                        retiredTilesets += tilesetRegistry.Retire(file, tilesetRuntimes);
+                }
+            }
+
+            if (retiredTilesets > 0 && ReacquireTilesets(loadedMap.mapData))
+            {
+                tileMap.BuildChunkMeshes(renderer, tileResolver);
+                for (StreamedChunk& chunk : streamedChunks)
+                    chunk.map.BuildChunkMeshes(renderer, tileResolver);
+                BuildStaticOccluders({ fbW, fbH });
+
+                std::cout << "Hot reload: " << retiredTilesets << " tileset(s) rebuilt around edited shared image(s), "
+                    << (glfwGetTime() - start) * 1000.0 << " ms\n";
+            }
+
+            if (updatedTextures > 0)
+            {
+                std::cout << "Hot reload: " << updatedTextures << " texture(s) updated in place, "
+                    << (glfwGetTime() - start) * 1000.0 << " ms\n";
+            }
+            if (mapChanged)
+                HotReloadMap();
+        }
+
+        // Tileset images decode on worker threads; stream a budget's worth
+        // of rows into their placeholder textures per frame.
+        textureRegistry.PumpUploads();
+
+        // Textures left behind by earlier maps, once their grace period is over
+        if (const size_t reclaimed = textureRegistry.Collect())
+            std::cout << "Reclaimed " << reclaimed << " unused texture(s)\n";
+
+        // VRAM budget: re-stream evicted textures drawn last frame, then drop
+        // the least recently drawn ones until back under budget
+        if (const size_t evicted = textureRegistry.UpdateResidency())
+        {
+            const TextureRegistryStats textures = textureRegistry.GetStats();
+            std::cout << "Evicted " << evicted << " texture(s) over the " << textures.budgetBytes / (1024 * 1024)
+                << " MiB budget, " << textures.residentBytes / 1024 << " KiB resident\n";
+        }
+
         // framebuffer / projection updates
         glfwGetFramebufferSize(window, &fbW, &fbH);
         renderer.SetScreenSize(fbW, fbH);
 
+        // Render mode cycle (press B): immediate -> batched -> instanced,
+        // so draw counts and frame times can be compared on the same map
+        static bool wasB = false;
+        bool bDown = glfwGetKey(window, GLFW_KEY_B) == GLFW_PRESS;
+        if (bDown && !wasB)
+        {
+            SpriteRenderMode next = SpriteRenderMode::Immediate;
+            if (renderer.GetMode() == SpriteRenderMode::Immediate)
+                next = SpriteRenderMode::Batched;
+            else if (renderer.GetMode() == SpriteRenderMode::Batched)
+                next = SpriteRenderMode::Instanced;
+
+            renderer.SetMode(next);
+            std::cout << "Sprite render mode: " << RenderModeName(renderer.GetMode()) << "\n";
+        }
+        wasB = bDown;
+
         // clear
         glClearColor(0.08f, 0.08f, 0.10f, 1.0f);
         glClear(GL_COLOR_BUFFER_BIT);
 
         // input/movement
-        playerController.Update(window, deltaTime, mapW, mapH, collisionGrid);
+        playerController.Update(window, deltaTime, mapView);
 
         // Door trigger (press E inside door rect) — NOTE: this assumes door rect + feet are same space (may need iso conversion later)
         static bool wasE = false;
@@ -679,10 +1217,64 @@ int main()
             }
         }
 
+        // Near a door: its target map jumps to the front of the preload queue
+        const float preloadRangePx = kDoorPreloadRangeTiles * (float)tileW;
+        std::string nearDoorTarget;
+        for (const DoorDef& door : loadedMap.mapData.doors)
+        {
+            const glm::vec2 closest = glm::clamp(playerPixelFeet, door.posPx, door.posPx + door.sizePx);
+            if (glm::length(playerPixelFeet - closest) <= preloadRangePx)
+            {
+                nearDoorTarget = door.targetMap;
+                break;
+            }
+        }
+
+        static std::string lastNearDoorTarget;
+        if (nearDoorTarget != lastNearDoorTarget)
+        {
+            lastNearDoorTarget = nearDoorTarget;
+            if (!nearDoorTarget.empty() && nearDoorTarget != currentMapPath)
+                mapPreloader.Request(nearDoorTarget, true, textureRegistry.GetResidentPaths());
+        }
+
         if (activeDoor && ePressed)
         {
-            if (!ChangeMap(activeDoor->targetMap, activeDoor->targetSpawn))
-                std::cerr << "Failed to change map to " << activeDoor->targetMap << "\n";
+            // Copied: ChangeMap replaces the doors activeDoor points into.
+            const DoorDef door = *activeDoor;
+            const double pressTime = glfwGetTime();
+            if (ChangeMap(door.targetMap, door.targetSpawn))
+            {
+                transitionStartTime = pressTime;
+                transitionTarget = door.targetMap;
+            }
+            else
+            {
+                std::cerr << "Failed to change map to " << door.targetMap << "\n";
+            }
+        }
+
+        // Chunk streaming (infinite maps): activate decoded chunks, drop far ones
+        if (chunkStreamer.IsActive()
+            && chunkStreamer.Update(PlayerCell(), kChunkActivationsPerFrame, activatedChunks, evictedChunks))
+        {
+            // Only the chunks that came or went touch the static partition
+            for (uint64_t key : evictedChunks)
+            {
+                auto chunk = FindStreamedChunk(key);
+                if (chunk == streamedChunks.end())
+                    continue;
+                chunk->map.RemoveStaticOccluders(occluderQueue);
+                streamedChunks.erase(chunk);
+            }
+
+            ActivateStreamedChunks(activatedChunks);
+            for (uint64_t key : activatedChunks)
+            {
+                auto chunk = FindStreamedChunk(key);
+                if (chunk != streamedChunks.end())
+                    chunk->map.InsertStaticOccluders(occluderQueue, tileResolver, { fbW, fbH });
+            }
         }
 
         // Camera follow (dead-zone + smoothing)
@@ -721,96 +1313,73 @@ int main()
         Draw world
         ============================================
         */
-        groundMap.DrawGround(renderer, tileResolver, camera, { fbW, fbH }, animationTimeMs);
+        renderer.BeginFrame();
 
-        RenderQueue renderQueue;
-        renderQueue.Clear();
-        renderQueue.Reserve(2048);
+        // One visibility pass per TileMap serves the ground and overhead draws
+        tileMap.CullVisible(renderer, tileResolver, camera, { fbW, fbH });
+        for (StreamedChunk& chunk : streamedChunks)
+            chunk.map.CullVisible(renderer, tileResolver, camera, { fbW, fbH });
 
-        // Walls go into queue for depth sort
-        wallsMap.AppendOccluders(renderQueue, tileResolver, camera, { fbW, fbH }, animationTimeMs);
+        tileMap.DrawGround(renderer, tileResolver, camera, { fbW, fbH });
+        DrawStreamedPass(LayerPass::Ground, { fbW, fbH });
 
-        /*
-        ============================================
-        Tile objects from TMX (image collection trees, etc.)
-        Convert TMX object pixels -> grid -> iso, exactly like tiles.
-        ============================================
-        */
-        for (const MapObjectInstance& instance : loadedMap.mapData.objectInstances)
-        {
-            ResolvedTile resolved{};
-            if (!tileResolver.Resolve(instance.tileIndex, animationTimeMs, resolved))
-                continue;
+        // Walls / objects were sorted at map load; refresh animated frames,
+        // then only the player is sorted and merged in
+        if (fbW != occluderViewportW)
+            BuildStaticOccluders({ fbW, fbH });
 
-            glm::vec2 drawSize = instance.size;
-            if (drawSize.x <= 0.0f || drawSize.y <= 0.0f)
-                drawSize = resolved.sizePx;
-            if (drawSize.x <= 0.0f || drawSize.y <= 0.0f)
-                continue;
+        tileMap.UpdateStaticOccluders(occluderQueue, tileResolver, { fbW, fbH });
+        for (const StreamedChunk& chunk : streamedChunks)
+            chunk.map.UpdateStaticOccluders(occluderQueue, tileResolver, { fbW, fbH });
+        UpdateAnimatedObjects(mapOrigin);
 
-            glm::vec2 grid = TiledShiftedIsoPixelsToGrid_BottomCenter(
-                instance.worldPos,
-                loadedMap.mapData.height,
-                tileW,
-                tileH);
+        occluderQueue.Clear();
 
-            glm::vec2 gridSnapped(std::round(grid.x), std::round(grid.y));
+        // Player into queue (depth sort)
+        player.AppendToQueue(occluderQueue, playerTileTopLeft, tileW, tileH);
 
-            glm::vec2 tileTopLeftWorld = GridToWorld_TileTopLeft(
-                gridSnapped,
-                loadedMap.mapData.height,
-                tileW,
-                tileH,
-                mapOrigin);
+        const glm::vec2 viewMin = camera.GetPosition();
+        occluderQueue.SortByDepthStable(viewMin, viewMin + glm::vec2((float)fbW, (float)fbH));
+        renderer.DrawQueue(occluderQueue, camera);
 
-            glm::vec2 bottomCenterWorld = tileTopLeftWorld + glm::vec2(tileW * 0.5f, (float)tileH);
+        // Overhead layers
+        tileMap.DrawOverhead(renderer, tileResolver, camera, { fbW, fbH });
+        DrawStreamedPass(LayerPass::Overhead, { fbW, fbH });
 
-            // Debug (keep this): inspect TMX object pixels -> grid -> world conversion.
-            static int printed = 0;
-            if (printed < 12)
+        renderer.EndFrame();
+
+        // Per-frame renderer counters, logged about once per second
+        static double lastStatsTime = now;
+        if (now - lastStatsTime >= 1.0)
+        {
+            const SpriteRenderStats& stats = renderer.GetStats();
+            std::cout << "Render (" << RenderModeName(renderer.GetMode()) << "):"
+                << " dt=" << deltaTime * 1000.0f << "ms"
+                << " draws=" << stats.drawCalls
+                << " batches=" << stats.batches
+                << " quads=" << stats.quads << "\n";
+
+            if (chunkStreamer.IsActive())
             {
-                const float halfWObj = tileW * 0.5f;
-                std::cout
-                    << "OBJ gid=" << instance.tileIndex
-                    << " tmxPx=(" << instance.worldPos.x << "," << instance.worldPos.y << ")"
-                    << " grid=(" << grid.x << "," << grid.y << ")"
-                    << " snapped=(" << gridSnapped.x << "," << gridSnapped.y << ")\n"
-                    << "  mapOrigin=(" << mapOrigin.x << "," << mapOrigin.y << ")"
-                    << " unshiftX=(" << (instance.worldPos.x - (loadedMap.mapData.height - 1) * halfWObj) << ")"
-                    << " tileTopLeftWorld=(" << tileTopLeftWorld.x << "," << tileTopLeftWorld.y << ")"
-                    << " bottomCenterWorld=(" << bottomCenterWorld.x << "," << bottomCenterWorld.y << ")"
-                    << " size=(" << drawSize.x << "," << drawSize.y << ")\n";
-                printed++;
+                const ChunkStreamerStats chunkStats = chunkStreamer.GetStats();
+                std::cout << "Chunks: resident=" << chunkStats.resident
+                    << " pending=" << chunkStats.pending
+                    << " loaded=" << chunkStats.loadedTotal
+                    << " evicted=" << chunkStats.evictedTotal
+                    << " decode=" << chunkStats.decodeMsTotal << "ms total\n";
             }
-
-            RenderCmd cmd{};
-            cmd.texture = resolved.textureId;
-            cmd.sizePx = drawSize;
-            cmd.uvMin = resolved.uvMin;
-            cmd.uvMax = resolved.uvMax;
-
-            // bottom-center → top-left
-            cmd.posPx = bottomCenterWorld - glm::vec2(drawSize.x * 0.5f, drawSize.y);
-
-            // Depth from feet
-            cmd.depthKey = DepthFromFeetWorldY(bottomCenterWorld.y);
-
-            renderQueue.Push(cmd);
+            lastStatsTime = now;
         }
 
-
-
-        // Player into queue (depth sort)
-        player.AppendToQueue(renderQueue, playerTileTopLeft, tileW, tileH);
-
-        renderQueue.SortByDepthStable();
-        for (const RenderCmd& cmd : renderQueue.Items())
-            renderer.Draw(cmd.texture, cmd.posPx, cmd.sizePx, camera, cmd.uvMin, cmd.uvMax);
-
-        // Overhead layer
-        overheadMap.DrawOverhead(renderer, tileResolver, camera, { fbW, fbH }, animationTimeMs);
-
         glfwSwapBuffers(window);
+
+        if (transitionStartTime >= 0.0)
+        {
+            std::cout << "Map transition to " << transitionTarget << ": "
+                << (glfwGetTime() - transitionStartTime) * 1000.0 << " ms from E to first frame ("
+                << (lastChangePreloaded ? "preloaded" : "loaded on demand") << ")\n";
+            transitionStartTime = -1.0;
+        }
     }
 
     glfwTerminate();
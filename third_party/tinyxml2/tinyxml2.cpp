@@ -105,6 +105,12 @@ XMLError XMLDocument::LoadFile(const char* filename)
     return Parse(xml);
 }
 
+XMLError XMLDocument::Parse(const char* xml, size_t length)
+{
+    Reset();
+    return Parse(std::string(xml, length));
+}
+
 XMLError XMLDocument::Parse(const std::string& xml)
 {
     std::vector<Node*> stack;
@@ -24,6 +24,7 @@ public:
     XMLDocument();
 
     XMLError LoadFile(const char* filename);
+    XMLError Parse(const char* xml, size_t length);
     const char* ErrorStr() const;
 
     XMLElement* FirstChildElement(const char* name = nullptr);
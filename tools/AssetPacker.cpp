@@ -0,0 +1,107 @@
+// AssetPacker.cpp (mon_pack)
+//
+// Packs loose asset files into one read-only archive (see AssetArchive.h)
+// that the client mounts at startup when it finds assets.mona in its
+// working directory. Directories are walked recursively; only the file
+// types the client reads are packed (.png .tsx .tmx .csv .json).
+//
+// Usage: mon_pack [-o assets.mona] [dir-or-file ...]   (default: assets)
+// Run from the directory the client runs from, so the stored paths match
+// the ones it asks for.
+
+#include "AssetArchive.h"
+
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <filesystem>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace
+{
+    bool IsPackedExtension(const std::filesystem::path& path)
+    {
+        std::string extension = path.extension().string();
+        std::transform(extension.begin(), extension.end(), extension.begin(),
+            [](unsigned char c) { return (char)std::tolower(c); });
+
+        return extension == ".png" || extension == ".tsx" || extension == ".tmx"
+            || extension == ".csv" || extension == ".json";
+    }
+
+    bool CollectFiles(const std::string& input, std::vector<std::string>& outFiles)
+    {
+        std::error_code ec;
+        if (std::filesystem::is_regular_file(input, ec))
+        {
+            outFiles.push_back(input);
+            return true;
+        }
+
+        if (!std::filesystem::is_directory(input, ec))
+        {
+            std::cerr << "No such file or directory: " << input << "\n";
+            return false;
+        }
+
+        for (std::filesystem::recursive_directory_iterator it(input, ec), end; !ec && it != end; it.increment(ec))
+        {
+            if (it->is_regular_file(ec) && IsPackedExtension(it->path()))
+                outFiles.push_back(it->path().generic_string());
+        }
+
+        if (ec)
+        {
+            std::cerr << "Failed to walk '" << input << "': " << ec.message() << "\n";
+            return false;
+        }
+        return true;
+    }
+}
+
+int main(int argc, char** argv)
+{
+    std::string outputPath = "assets.mona";
+    std::vector<std::string> inputs;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        const std::string arg = argv[i];
+        if (arg == "-o" && i + 1 < argc)
+            outputPath = argv[++i];
+        else if (!arg.empty() && arg[0] == '-')
+        {
+            std::cerr << "Usage: mon_pack [-o assets.mona] [dir-or-file ...]\n";
+            return 2;
+        }
+        else
+            inputs.push_back(arg);
+    }
+
+    if (inputs.empty())
+        inputs.push_back("assets");
+
+    const auto start = std::chrono::steady_clock::now();
+
+    std::vector<std::string> files;
+    for (const std::string& input : inputs)
+    {
+        if (!CollectFiles(input, files))
+            return 1;
+    }
+
+    if (!WriteAssetArchive(outputPath, files))
+    {
+        std::cerr << "Failed to write " << outputPath << "\n";
+        return 1;
+    }
+
+    std::error_code ec;
+    const uintmax_t size = std::filesystem::file_size(outputPath, ec);
+    const double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    std::cout << "Packed " << outputPath << ": " << files.size() << " files, "
+        << (ec ? 0 : size / (1024 * 1024)) << " MiB, " << ms << " ms\n";
+    return 0;
+}
@@ -0,0 +1,250 @@
+// MapCooker.cpp (mon_cook)
+//
+// Offline cooker: loads a .tmx the same way the client does (TmxLoader),
+// decodes every image its tilesets reference and writes one .monb bundle
+// (see MapBundle.h) next to it, or to -o <path>. The bundle records the
+// write time of every file it was cooked from; the client falls back to
+// the TMX once any of them changes.
+//
+// Image-collection tiles are cooked at the resolution variant the client
+// will select for -s <scale> (RenderingConfig::textureScale, default 1).
+// When the art has no variant at the drawn size, the next larger one is
+// downscaled here and stored under the exact-size path
+// (Shadow/1024x1024/a.png drawn at 200 px -> Shadow/200x200/a.png).
+// Each of those tiles also gets its opaque rect (TileTrim.h), so the
+// client draws only the part of the quad that has visible texels.
+//
+// Usage: mon_cook [-o out.monb] [-s scale] map.tmx [more.tmx ...]
+// Run from the directory the client runs from, so asset paths match.
+
+#include "MapBundle.h"
+#include "TextureVariants.h"
+#include "TileTrim.h"
+#include "TmxLoader.h"
+
+#include "stb_image.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+namespace
+{
+    bool DecodeImage(const std::string& path, BundleImageSource& outImage)
+    {
+        // Same orientation as the client's LoadTextureRGBA(path, false).
+        stbi_set_flip_vertically_on_load(false);
+
+        int channels = 0;
+        unsigned char* pixels = stbi_load(path.c_str(), &outImage.width, &outImage.height, &channels, 4);
+        if (!pixels)
+        {
+            std::cerr << "Failed to decode '" << path << "': " << stbi_failure_reason() << "\n";
+            return false;
+        }
+
+        outImage.path = path;
+        outImage.rgba.assign(pixels, pixels + (size_t)outImage.width * outImage.height * 4);
+        stbi_image_free(pixels);
+        return true;
+    }
+
+    // Box filter in premultiplied alpha, so transparent texels don't darken edges.
+    void DownscaleImage(BundleImageSource& image, int width, int height)
+    {
+        std::vector<uint8_t> out((size_t)width * height * 4);
+
+        for (int y = 0; y < height; ++y)
+        {
+            const int y0 = (int)((int64_t)y * image.height / height);
+            const int y1 = std::max(y0 + 1, (int)((int64_t)(y + 1) * image.height / height));
+
+            for (int x = 0; x < width; ++x)
+            {
+                const int x0 = (int)((int64_t)x * image.width / width);
+                const int x1 = std::max(x0 + 1, (int)((int64_t)(x + 1) * image.width / width));
+
+                double r = 0.0, g = 0.0, b = 0.0, a = 0.0;
+                for (int sy = y0; sy < y1; ++sy)
+                {
+                    for (int sx = x0; sx < x1; ++sx)
+                    {
+                        const uint8_t* texel = &image.rgba[((size_t)sy * image.width + sx) * 4];
+                        const double alpha = texel[3] / 255.0;
+                        r += texel[0] * alpha;
+                        g += texel[1] * alpha;
+                        b += texel[2] * alpha;
+                        a += texel[3];
+                    }
+                }
+
+                const double count = (double)(x1 - x0) * (y1 - y0);
+                uint8_t* dst = &out[((size_t)y * width + x) * 4];
+                const double coverage = a / 255.0;
+                dst[0] = (uint8_t)std::lround(coverage > 0.0 ? std::min(255.0, r / coverage) : 0.0);
+                dst[1] = (uint8_t)std::lround(coverage > 0.0 ? std::min(255.0, g / coverage) : 0.0);
+                dst[2] = (uint8_t)std::lround(coverage > 0.0 ? std::min(255.0, b / coverage) : 0.0);
+                dst[3] = (uint8_t)std::lround(a / count);
+            }
+        }
+
+        image.rgba = std::move(out);
+        image.width = width;
+        image.height = height;
+    }
+
+    // What a bundle image is cooked from.
+    struct CookImage
+    {
+        std::string path;       // name in the bundle (what the client looks up)
+        std::string sourcePath; // file decoded
+        int width = 0;          // downscaled to this when smaller than the source (0 = as is)
+        int height = 0;
+    };
+
+    bool CookMap(const std::string& tmxPath, const std::string& bundlePath, float textureScale)
+    {
+        using Clock = std::chrono::steady_clock;
+        const auto start = Clock::now();
+
+        LoadedMap loadedMap;
+        if (!LoadTmxMap(tmxPath, loadedMap))
+            return false;
+
+        std::vector<CookImage> cookImages;
+        std::unordered_set<std::string> seen;
+        auto AddImage = [&](const CookImage& image)
+            {
+                if (!image.path.empty() && seen.insert(image.path).second)
+                    cookImages.push_back(image);
+            };
+
+        // Collection tiles and the bundle image each one loads, for trimming.
+        std::vector<std::pair<TileImageDef*, std::string>> tileImages;
+
+        size_t downscaled = 0;
+        for (TilesetDef& def : loadedMap.mapData.tilesets)
+        {
+            if (!def.isImageCollection)
+                AddImage({ def.imagePath, def.imagePath });
+
+            for (auto& entry : def.tileImages)
+            {
+                TileImageDef& tile = entry.second;
+
+                int width = 0, height = 0;
+                const std::string selected = SelectTextureVariant(tile.path, tile.w, tile.h, textureScale, nullptr, width, height);
+
+                std::string exactPath;
+                int exactWidth = 0, exactHeight = 0;
+                if (GetExactTextureVariant(tile.path, tile.w, tile.h, textureScale, exactPath, exactWidth, exactHeight)
+                    && exactPath != selected && exactWidth < width && exactHeight < height)
+                {
+                    AddImage({ exactPath, selected, exactWidth, exactHeight });
+                    tileImages.emplace_back(&tile, exactPath);
+                    ++downscaled;
+                    continue;
+                }
+
+                AddImage({ selected, selected });
+                tileImages.emplace_back(&tile, selected);
+            }
+        }
+
+        std::vector<BundleImageSource> images(cookImages.size());
+        size_t pixelBytes = 0;
+        for (size_t i = 0; i < cookImages.size(); ++i)
+        {
+            const CookImage& cook = cookImages[i];
+            if (!DecodeImage(cook.sourcePath, images[i]))
+                return false;
+
+            images[i].path = cook.path;
+            if (cook.width > 0 && cook.height > 0 && (cook.width < images[i].width || cook.height < images[i].height))
+                DownscaleImage(images[i], cook.width, cook.height);
+
+            pixelBytes += images[i].rgba.size();
+        }
+
+        size_t trimmed = 0;
+        for (const auto& [tile, path] : tileImages)
+        {
+            const auto image = std::find_if(images.begin(), images.end(),
+                [&](const BundleImageSource& source) { return source.path == path; });
+
+            AlphaBounds bounds;
+            if (ComputeAlphaBounds(image->rgba.data(), image->width, image->height, bounds)
+                && SetTileTrim(*tile, bounds, image->width, image->height))
+                ++trimmed;
+        }
+
+        // Everything read above, so the client can tell when the bundle is out of date.
+        std::vector<std::string> sourcePaths{ tmxPath };
+        std::unordered_set<std::string> seenSources{ tmxPath };
+        for (const TilesetDef& def : loadedMap.mapData.tilesets)
+        {
+            if (!def.sourcePath.empty() && seenSources.insert(def.sourcePath).second)
+                sourcePaths.push_back(def.sourcePath);
+        }
+        for (const CookImage& cook : cookImages)
+        {
+            if (seenSources.insert(cook.sourcePath).second)
+                sourcePaths.push_back(cook.sourcePath);
+        }
+
+        BundleWriteStats written;
+        if (!WriteMapBundle(bundlePath, loadedMap.mapData, images, sourcePaths, &written))
+            return false;
+
+        const double ms = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+        std::cout << "Cooked " << tmxPath << " -> " << bundlePath << "\n"
+            << "  tilesets: " << loadedMap.mapData.tilesets.size()
+            << ", images: " << images.size() << " (" << downscaled << " downscaled, "
+            << trimmed << " tiles trimmed)"
+            << ", pixels: " << (pixelBytes - written.dedupedBytes) / (1024 * 1024) << " MB"
+            << " (" << written.dedupedImages << " identical images stored once, "
+            << written.dedupedBytes / 1024 << " KB saved)"
+            << ", " << ms << " ms\n";
+        return true;
+    }
+}
+
+int main(int argc, char** argv)
+{
+    std::string outputPath;
+    float textureScale = 1.0f;
+    std::vector<std::string> inputs;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        const std::string arg = argv[i];
+        if (arg == "-o" && i + 1 < argc)
+            outputPath = argv[++i];
+        else if (arg == "-s" && i + 1 < argc)
+            textureScale = std::strtof(argv[++i], nullptr);
+        else
+            inputs.push_back(arg);
+    }
+
+    if (inputs.empty() || (!outputPath.empty() && inputs.size() > 1) || textureScale <= 0.0f)
+    {
+        std::cerr << "Usage: mon_cook [-o out.monb] [-s scale] map.tmx [more.tmx ...]\n";
+        return 2;
+    }
+
+    int failures = 0;
+    for (const std::string& input : inputs)
+    {
+        const std::string bundlePath = outputPath.empty() ? GetMapBundlePath(input) : outputPath;
+        if (!CookMap(input, bundlePath, textureScale))
+            ++failures;
+    }
+
+    return failures == 0 ? 0 : 1;
+}